@@ -24,6 +24,9 @@ public class LearningDecisionTree : ModuleRules
 			new string[]
 			{
 				"Core",
+				"CoreUObject",
+				"Engine",
+				"LearningDecisionTreeCore",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -32,10 +35,9 @@ public class LearningDecisionTree : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
-				"CoreUObject",
-				"Engine",
 				"Slate",
 				"SlateCore",
+				"Json",
 				// ... add private dependencies that you statically link with here ...
 			}
 			);
@@ -1,236 +1,1670 @@
 #include "LearningDecisionTree.h"
 #include "LearningDecisionTreeNode.h"
+#include "LearningDecisionTreeCoreAdapter.h"
 #include "Serialization/ObjectAndNameAsStringProxyArchive.h"
 #include "HAL/PlatformFileManager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "LearningDecisionTreeTableJournal.h"
+#include "LearningDecisionTreeModelAsset.h"
+#include "LearningDecisionTreeStats.h"
 #include "Serialization/MemoryWriter.h"
 #include "Serialization/MemoryReader.h"
+#include "Algo/BinarySearch.h"
+#include "Async/Async.h"
+#include "Hash/CityHash.h"
+#include <atomic>
 
 ULearningDecisionTree::ULearningDecisionTree()
 {
 }
 
+
 int32 ULearningDecisionTree::GetColumnCount() const
 {
 	return Table.TableData.Num();
 }
 
-int32 ULearningDecisionTree::GetTableRowCount() const
-{
-	return Table.GetTableRowCount();
+int32 ULearningDecisionTree::GetTableRowCount() const
+{
+	return Table.GetTableRowCount();
+}
+
+int32 ULearningDecisionTree::GetTotalRowCount() const
+{
+	return Table.GetTotalRowCount();
+}
+
+void ULearningDecisionTree::AddColumn(FName ColumnName)
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	if (Table.AddColumn(ColumnName))
+	{
+		TableChangeSerial++;
+		if (TableJournal)
+		{
+			TableJournal->AppendColumn(ColumnName);
+		}
+	}
+}
+
+void ULearningDecisionTree::AddRow(const TArray<int32>& Row)
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	if (Table.AddRow(Row))
+	{
+		TableChangeSerial++;
+		if (bTrainingSampleValid && SampledChangeSerial + 1 == TableChangeSerial)
+		{
+			TrainingSampler.AddRow(Row);
+			SampledChangeSerial = TableChangeSerial;
+		}
+		if (TableJournal)
+		{
+			TableJournal->AppendRow(Row);
+			if (JournalCompactionRows > 0 && TableJournal->GetNumRows() >= JournalCompactionRows)
+			{
+				CompactTableJournal();
+			}
+		}
+	}
+}
+
+// Creates the root TableNode holding all of TrainingTable in OutRoot[0] and queues it.
+// Returns the bytes held by its table.
+static int64 StartDecisionTree(const FLearningDecisionTreeTable& TrainingTable, UObject* Outer, TArray<ULearningDecisionTreeNode*>& OutRoot, TArray<ULearningDecisionTreeNode*>& NodesToExplode)
+{
+	// Create the initial root TableNode containing the full dataset
+	ULearningDecisionTreeTableNode* RootNode = NewObject<ULearningDecisionTreeTableNode>(Outer);
+	INC_DWORD_STAT(STAT_LearningDecisionTree_NodesCreated);
+	OutRoot.Add(RootNode);
+
+	// Init root node. It adds itself to NodesToExplode queue.
+	// We pass OutRoot as the parent list so the RootNode can eventually replace itself
+	// with the final DecisionNode or ActionNode.
+	RootNode->Init(TrainingTable, NodesToExplode, &OutRoot, 0);
+
+	return RootNode->Table.GetAllocatedSize();
+}
+
+// See FLearningDecisionTreeSubsetFingerprint. Order-sensitive on purpose: the branches and actions of the
+// subtree follow the order their states first appear in, so only the same rows in the same order give the same subtree.
+// The subtrees of a build with feature selection are mapped back to the full table, so its dropped columns count too.
+static FLearningDecisionTreeSubsetFingerprint FingerprintSubset(const FLearningDecisionTreeTable& Subset, const FLearningDecisionTreeFeatureSelection* Selection)
+{
+	FLearningDecisionTreeSubsetFingerprint Fingerprint;
+	Fingerprint.HashA = 0x9E3779B97F4A7C15ull;
+	Fingerprint.HashB = 0xC2B2AE3D27D4EB4Full;
+	auto Mix = [&Fingerprint](const void* Data, int32 NumBytes)
+	{
+		Fingerprint.HashA = CityHash64WithSeed((const char*)Data, NumBytes, Fingerprint.HashA);
+		Fingerprint.HashB = CityHash64WithSeeds((const char*)Data, NumBytes, Fingerprint.HashB, 0x165667B19E3779F9ull);
+	};
+
+	const int32 Shape[] = { Subset.ColumnNames.Num(), Subset.DuplicateCounts.Num() };
+	Mix(Shape, sizeof(Shape));
+	for (const FName& Name : Subset.ColumnNames)
+	{
+		// Names only need to be told apart within this run, which their comparison index does
+		const uint32 NameHash = GetTypeHash(Name);
+		Mix(&NameHash, sizeof(NameHash));
+		if (const TArray<int32>* Column = Subset.TableData.Find(Name))
+		{
+			Mix(Column->GetData(), Column->Num() * sizeof(int32));
+		}
+	}
+	Mix(Subset.DuplicateCounts.GetData(), Subset.DuplicateCounts.Num() * sizeof(int32));
+	if (Selection)
+	{
+		const int32 NumColumns = Selection->ColumnNames.Num();
+		Mix(&NumColumns, sizeof(NumColumns));
+		Mix(Selection->DroppedFeatures.GetData(), Selection->DroppedFeatures.Num() * sizeof(int32));
+	}
+	return Fingerprint;
+}
+
+// Explodes the node at the front of NodesToExplode, queueing its children.
+// PendingTableBytes tracks the memory held by the tables of queued nodes, PeakTableBytes its maximum.
+// With a Selection, the tables hold only its kept columns and each split is mapped back to all of its columns.
+// With a SubtreeCache, a node whose subset is in it takes the cached subtree instead (counted in SubtreesReused),
+// and the subtree of every other node is added to it.
+static void ExplodeNextNode(TArray<ULearningDecisionTreeNode*>& NodesToExplode, int64& PendingTableBytes, int64& PeakTableBytes,
+	const FLearningDecisionTreeFeatureSelection* Selection, TMap<FLearningDecisionTreeSubsetFingerprint, ULearningDecisionTreeNode*>* SubtreeCache, int32& SubtreesReused)
+{
+	ULearningDecisionTreeNode* Node = NodesToExplode[0];
+	int32 NumQueued = NodesToExplode.Num();
+	ULearningDecisionTreeTableNode* TableNode = Cast<ULearningDecisionTreeTableNode>(Node);
+	const bool bInParent = TableNode && TableNode->ParentList && TableNode->ParentList->IsValidIndex(TableNode->ThisNodeIndex);
+
+	FLearningDecisionTreeSubsetFingerprint Fingerprint;
+	ULearningDecisionTreeNode* const* Cached = nullptr;
+	if (SubtreeCache && bInParent)
+	{
+		Fingerprint = FingerprintSubset(TableNode->Table, Selection);
+		Cached = SubtreeCache->Find(Fingerprint);
+	}
+
+	if (Cached)
+	{
+		// ID3 would build the same subtree again from the same subset
+		(*TableNode->ParentList)[TableNode->ThisNodeIndex] = *Cached;
+		SubtreesReused++;
+	}
+	else if (Node)
+	{
+		// ExplodeNode will process the node (split it or make it a leaf)
+		// and potentially add new children to NodesToExplode.
+		Node->ExplodeNode(NodesToExplode);
+
+		ULearningDecisionTreeNode* Built = bInParent ? (*TableNode->ParentList)[TableNode->ThisNodeIndex] : nullptr;
+		ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Built);
+		if (Selection && DNode)
+		{
+			DNode->BestInfoGainColumn = Selection->ToOriginalColumn(DNode->BestInfoGainColumn, TableNode->Table.ColumnNames);
+		}
+
+		// The children are still queued; they complete the cached DecisionNode in place as they are exploded
+		if (SubtreeCache && Built && !Built->IsA<ULearningDecisionTreeTableNode>())
+		{
+			SubtreeCache->Add(Fingerprint, Built);
+		}
+	}
+
+	for (int32 Index = NumQueued; Index < NodesToExplode.Num(); Index++)
+	{
+		if (const ULearningDecisionTreeTableNode* Child = Cast<ULearningDecisionTreeTableNode>(NodesToExplode[Index]))
+		{
+			PendingTableBytes += Child->Table.GetAllocatedSize();
+		}
+	}
+	PeakTableBytes = FMath::Max(PeakTableBytes, PendingTableBytes);
+
+	// The exploded node has been replaced in its parent; free its table now rather than at the next GC
+	if (TableNode)
+	{
+		PendingTableBytes -= TableNode->Table.GetAllocatedSize();
+		TableNode->Table = FLearningDecisionTreeTable();
+	}
+
+	// Remove the processed node from the queue
+	NodesToExplode.RemoveAt(0);
+}
+
+// Runs ID3 on TrainingTable, leaving the finished tree in OutRoot[0].
+// Returns the most memory held at once by the tables of the nodes waiting to be exploded.
+static int64 BuildDecisionTree(const FLearningDecisionTreeTable& TrainingTable, UObject* Outer, TArray<ULearningDecisionTreeNode*>& OutRoot, TArray<ULearningDecisionTreeNode*>& NodesToExplode,
+	const FLearningDecisionTreeFeatureSelection* Selection, TMap<FLearningDecisionTreeSubsetFingerprint, ULearningDecisionTreeNode*>* SubtreeCache, int32& SubtreesReused)
+{
+	int64 PendingTableBytes = StartDecisionTree(TrainingTable, Outer, OutRoot, NodesToExplode);
+	int64 PeakTableBytes = PendingTableBytes;
+
+	// Iteratively process nodes until the queue is empty
+	// Note: NodesToExplode grows as TableNodes split into children TableNodes.
+	while (NodesToExplode.Num() > 0)
+	{
+		ExplodeNextNode(NodesToExplode, PendingTableBytes, PeakTableBytes, Selection, SubtreeCache, SubtreesReused);
+	}
+	return PeakTableBytes;
+}
+
+static void ResolveNodeFeatureIndices(ULearningDecisionTreeNode* Node, TArray<int32>& UsedFeatures);
+
+void ULearningDecisionTree::CreateDecisionTree()
+{
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_CreateDecisionTree);
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	// Clear previous tree state, keeping the subtrees it can lend the new one
+	CancelDecisionTreeBuild();
+	TMap<FLearningDecisionTreeSubsetFingerprint, ULearningDecisionTreeNode*>* Cache = PrepareSubtreeCache();
+	LDTRoot.Empty();
+	FlatTree.Reset();
+
+	FLearningDecisionTreeTable SampledTable;
+	FLearningDecisionTreeTable SelectedTable;
+	const FLearningDecisionTreeTable& TrainingTable = SelectFeatures(GetTrainingTable(SampledTable), SelectedTable);
+	ReusedSubtreeCount = 0;
+	BuildPeakBytes = BuildDecisionTree(TrainingTable, this, LDTRoot, NodesToExplode, FeatureSelection.DroppedFeatures.Num() > 0 ? &FeatureSelection : nullptr,
+		Cache, ReusedSubtreeCount) + SampledTable.GetAllocatedSize() + SelectedTable.GetAllocatedSize();
+
+	ResolveFeatureIndices();
+	if (bShareIdenticalSubtrees)
+	{
+		ShareIdenticalSubtrees();
+	}
+	PruneSubtreeCache();
+	BumpTreeVersion();
+}
+
+bool ULearningDecisionTree::CreateFlatDecisionTree()
+{
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_CreateDecisionTree);
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	FLearningDecisionTreeTable SampledTable;
+	TSharedPtr<FLearningDecisionTreeFlatModel> Model = LearningDecisionTreeCoreAdapter::BuildFlatModel(GetTrainingTable(SampledTable),
+		bLevelWiseFlatBuild ? LearningDecisionTreeCore::EBuildMode::LevelWise : LearningDecisionTreeCore::EBuildMode::DepthFirst);
+	if (!Model.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("CreateFlatDecisionTree: The table has no columns or is inconsistent."));
+		return false;
+	}
+
+	CancelDecisionTreeBuild();
+	LDTRoot.Empty();
+	FlatTree = Model;
+	BumpTreeVersion();
+	return true;
+}
+
+const FLearningDecisionTreeTable& ULearningDecisionTree::GetTrainingTable(FLearningDecisionTreeTable& SampledTable)
+{
+	if (TrainingSampling != ELearningDecisionTreeSampling::None)
+	{
+		UpdateTrainingSample();
+		if (!TrainingSampler.IsComplete())
+		{
+			TrainingSampler.BuildTable(Table.ColumnNames, SampledTable);
+			return SampledTable;
+		}
+	}
+	return Table;
+}
+
+const FLearningDecisionTreeTable& ULearningDecisionTree::SelectFeatures(const FLearningDecisionTreeTable& TrainingTable, FLearningDecisionTreeTable& SelectedTable)
+{
+	if (!bSelectFeatures)
+	{
+		FeatureSelection = FLearningDecisionTreeFeatureSelection();
+		return TrainingTable;
+	}
+
+	FeatureSelection = FLearningDecisionTreeFeatureSelection::Select(TrainingTable, FeatureSelectionSettings);
+	UE_LOG(LogTemp, Verbose, TEXT("SelectFeatures: Training on %d of %d features (%d constant, %d duplicate, %d low information dropped)."),
+		FeatureSelection.KeptFeatures.Num(), FMath::Max(TrainingTable.ColumnNames.Num() - 1, 0),
+		FeatureSelection.NumConstant, FeatureSelection.NumDuplicate, FeatureSelection.NumLowInformation);
+	if (FeatureSelection.DroppedFeatures.Num() == 0)
+	{
+		return TrainingTable;
+	}
+
+	FeatureSelection.BuildTable(TrainingTable, SelectedTable);
+	return SelectedTable;
+}
+
+void ULearningDecisionTree::BeginDecisionTreeBuild()
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	CancelDecisionTreeBuild();
+	PrepareSubtreeCache();
+
+	// The root node copies the training rows, so the Table can keep changing while the build runs
+	FLearningDecisionTreeTable SampledTable;
+	FLearningDecisionTreeTable SelectedTable;
+	BuildPendingTableBytes = StartDecisionTree(SelectFeatures(GetTrainingTable(SampledTable), SelectedTable), this, PendingRoot, NodesToExplode);
+	BuildPeakTableBytes = BuildPendingTableBytes + SampledTable.GetAllocatedSize() + SelectedTable.GetAllocatedSize();
+	BuildProgress.bInProgress = true;
+	BuildProgress.NodesPending = NodesToExplode.Num();
+}
+
+bool ULearningDecisionTree::TickBuild(float BudgetMs)
+{
+	if (!BuildProgress.bInProgress)
+	{
+		return true;
+	}
+
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_TickBuild);
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	// Always explode at least one node, so a budget shorter than a single split still makes progress
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + BudgetMs / 1000.0;
+	do
+	{
+		ExplodeNextNode(NodesToExplode, BuildPendingTableBytes, BuildPeakTableBytes, FeatureSelection.DroppedFeatures.Num() > 0 ? &FeatureSelection : nullptr,
+			bReuseUnchangedSubtrees ? &SubtreeCache : nullptr, BuildProgress.SubtreesReused);
+		BuildProgress.NodesExploded++;
+	}
+	while (NodesToExplode.Num() > 0 && FPlatformTime::Seconds() < EndTime);
+
+	BuildProgress.NodesPending = NodesToExplode.Num();
+	BuildProgress.BuildSeconds += (float)(FPlatformTime::Seconds() - StartTime);
+	if (NodesToExplode.Num() > 0)
+	{
+		return false;
+	}
+
+	// Swap the finished tree in; Eval has used the old one up to here
+	LDTRoot = MoveTemp(PendingRoot);
+	PendingRoot.Reset();
+	FlatTree.Reset();
+	BuildPeakBytes = BuildPeakTableBytes;
+	BuildProgress.bInProgress = false;
+	ReusedSubtreeCount = BuildProgress.SubtreesReused;
+
+	ResolveFeatureIndices();
+	if (bShareIdenticalSubtrees)
+	{
+		ShareIdenticalSubtrees();
+	}
+	PruneSubtreeCache();
+	BumpTreeVersion();
+	return true;
+}
+
+void ULearningDecisionTree::CancelDecisionTreeBuild()
+{
+	NodesToExplode.Empty();
+	PendingRoot.Empty();
+	BuildPendingTableBytes = 0;
+	BuildPeakTableBytes = 0;
+	BuildProgress = FLearningDecisionTreeBuildProgress();
+}
+
+TMap<FLearningDecisionTreeSubsetFingerprint, ULearningDecisionTreeNode*>* ULearningDecisionTree::PrepareSubtreeCache()
+{
+	if (!bReuseUnchangedSubtrees)
+	{
+		SubtreeCache.Empty();
+		return nullptr;
+	}
+
+	// Loading, flattening or re-laying out the tree replaces its nodes, which drops their entries here
+	PruneSubtreeCache();
+	return &SubtreeCache;
+}
+
+void ULearningDecisionTree::PruneSubtreeCache()
+{
+	if (SubtreeCache.Num() == 0)
+	{
+		return;
+	}
+
+	TSet<const ULearningDecisionTreeNode*> Reachable;
+	TArray<const ULearningDecisionTreeNode*> Stack;
+	Stack.Append(LDTRoot);
+	while (Stack.Num() > 0)
+	{
+		const ULearningDecisionTreeNode* Node = Stack.Pop();
+		bool bAlreadyVisited = false;
+		Reachable.Add(Node, &bAlreadyVisited);
+		const ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node);
+		if (DNode && !bAlreadyVisited)
+		{
+			Stack.Append(DNode->Nodes);
+		}
+	}
+
+	for (auto It = SubtreeCache.CreateIterator(); It; ++It)
+	{
+		if (!Reachable.Contains(It.Value()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void ULearningDecisionTree::UpdateTrainingSample()
+{
+	int32 Width = Table.ColumnNames.Num();
+	if (bTrainingSampleValid && SampledChangeSerial == TableChangeSerial && TrainingSampler.Matches(TrainingSampling, TrainingSampleSize, Width, TrainingSampleSeed))
+	{
+		return;
+	}
+
+	// The Table was replaced, gained a column or the settings changed: sample it again from scratch
+	TrainingSampler.Reset(TrainingSampling, TrainingSampleSize, Width, TrainingSampleSeed);
+	TrainingSampler.AddTable(Table);
+	SampledChangeSerial = TableChangeSerial;
+	bTrainingSampleValid = true;
+}
+
+// Walks from Root with a full feature row; see ULearningDecisionTree::FindLeaf()
+static const ULearningDecisionTreeActionNode* FindLeafFrom(const ULearningDecisionTreeNode* Node, TArrayView<const int32> Row, FLearningDecisionTreePath* OutPath)
+{
+	while (const ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node))
+	{
+		if (OutPath && Row.IsValidIndex(DNode->FeatureIndex))
+		{
+			OutPath->Add(DNode->FeatureIndex);
+		}
+
+		int32 Branch = DNode->FindBranch(Row);
+		if (Branch == -1)
+		{
+			return nullptr;
+		}
+		Node = DNode->Nodes[Branch];
+	}
+
+	return Cast<ULearningDecisionTreeActionNode>(Node);
+}
+
+// Counts the splits of Sampled that are reached by the same (feature, state) path in Full
+static void CompareSplits(const ULearningDecisionTreeNode* Sampled, const ULearningDecisionTreeNode* Full, FLearningDecisionTreeSampleReport& Report)
+{
+	const ULearningDecisionTreeDecisionNode* SampledSplit = Cast<ULearningDecisionTreeDecisionNode>(Sampled);
+	if (!SampledSplit)
+	{
+		return;
+	}
+
+	const ULearningDecisionTreeDecisionNode* FullSplit = Cast<ULearningDecisionTreeDecisionNode>(Full);
+	if (!FullSplit)
+	{
+		Report.ExtraSplits++;
+		return;
+	}
+
+	Report.ComparedSplits++;
+	if (SampledSplit->FeatureIndex != FullSplit->FeatureIndex)
+	{
+		// The paths below test different features and cannot be lined up
+		return;
+	}
+	Report.MatchingSplits++;
+
+	for (int32 Branch = 0; Branch < SampledSplit->Nodes.Num() && Branch < SampledSplit->ColumnStates.Num(); Branch++)
+	{
+		int32 FullBranch = FullSplit->ColumnStates.Find(SampledSplit->ColumnStates[Branch]);
+		if (FullSplit->Nodes.IsValidIndex(FullBranch))
+		{
+			CompareSplits(SampledSplit->Nodes[Branch], FullSplit->Nodes[FullBranch], Report);
+		}
+	}
+}
+
+FLearningDecisionTreeSampleReport ULearningDecisionTree::CompareSampledBuild()
+{
+	FLearningDecisionTreeSampleReport Report;
+	Report.FullRows = Table.GetTotalRowCount();
+	if (Table.ColumnNames.Num() == 0)
+	{
+		return Report;
+	}
+
+	TArray<ULearningDecisionTreeNode*> FullRoot;
+	TArray<ULearningDecisionTreeNode*> SampledRoot;
+	TArray<ULearningDecisionTreeNode*> Queue;
+	int32 SubtreesReused = 0;
+
+	// Timed on every column and from scratch, without the subtree cache
+	double StartTime = FPlatformTime::Seconds();
+	BuildDecisionTree(Table, GetTransientPackage(), FullRoot, Queue, nullptr, nullptr, SubtreesReused);
+	Report.FullBuildSeconds = (float)(FPlatformTime::Seconds() - StartTime);
+
+	StartTime = FPlatformTime::Seconds();
+	FLearningDecisionTreeTable SampledTable;
+	if (TrainingSampling != ELearningDecisionTreeSampling::None)
+	{
+		UpdateTrainingSample();
+		TrainingSampler.BuildTable(Table.ColumnNames, SampledTable);
+	}
+	else
+	{
+		SampledTable = Table;
+	}
+	BuildDecisionTree(SampledTable, GetTransientPackage(), SampledRoot, Queue, nullptr, nullptr, SubtreesReused);
+	Report.SampledBuildSeconds = (float)(FPlatformTime::Seconds() - StartTime);
+	Report.SampledRows = SampledTable.GetTotalRowCount();
+
+	TArray<int32> UsedFeatures;
+	ResolveNodeFeatureIndices(FullRoot[0], UsedFeatures);
+	ResolveNodeFeatureIndices(SampledRoot[0], UsedFeatures);
+
+	const ULearningDecisionTreeDecisionNode* FullRootSplit = Cast<ULearningDecisionTreeDecisionNode>(FullRoot[0]);
+	const ULearningDecisionTreeDecisionNode* SampledRootSplit = Cast<ULearningDecisionTreeDecisionNode>(SampledRoot[0]);
+	Report.FullRootFeature = FullRootSplit ? FullRootSplit->FeatureIndex : INDEX_NONE;
+	Report.SampledRootFeature = SampledRootSplit ? SampledRootSplit->FeatureIndex : INDEX_NONE;
+	CompareSplits(SampledRoot[0], FullRoot[0], Report);
+
+	// Prediction agreement over every sample of the table
+	int32 NumFeatures = Table.ColumnNames.Num() - 1;
+	TArray<int32> Row;
+	Row.SetNumUninitialized(NumFeatures);
+	int64 Agreeing = 0;
+	for (int32 Index = 0; Index < Table.GetTableRowCount(); Index++)
+	{
+		for (int32 Column = 0; Column < NumFeatures; Column++)
+		{
+			Row[Column] = Table.TableData[Table.ColumnNames[Column]][Index];
+		}
+		const ULearningDecisionTreeActionNode* FullLeaf = FindLeafFrom(FullRoot[0], Row, nullptr);
+		const ULearningDecisionTreeActionNode* SampledLeaf = FindLeafFrom(SampledRoot[0], Row, nullptr);
+		if ((FullLeaf ? FullLeaf->MostLikelyAction() : -1) == (SampledLeaf ? SampledLeaf->MostLikelyAction() : -1))
+		{
+			Agreeing += Table.DuplicateCounts[Index];
+		}
+	}
+	Report.ActionAgreement = Report.FullRows > 0 ? (float)((double)Agreeing / Report.FullRows) : 1.0f;
+
+	UE_LOG(LogTemp, Log, TEXT("CompareSampledBuild: %d of %d samples, build %.3fs vs %.3fs, root feature %d vs %d, %d/%d splits match, %d extra, %.1f%% same predictions"),
+		Report.SampledRows, Report.FullRows, Report.SampledBuildSeconds, Report.FullBuildSeconds, Report.SampledRootFeature, Report.FullRootFeature,
+		Report.MatchingSplits, Report.ComparedSplits, Report.ExtraSplits, Report.ActionAgreement * 100.0f);
+	return Report;
+}
+
+void ULearningDecisionTree::RefreshStates(const TArray<int32>& Row)
+{
+	// Reset keeps the allocation, unlike assigning a row of another length
+	RowRealTimeStates.Reset();
+	RowRealTimeStates.Append(Row.GetData(), Row.Num());
+}
+
+void ULearningDecisionTree::FitDiscretizer(const TArray<float>& Samples, int32 NumRows, int32 NumBins)
+{
+	Discretizer.FitQuantiles(Samples, NumRows, NumBins);
+}
+
+void ULearningDecisionTree::AddRowFromFloats(const TArray<float>& Features, int32 Action)
+{
+	TArray<int32> Row;
+	Row.SetNumUninitialized(Features.Num() + 1);
+	Discretizer.DiscretizeRow(Features, Row);
+	Row.Last() = Action;
+	AddRow(Row);
+}
+
+void ULearningDecisionTree::RefreshStatesFromFloats(const TArray<float>& Features)
+{
+	RowRealTimeStates.SetNumUninitialized(Features.Num());
+	Discretizer.DiscretizeRow(Features, RowRealTimeStates);
+}
+
+void ULearningDecisionTree::RefreshContextStatesFromFloats(FLearningDecisionTreeEvalContext& Context, const TArray<float>& Features) const
+{
+	TArray<int32, TInlineAllocator<32>> Row;
+	Row.SetNumUninitialized(Features.Num());
+	Discretizer.DiscretizeRow(Features, Row);
+	Context.SetStates(Row);
+}
+
+void ULearningDecisionTree::DiscretizeBatch(const TArray<float>& Features, int32 NumRows, TArray<int32>& OutStates) const
+{
+	OutStates.SetNumZeroed(Features.Num());
+	Discretizer.DiscretizeBatch(Features, NumRows, OutStates);
+}
+
+int32 ULearningDecisionTree::Eval()
+{
+	SCOPE_CYCLE_COUNTER(STAT_LearningDecisionTree_Eval);
+	INC_DWORD_STAT(STAT_LearningDecisionTree_Evals);
+	ProfileBranches(RowRealTimeStates);
+
+	if (FlatTree.IsValid())
+	{
+		FRandomStream RandomStream(FMath::Rand());
+		return FlatTree->GetView().Eval(RowRealTimeStates, RandomStream);
+	}
+	const ULearningDecisionTreeActionNode* Leaf = FindLeaf(RowRealTimeStates);
+	return Leaf ? Leaf->SampleAction() : -1;
+}
+
+int32 ULearningDecisionTree::EvalWithContext(FLearningDecisionTreeEvalContext& Context) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_LearningDecisionTree_Eval);
+	INC_DWORD_STAT(STAT_LearningDecisionTree_Evals);
+	ProfileBranches(Context.States);
+
+	if (FlatTree.IsValid())
+	{
+		return FlatTree->GetView().EvalWithContext(Context, TreeVersion);
+	}
+
+	if (TreeVersion != 0 && Context.CachedTreeVersion == TreeVersion)
+	{
+		Context.CacheHits++;
+	}
+	else
+	{
+		Context.CacheMisses++;
+		Context.PathFeatures.Reset();
+		Context.CachedFlatLeaf = INDEX_NONE;
+		Context.CachedLeaf = FindLeaf(Context.States, &Context.PathFeatures);
+		Context.CachedMostLikelyAction = Context.CachedLeaf ? Context.CachedLeaf->MostLikelyAction() : -1;
+		Context.CachedTreeVersion = TreeVersion;
+	}
+
+	if (Context.bUseMostLikelyAction)
+	{
+		return Context.CachedMostLikelyAction;
+	}
+	return Context.CachedLeaf ? Context.CachedLeaf->SampleAction(Context.RandomStream) : -1;
+}
+
+int32 ULearningDecisionTree::EvalRow(const TArray<int32>& Row, FLearningDecisionTreeEvalContext& Context) const
+{
+	return EvalRow(MakeArrayView(Row), Context.RandomStream, Context.bUseMostLikelyAction);
+}
+
+int32 ULearningDecisionTree::EvalRow(TArrayView<const int32> Row, FRandomStream& RandomStream, bool bMostLikelyAction) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_LearningDecisionTree_Eval);
+	INC_DWORD_STAT(STAT_LearningDecisionTree_Evals);
+	ProfileBranches(Row);
+
+	if (FlatTree.IsValid())
+	{
+		return FlatTree->GetView().Eval(Row, RandomStream, bMostLikelyAction);
+	}
+
+	const ULearningDecisionTreeActionNode* Leaf = FindLeaf(Row);
+	if (!Leaf)
+	{
+		return -1;
+	}
+	return bMostLikelyAction ? Leaf->MostLikelyAction() : Leaf->SampleAction(RandomStream);
+}
+
+void ULearningDecisionTree::SetContextState(FLearningDecisionTreeEvalContext& Context, int32 FeatureIndex, int32 Value)
+{
+	Context.SetState(FeatureIndex, Value);
+}
+
+void ULearningDecisionTree::RefreshContextStates(FLearningDecisionTreeEvalContext& Context, const TArray<int32>& Row)
+{
+	Context.SetStates(Row);
+}
+
+const ULearningDecisionTreeActionNode* ULearningDecisionTree::FindLeaf(TArrayView<const int32> Row, FLearningDecisionTreePath* OutPath) const
+{
+	return FindLeafFrom(LDTRoot.Num() > 0 ? LDTRoot[0] : nullptr, Row, OutPath);
+}
+
+// Calls Func once for every DecisionNode reachable from Root
+template <typename FunctionType>
+static void ForEachDecisionNode(ULearningDecisionTreeNode* Root, FunctionType&& Func)
+{
+	TSet<ULearningDecisionTreeNode*> Visited;
+	TArray<ULearningDecisionTreeNode*> Stack;
+	Stack.Add(Root);
+	while (Stack.Num() > 0)
+	{
+		ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Stack.Pop());
+		bool bAlreadyVisited = false;
+		Visited.Add(DNode, &bAlreadyVisited);
+		if (DNode && !bAlreadyVisited)
+		{
+			Func(*DNode);
+			Stack.Append(DNode->Nodes);
+		}
+	}
+}
+
+// Re-creates the tree below Node depth-first, visiting children in branch order,
+// so each node is allocated right after the parent that reaches it through its first branch
+static ULearningDecisionTreeNode* CloneDepthFirst(ULearningDecisionTreeNode* Node, UObject* Outer, TMap<ULearningDecisionTreeNode*, ULearningDecisionTreeNode*>& Clones)
+{
+	if (!Node)
+	{
+		return nullptr;
+	}
+	if (ULearningDecisionTreeNode** Existing = Clones.Find(Node))
+	{
+		return *Existing;
+	}
+
+	if (ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node))
+	{
+		ULearningDecisionTreeDecisionNode* Clone = NewObject<ULearningDecisionTreeDecisionNode>(Outer);
+		Clones.Add(Node, Clone);
+		Clone->ColumnStates = DNode->ColumnStates;
+		Clone->BestInfoGainColumn = DNode->BestInfoGainColumn;
+		Clone->FeatureIndex = DNode->FeatureIndex;
+		Clone->Nodes.Reserve(DNode->Nodes.Num());
+		for (ULearningDecisionTreeNode* Child : DNode->Nodes)
+		{
+			Clone->Nodes.Add(CloneDepthFirst(Child, Outer, Clones));
+		}
+		return Clone;
+	}
+
+	ULearningDecisionTreeNode* Clone = DuplicateObject<ULearningDecisionTreeNode>(Node, Outer);
+	Clones.Add(Node, Clone);
+	return Clone;
+}
+
+// Identifies a subtree by its content: a leaf by its action counts, a decision by its split and shared children
+struct FLearningDecisionTreeSubtreeKey
+{
+	TArray<int32> Values;
+
+	bool operator==(const FLearningDecisionTreeSubtreeKey& Other) const { return Values == Other.Values; }
+
+	friend uint32 GetTypeHash(const FLearningDecisionTreeSubtreeKey& Key)
+	{
+		return FCrc::MemCrc32(Key.Values.GetData(), Key.Values.Num() * sizeof(int32));
+	}
+};
+
+// Hash-conses the subtree below Node bottom-up and returns the shared node to use in its place
+static ULearningDecisionTreeNode* ShareSubtree(ULearningDecisionTreeNode* Node, TMap<ULearningDecisionTreeNode*, ULearningDecisionTreeNode*>& Shared,
+	TMap<FLearningDecisionTreeSubtreeKey, ULearningDecisionTreeNode*>& ByKey, TMap<const ULearningDecisionTreeNode*, int32>& Ids)
+{
+	if (!Node)
+	{
+		return nullptr;
+	}
+	if (ULearningDecisionTreeNode** Existing = Shared.Find(Node))
+	{
+		return *Existing;
+	}
+
+	FLearningDecisionTreeSubtreeKey Key;
+	ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node);
+	if (DNode)
+	{
+		// Relative and resolved columns must both match, so ResolveFeatureIndices() agrees on every path to a shared node
+		Key.Values.Add(2);
+		Key.Values.Add(DNode->FeatureIndex);
+		Key.Values.Add(DNode->BestInfoGainColumn);
+		Key.Values.Add(DNode->ColumnStates.Num());
+		Key.Values.Append(DNode->ColumnStates);
+		for (ULearningDecisionTreeNode*& Child : DNode->Nodes)
+		{
+			Child = ShareSubtree(Child, Shared, ByKey, Ids);
+			const int32* ChildId = Child ? Ids.Find(Child) : nullptr;
+			Key.Values.Add(ChildId ? *ChildId : INDEX_NONE);
+		}
+	}
+	else if (const ULearningDecisionTreeActionNode* ANode = Cast<ULearningDecisionTreeActionNode>(Node))
+	{
+		Key.Values.Add(3);
+		Key.Values.Add(ANode->ActionNames.Num());
+		Key.Values.Append(ANode->ActionNames);
+		Key.Values.Append(ANode->ActionCounts);
+	}
+	else
+	{
+		// Leftover table nodes are never shared
+		Shared.Add(Node, Node);
+		return Node;
+	}
+
+	ULearningDecisionTreeNode*& Canonical = ByKey.FindOrAdd(MoveTemp(Key));
+	if (!Canonical)
+	{
+		Canonical = Node;
+		Ids.Add(Node, Ids.Num());
+	}
+	else if (DNode)
+	{
+		// Keep the branch profile of the merged copy
+		ULearningDecisionTreeDecisionNode* CanonicalDecision = CastChecked<ULearningDecisionTreeDecisionNode>(Canonical);
+		if (CanonicalDecision->BranchHits.Num() == DNode->BranchHits.Num())
+		{
+			for (int32 Branch = 0; Branch < DNode->BranchHits.Num(); Branch++)
+			{
+				CanonicalDecision->BranchHits[Branch] += DNode->BranchHits[Branch];
+			}
+		}
+	}
+	Shared.Add(Node, Canonical);
+	return Canonical;
+}
+
+FLearningDecisionTreeShareReport ULearningDecisionTree::ShareIdenticalSubtrees()
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	FLearningDecisionTreeShareReport Report;
+	FLearningDecisionTreeMemoryReport Before = GetMemoryReport();
+	Report.NodesBefore = Report.NodesAfter = Before.TreeNodes;
+	Report.TreeBytesBefore = Report.TreeBytesAfter = Before.TreeBytes;
+	if (FlatTree.IsValid() || LDTRoot.Num() == 0)
+	{
+		return Report;
+	}
+
+	// The merged copies are left to GC
+	TMap<ULearningDecisionTreeNode*, ULearningDecisionTreeNode*> Shared;
+	TMap<FLearningDecisionTreeSubtreeKey, ULearningDecisionTreeNode*> ByKey;
+	TMap<const ULearningDecisionTreeNode*, int32> Ids;
+	for (ULearningDecisionTreeNode*& Root : LDTRoot)
+	{
+		Root = ShareSubtree(Root, Shared, ByKey, Ids);
+	}
+
+	FLearningDecisionTreeMemoryReport After = GetMemoryReport();
+	Report.NodesAfter = After.TreeNodes;
+	Report.TreeBytesAfter = After.TreeBytes;
+	UE_LOG(LogTemp, Log, TEXT("ShareIdenticalSubtrees: %d -> %d nodes, %lld -> %lld bytes"),
+		Report.NodesBefore, Report.NodesAfter, Report.TreeBytesBefore, Report.TreeBytesAfter);
+
+	// Cached leaves may point at merged copies
+	BumpTreeVersion();
+	return Report;
+}
+
+bool ULearningDecisionTree::OptimizeBranchLayout()
+{
+	if (FlatTree.IsValid())
+	{
+		TArray<uint8> Bytes;
+		TSharedPtr<FLearningDecisionTreeFlatModel> Model;
+		if (FlatTree->GetView().BuildHotFirst(FlatBranchHits, Bytes))
+		{
+			Model = FLearningDecisionTreeFlatModel::FromBytes(MoveTemp(Bytes));
+		}
+		if (!Model.IsValid())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("OptimizeBranchLayout: The flat tree has no branch profile or is malformed."));
+			return false;
+		}
+
+		FlatTree = Model;
+		BumpTreeVersion();
+		return true;
+	}
+
+	if (LDTRoot.Num() == 0 || !LDTRoot[0])
+	{
+		UE_LOG(LogTemp, Warning, TEXT("OptimizeBranchLayout: No decision tree to optimize."));
+		return false;
+	}
+
+	ForEachDecisionNode(LDTRoot[0], [](ULearningDecisionTreeDecisionNode& DNode)
+	{
+		DNode.SortBranchesByHits();
+	});
+
+	// The clones start with empty counters; the old nodes are left to GC
+	TMap<ULearningDecisionTreeNode*, ULearningDecisionTreeNode*> Clones;
+	LDTRoot[0] = CloneDepthFirst(LDTRoot[0], this, Clones);
+
+	ResolveFeatureIndices();
+	BumpTreeVersion();
+	return true;
+}
+
+void ULearningDecisionTree::ResetBranchProfile()
+{
+	FMemory::Memzero(FlatBranchHits.GetData(), FlatBranchHits.Num() * sizeof(int32));
+	if (LDTRoot.Num() > 0)
+	{
+		ForEachDecisionNode(LDTRoot[0], [](ULearningDecisionTreeDecisionNode& DNode)
+		{
+			FMemory::Memzero(DNode.BranchHits.GetData(), DNode.BranchHits.Num() * sizeof(int32));
+		});
+	}
+}
+
+void ULearningDecisionTree::ProfileBranches(TArrayView<const int32> Row) const
+{
+#if LEARNINGDECISIONTREE_BRANCH_PROFILING
+	if (!bProfileBranches || ProfiledEvals.fetch_add(1, std::memory_order_relaxed) % (uint32)FMath::Max(1, BranchProfileInterval) != 0)
+	{
+		return;
+	}
+
+	if (FlatTree.IsValid())
+	{
+		FlatTree->GetView().CountBranchHits(Row, FlatBranchHits);
+		return;
+	}
+
+	const ULearningDecisionTreeNode* Node = LDTRoot.Num() > 0 ? LDTRoot[0] : nullptr;
+	while (const ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node))
+	{
+		int32 Branch = DNode->FindBranch(Row);
+		if (Branch == -1)
+		{
+			return;
+		}
+		DNode->AddBranchHit(Branch);
+		Node = DNode->Nodes[Branch];
+	}
+#endif
 }
 
-int32 ULearningDecisionTree::GetTotalRowCount() const
+void ULearningDecisionTree::BumpTreeVersion()
 {
-	return Table.GetTotalRowCount();
-}
+	TreeVersion = FLearningDecisionTreeEvalContext::AllocateTreeVersion();
 
-void ULearningDecisionTree::AddColumn(FName ColumnName)
-{
-	Table.AddColumn(ColumnName);
+#if LEARNINGDECISIONTREE_BRANCH_PROFILING
+	FlatBranchHits.Reset();
+	if (FlatTree.IsValid())
+	{
+		FlatBranchHits.SetNumZeroed(FlatTree->GetView().GetNumBranches());
+	}
+#endif
 }
 
-void ULearningDecisionTree::AddRow(const TArray<int32>& Row)
+void ULearningDecisionTree::DebugTable()
 {
-	Table.AddRow(Row);
+	Table.DebugTable();
 }
 
-void ULearningDecisionTree::CreateDecisionTree()
+FLearningDecisionTreeMemoryReport ULearningDecisionTree::GetMemoryReport() const
 {
-	// Clear previous tree state
-	NodesToExplode.Empty();
-	LDTRoot.Empty();
-
-	// Create the initial root TableNode containing the full dataset
-	ULearningDecisionTreeTableNode* RootNode = NewObject<ULearningDecisionTreeTableNode>(this);
-	LDTRoot.Add(RootNode);
+	FLearningDecisionTreeMemoryReport Report;
+	Report.TableBytes = Table.GetAllocatedSize();
+	Report.BuildPeakBytes = BuildPeakBytes;
 
-	// Init root node. It adds itself to NodesToExplode queue.
-	// We pass LDTRoot as the parent list so the RootNode can eventually replace itself
-	// with the final DecisionNode or ActionNode.
-	RootNode->Init(Table, NodesToExplode, &LDTRoot, 0);
+	if (FlatTree.IsValid())
+	{
+		Report.TreeBytes = FlatTree->GetView().GetBytes().Num();
+	}
 
-	// Iteratively process nodes until the queue is empty
-	// Note: NodesToExplode grows as TableNodes split into children TableNodes.
-	while (NodesToExplode.Num() > 0)
+	// Walks the node graph; nodes reachable along several paths are counted once
+	TSet<const ULearningDecisionTreeNode*> Visited;
+	TArray<const ULearningDecisionTreeNode*> Stack(LDTRoot);
+	Report.TreeBytes += LDTRoot.GetAllocatedSize();
+	while (Stack.Num() > 0)
 	{
-		ULearningDecisionTreeNode* Node = NodesToExplode[0];
-		if (Node)
+		const ULearningDecisionTreeNode* Node = Stack.Pop();
+		bool bAlreadyVisited = false;
+		Visited.Add(Node, &bAlreadyVisited);
+		if (!Node || bAlreadyVisited)
+		{
+			continue;
+		}
+
+		Report.TreeNodes++;
+		Report.TreeBytes += Node->GetClass()->GetStructureSize() + Node->GetAllocatedSize();
+		if (const ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node))
 		{
-			// ExplodeNode will process the node (split it or make it a leaf)
-			// and potentially add new children to NodesToExplode.
-			Node->ExplodeNode(NodesToExplode);
+			Stack.Append(DNode->Nodes);
 		}
-		// Remove the processed node from the queue
-		NodesToExplode.RemoveAt(0);
 	}
+
+	Report.TransientBytes = TrainingSampler.GetAllocatedSize() + NodesToExplode.GetAllocatedSize() + PendingRoot.GetAllocatedSize() + BuildPendingTableBytes;
+	if (TableJournal)
+	{
+		Report.TransientBytes += TableJournal->GetAllocatedSize();
+	}
+	return Report;
 }
 
-void ULearningDecisionTree::RefreshStates(const TArray<int32>& Row)
+#if STATS
+// Number of DecisionNodes on the longest path below Node
+static int32 GetNodeDepth(const ULearningDecisionTreeNode* Node)
 {
-	RowRealTimeStates = Row;
+	int32 Depth = 0;
+	if (const ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node))
+	{
+		for (const ULearningDecisionTreeNode* Child : DNode->Nodes)
+		{
+			Depth = FMath::Max(Depth, GetNodeDepth(Child) + 1);
+		}
+		Depth = FMath::Max(Depth, 1);
+	}
+	return Depth;
 }
+#endif
 
-int32 ULearningDecisionTree::Eval()
+// Each DecisionNode splits a table from which its ancestors' columns were removed,
+// so BestInfoGainColumn counts only the columns that are still left at that depth.
+// UsedFeatures holds the original indices already consumed on the path, sorted ascending.
+static void ResolveNodeFeatureIndices(ULearningDecisionTreeNode* Node, TArray<int32>& UsedFeatures)
 {
-	if (LDTRoot.Num() > 0 && LDTRoot[0])
+	ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node);
+	if (!DNode)
+	{
+		return;
+	}
+
+	int32 Feature = DNode->BestInfoGainColumn;
+	for (int32 Used : UsedFeatures)
+	{
+		if (Used <= Feature)
+		{
+			Feature++;
+		}
+		else
+		{
+			break;
+		}
+	}
+	DNode->FeatureIndex = Feature;
+
+#if LEARNINGDECISIONTREE_BRANCH_PROFILING
+	if (DNode->BranchHits.Num() != DNode->Nodes.Num())
 	{
-		return LDTRoot[0]->Eval(RowRealTimeStates);
+		DNode->BranchHits.SetNumZeroed(DNode->Nodes.Num());
 	}
-	return -1;
+#endif
+
+	int32 InsertAt = Algo::LowerBound(UsedFeatures, Feature);
+	UsedFeatures.Insert(Feature, InsertAt);
+	for (ULearningDecisionTreeNode* Child : DNode->Nodes)
+	{
+		ResolveNodeFeatureIndices(Child, UsedFeatures);
+	}
+	UsedFeatures.RemoveAt(InsertAt);
 }
 
-void ULearningDecisionTree::DebugTable()
+void ULearningDecisionTree::ResolveFeatureIndices()
 {
-	Table.DebugTable();
+	TArray<int32> UsedFeatures;
+	for (ULearningDecisionTreeNode* Node : LDTRoot)
+	{
+		ResolveNodeFeatureIndices(Node, UsedFeatures);
+	}
+
+#if STATS
+	SET_DWORD_STAT(STAT_LearningDecisionTree_TreeDepth, LDTRoot.Num() > 0 ? GetNodeDepth(LDTRoot[0]) : 0);
+#endif
 }
 
 // ============================================================================
 // Serialization
 // ============================================================================
 
-void ULearningDecisionTree::SaveTable(FString FolderPath, FString FileName)
+// Nodes written or read so far, numbered in the order they were completed, so a node shared by several
+// parents is stored once and referenced by its number afterwards
+using FLearningDecisionTreeWrittenNodes = TMap<const ULearningDecisionTreeNode*, int32>;
+using FLearningDecisionTreeReadNodes = TArray<ULearningDecisionTreeNode*>;
+
+static void SerializeNodes(FArchive& Ar, TArray<ULearningDecisionTreeNode*>& Nodes, FLearningDecisionTreeWrittenNodes& Written);
+static void DeserializeNodes(FArchive& Ar, TArray<ULearningDecisionTreeNode*>& Nodes, UObject* Outer, FLearningDecisionTreeReadNodes& Read);
+
+/**
+ * One save or load. Run() does the file work and may execute on a background task;
+ * ULearningDecisionTree::ApplyIORequest() then brings the result into the tree on the game thread.
+ */
+struct FLearningDecisionTreeIORequest
 {
-	// Serialize Table struct
-	FString FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".dat"));
+	enum class EKind : uint8
+	{
+		SaveTable,
+		LoadTable,
+		SaveTree,
+		LoadTree
+	};
+
+	EKind Kind = EKind::SaveTable;
+	FString FullPath;
+	FOnLearningDecisionTreeIOComplete OnComplete;
+
+	/** SaveTable: the table to write, either the tree's own (sync) or CopiedTable (async). */
+	const FLearningDecisionTreeTable* SourceTable = nullptr;
+	ELearningDecisionTreeCompression Compression = ELearningDecisionTreeCompression::None;
+
+	/** SaveTable: the table copied for an async save. LoadTable: the table read. */
+	FLearningDecisionTreeTable CopiedTable;
+
+	/** Identity of the table file written or read. */
+	FLearningDecisionTreeSnapshotId Snapshot;
 
+	/** SaveTable: the tree's TableChangeSerial at the time SourceTable was taken. */
+	uint64 TableChangeSerial = 0;
+
+	/** SaveTable: journal position at the time SourceTable was taken, or -1 if the snapshot holds everything journaled. */
+	int64 JournalPosition = -1;
+
+	/** SaveTree: the serialized tree. LoadTree: the file contents. */
 	TArray<uint8> Bytes;
-	FMemoryWriter MemoryWriter(Bytes, true);
-	FLearningDecisionTreeTable& TableRef = Table;
 
-	// Manual serialization to ensure stability and control over format
+	/** LoadTree: the tree's TreeVersion when the load was requested. */
+	uint32 TreeVersion = 0;
+
+	bool bSucceeded = false;
+	FString Error;
+
+	/** Set once Run() has finished. */
+	std::atomic<bool> bDone{ false };
+
+	void Run()
+	{
+		LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+		switch (Kind)
+		{
+		case EKind::SaveTable:
+		{
+			LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_SaveTable);
+			bSucceeded = WriteTable();
+			INC_DWORD_STAT_BY(STAT_LearningDecisionTree_BytesWritten, bSucceeded ? Snapshot.Size : 0);
+			break;
+		}
+
+		case EKind::LoadTable:
+		{
+			LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_LoadTable);
+			bSucceeded = ReadTable();
+			INC_DWORD_STAT_BY(STAT_LearningDecisionTree_BytesRead, bSucceeded ? Snapshot.Size : 0);
+			break;
+		}
+
+		case EKind::SaveTree:
+		{
+			LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_SaveDecisionTree);
+			bSucceeded = FFileHelper::SaveArrayToFile(Bytes, *FullPath);
+			INC_DWORD_STAT_BY(STAT_LearningDecisionTree_BytesWritten, bSucceeded ? Bytes.Num() : 0);
+			if (!bSucceeded)
+			{
+				Error = FString::Printf(TEXT("SaveDecisionTree: Failed to write %s"), *FullPath);
+			}
+			break;
+		}
+
+		case EKind::LoadTree:
+		{
+			LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_LoadDecisionTree);
+			bSucceeded = FFileHelper::LoadFileToArray(Bytes, *FullPath, FILEREAD_Silent);
+			INC_DWORD_STAT_BY(STAT_LearningDecisionTree_BytesRead, Bytes.Num());
+			if (!bSucceeded)
+			{
+				Error = FString::Printf(TEXT("LoadDecisionTree: Failed to read %s"), *FullPath);
+			}
+			break;
+		}
+		}
+		bDone = true;
+	}
+
+	bool WriteTable()
+	{
+		FString TempPath = FullPath + TEXT(".tmp");
+
+		// Write the table into a temporary file so an interrupted save never leaves a truncated table behind.
+		TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*TempPath));
+		if (!FileWriter)
+		{
+			Error = FString::Printf(TEXT("SaveTable: Could not open %s for writing"), *TempPath);
+			return false;
+		}
+
+		FLearningDecisionTreeTableWriter Writer(*FileWriter, Compression);
+		bool bWritten = Writer.Write(*SourceTable);
+		Snapshot.Checksum = Writer.GetChecksum();
+		Snapshot.Size = FileWriter->TotalSize();
+		bWritten &= FileWriter->Close();
+		FileWriter.Reset();
+
+		if (!bWritten || !IFileManager::Get().Move(*FullPath, *TempPath, true, true))
+		{
+			Error = FString::Printf(TEXT("SaveTable: Failed to write %s"), *FullPath);
+			IFileManager::Get().Delete(*TempPath);
+			return false;
+		}
+		return true;
+	}
+
+	bool ReadTable()
+	{
+		// A missing snapshot is fine if a journal recorded everything since the table was created
+		TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*FullPath));
+		if (FileReader)
+		{
+			FLearningDecisionTreeTableReader Reader(*FileReader);
+			if (!Reader.Read(CopiedTable))
+			{
+				Error = FString::Printf(TEXT("LoadTable: Failed to read %s"), *FullPath);
+				return false;
+			}
+			Snapshot.Checksum = Reader.GetChecksum();
+			Snapshot.Size = FileReader->TotalSize();
+			FileReader.Reset();
+		}
+
+		int32 ReplayedRows = 0;
+		int64 ValidSize = 0;
+		bool bReplayed = FLearningDecisionTreeTableJournal::Replay(FPaths::ChangeExtension(FullPath, TEXT(".journal")), Snapshot, CopiedTable, ReplayedRows, ValidSize);
+		if (bReplayed && ReplayedRows > 0)
+		{
+			UE_LOG(LogTemp, Log, TEXT("LoadTable: Replayed %d journaled rows onto %s"), ReplayedRows, *FullPath);
+		}
+
+		if (Snapshot.Size == 0 && !bReplayed)
+		{
+			Error = FString::Printf(TEXT("LoadTable: %s does not exist"), *FullPath);
+			return false;
+		}
+		return true;
+	}
+};
+
+bool ULearningDecisionTree::SaveTable(FString FolderPath, FString FileName, ELearningDecisionTreeCompression Compression)
+{
+	return SaveTableFile(FPaths::Combine(FolderPath, FileName + TEXT(".dat")), Compression);
+}
+
+bool ULearningDecisionTree::SaveTableFile(const FString& FullPath, ELearningDecisionTreeCompression Compression)
+{
+	WaitForPendingIO();
+
+	FLearningDecisionTreeIORequest Request;
+	Request.Kind = FLearningDecisionTreeIORequest::EKind::SaveTable;
+	Request.FullPath = FullPath;
+	Request.SourceTable = &Table;
+	Request.Compression = Compression;
+	Request.TableChangeSerial = TableChangeSerial;
+	Request.Run();
+	ApplyIORequest(Request);
+	return Request.bSucceeded;
+}
+
+bool ULearningDecisionTree::LoadTable(FString FolderPath, FString FileName)
+{
+	WaitForPendingIO();
+
+	FLearningDecisionTreeIORequest Request;
+	Request.Kind = FLearningDecisionTreeIORequest::EKind::LoadTable;
+	Request.FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".dat"));
+	Request.Run();
+	ApplyIORequest(Request);
+	return Request.bSucceeded;
+}
 
-	MemoryWriter << TableRef.TotalRows;
+void ULearningDecisionTree::SaveTableAsync(FString FolderPath, FString FileName, ELearningDecisionTreeCompression Compression, FOnLearningDecisionTreeIOComplete OnComplete)
+{
+	TSharedRef<FLearningDecisionTreeIORequest> Request = MakeShared<FLearningDecisionTreeIORequest>();
+	Request->Kind = FLearningDecisionTreeIORequest::EKind::SaveTable;
+	Request->FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".dat"));
+	Request->OnComplete = MoveTemp(OnComplete);
+	Request->Compression = Compression;
 
-	// Serialize ColumnNames as strings for safety/portability
-	int32 NumCols = TableRef.ColumnNames.Num();
-	MemoryWriter << NumCols;
-	for (const FName& Name : TableRef.ColumnNames)
+	// Encoding and writing work on a copy, so rows can keep coming in while the file is written
+	Request->CopiedTable = Table;
+	Request->SourceTable = &Request->CopiedTable;
+	Request->TableChangeSerial = TableChangeSerial;
+	if (TableJournal && JournalTablePath == Request->FullPath)
 	{
-		FString NameStr = Name.ToString();
-		MemoryWriter << NameStr;
+		Request->JournalPosition = TableJournal->GetPosition();
 	}
 
-	// Serialize TableData Map manually
-	int32 NumColumns = TableRef.TableData.Num();
-	MemoryWriter << NumColumns;
-	for (auto& Pair : TableRef.TableData)
+	LaunchIORequest(Request);
+}
+
+void ULearningDecisionTree::LoadTableAsync(FString FolderPath, FString FileName, FOnLearningDecisionTreeIOComplete OnComplete)
+{
+	TSharedRef<FLearningDecisionTreeIORequest> Request = MakeShared<FLearningDecisionTreeIORequest>();
+	Request->Kind = FLearningDecisionTreeIORequest::EKind::LoadTable;
+	Request->FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".dat"));
+	Request->OnComplete = MoveTemp(OnComplete);
+
+	LaunchIORequest(Request);
+}
+
+bool ULearningDecisionTree::ImportTableCsv(FString FolderPath, FString FileName, FLearningDecisionTreeCsvStats& OutStats)
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	WaitForPendingIO();
+
+	FLearningDecisionTreeTable ImportedTable;
+	if (!FLearningDecisionTreeTableCsv::Import(FPaths::Combine(FolderPath, FileName), ImportedTable, &OutStats))
 	{
-		FName Key = Pair.Key;
-		TArray<int32> Value = Pair.Value;
-		FString KeyStr = Key.ToString();
-		MemoryWriter << KeyStr;
-		MemoryWriter << Value;
+		return false;
 	}
 
-	// Serialize DuplicateCounts
-	MemoryWriter << TableRef.DuplicateCounts;
+	Table = MoveTemp(ImportedTable);
+	TableChangeSerial++;
+
+	// The journal cannot express a replaced table, so fold the import into a new snapshot
+	if (TableJournal)
+	{
+		CompactTableJournal();
+	}
+	return true;
+}
 
-	FFileHelper::SaveArrayToFile(Bytes, *FullPath);
+bool ULearningDecisionTree::ExportTableCsv(FString FolderPath, FString FileName, FLearningDecisionTreeCsvStats& OutStats, bool bExpandDuplicates) const
+{
+	TCHAR Delimiter = FPaths::GetExtension(FileName).Equals(TEXT("tsv"), ESearchCase::IgnoreCase) ? TEXT('\t') : TEXT(',');
+	return FLearningDecisionTreeTableCsv::Export(FPaths::Combine(FolderPath, FileName), Table, &OutStats, Delimiter, bExpandDuplicates);
 }
 
-void ULearningDecisionTree::LoadTable(FString FolderPath, FString FileName)
+bool ULearningDecisionTree::EnableTableJournal(FString FolderPath, FString FileName)
 {
 	FString FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".dat"));
-	TArray<uint8> Bytes;
 
-	if (FFileHelper::LoadFileToArray(Bytes, *FullPath))
+	DisableTableJournal();
+	WaitForPendingIO();
+
+	// Table is exactly snapshot + journal on disk (LoadTable/SaveTable and nothing since): keep appending.
+	// Otherwise fold the in-memory table into a fresh snapshot first so nothing is lost.
+	bool bSynced = SyncedTablePath == FullPath && SyncedChangeSerial == TableChangeSerial;
+	if (!bSynced && !SaveTableFile(FullPath, ELearningDecisionTreeCompression::None))
 	{
-		FMemoryReader MemoryReader(Bytes, true);
+		UE_LOG(LogTemp, Error, TEXT("EnableTableJournal: Could not write the snapshot %s"), *FullPath);
+		return false;
+	}
 
-		Table.TableData.Empty();
-		Table.ColumnNames.Empty();
-		Table.DuplicateCounts.Empty();
-		Table.TotalRows = 0;
+	TableJournal = MakeUnique<FLearningDecisionTreeTableJournal>();
+	if (!TableJournal->Open(FPaths::ChangeExtension(FullPath, TEXT(".journal")), SyncedSnapshot))
+	{
+		UE_LOG(LogTemp, Error, TEXT("EnableTableJournal: Could not open the journal for %s"), *FullPath);
+		TableJournal.Reset();
+		return false;
+	}
+	JournalTablePath = FullPath;
+	return true;
+}
 
-		MemoryReader << Table.TotalRows;
+void ULearningDecisionTree::DisableTableJournal()
+{
+	if (TableJournal)
+	{
+		TableJournal->Close();
+		TableJournal.Reset();
+	}
+	JournalTablePath.Empty();
+}
 
-		// Deserialize ColumnNames
-		int32 NumColsInNames = 0;
-		MemoryReader << NumColsInNames;
-		for (int32 i = 0; i < NumColsInNames; i++)
-		{
-			FString NameStr;
-			MemoryReader << NameStr;
-			Table.ColumnNames.Add(FName(*NameStr));
-		}
+void ULearningDecisionTree::FlushTableJournal(bool bWait)
+{
+	if (TableJournal)
+	{
+		TableJournal->Flush(bWait);
+	}
+}
 
-		// Deserialize TableData
-		int32 NumColumns = 0;
-		MemoryReader << NumColumns;
-		for (int32 i = 0; i < NumColumns; i++)
-		{
-			FString KeyStr;
-			TArray<int32> Value;
-			MemoryReader << KeyStr;
-			MemoryReader << Value;
-			Table.TableData.Add(FName(*KeyStr), Value);
-		}
+bool ULearningDecisionTree::CompactTableJournal()
+{
+	// Saving to the journaled file starts the journal over for the new snapshot
+	return TableJournal && SaveTableFile(JournalTablePath, ELearningDecisionTreeCompression::None);
+}
 
-		// Deserialize DuplicateCounts
-		MemoryReader << Table.DuplicateCounts;
+void ULearningDecisionTree::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	// Nodes are subobjects and report themselves
+	FLearningDecisionTreeMemoryReport Report = GetMemoryReport();
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Report.TableBytes + Report.TransientBytes);
+	if (FlatTree.IsValid())
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(FlatTree->GetView().GetBytes().Num());
 	}
 }
 
-void ULearningDecisionTree::SaveDecisionTree(FString FolderPath, FString FileName)
+void ULearningDecisionTree::BeginDestroy()
 {
-	// Saving the UObject tree requires handling pointers and polymorphism.
+	// Let background writes finish so no file is left half written.
+	// Their results are dropped and their delegates are not called for a tree being destroyed.
+	IOPipe.WaitUntilEmpty();
+	PendingIO.Empty();
 
-	FString FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".tree"));
+	DisableTableJournal();
+	Super::BeginDestroy();
+}
 
-	TArray<uint8> Bytes;
-	FMemoryWriter MemoryWriter(Bytes, true);
+bool ULearningDecisionTree::SaveDecisionTree(FString FolderPath, FString FileName)
+{
+	WaitForPendingIO();
+
+	FLearningDecisionTreeIORequest Request;
+	Request.Kind = FLearningDecisionTreeIORequest::EKind::SaveTree;
+	Request.FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".tree"));
+	SerializeDecisionTree(Request.Bytes);
+	Request.Run();
+	ApplyIORequest(Request);
+	return Request.bSucceeded;
+}
+
+bool ULearningDecisionTree::LoadDecisionTree(FString FolderPath, FString FileName)
+{
+	WaitForPendingIO();
+
+	FLearningDecisionTreeIORequest Request;
+	Request.Kind = FLearningDecisionTreeIORequest::EKind::LoadTree;
+	Request.FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".tree"));
+	Request.TreeVersion = TreeVersion;
+	Request.Run();
+	ApplyIORequest(Request);
+	return Request.bSucceeded;
+}
+
+void ULearningDecisionTree::SaveDecisionTreeAsync(FString FolderPath, FString FileName, FOnLearningDecisionTreeIOComplete OnComplete)
+{
+	TSharedRef<FLearningDecisionTreeIORequest> Request = MakeShared<FLearningDecisionTreeIORequest>();
+	Request->Kind = FLearningDecisionTreeIORequest::EKind::SaveTree;
+	Request->FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".tree"));
+	Request->OnComplete = MoveTemp(OnComplete);
+
+	// Nodes are UObjects, so they are serialized here; only the file write runs in the background
+	SerializeDecisionTree(Request->Bytes);
+
+	LaunchIORequest(Request);
+}
+
+void ULearningDecisionTree::LoadDecisionTreeAsync(FString FolderPath, FString FileName, FOnLearningDecisionTreeIOComplete OnComplete)
+{
+	TSharedRef<FLearningDecisionTreeIORequest> Request = MakeShared<FLearningDecisionTreeIORequest>();
+	Request->Kind = FLearningDecisionTreeIORequest::EKind::LoadTree;
+	Request->FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".tree"));
+	Request->OnComplete = MoveTemp(OnComplete);
+	Request->TreeVersion = TreeVersion;
+
+	LaunchIORequest(Request);
+}
+
+void ULearningDecisionTree::SerializeDecisionTree(TArray<uint8>& OutBytes)
+{
+	// Its own stat: the file write of the save is counted under SaveDecisionTree
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_SerializeDecisionTree);
+
+	// Saving the UObject tree requires handling pointers and polymorphism.
+	FMemoryWriter MemoryWriter(OutBytes, true);
 
 	// Use a Proxy Archive to handle UProperties of the nodes
 	FObjectAndNameAsStringProxyArchive Ar(MemoryWriter, true);
 	Ar.ArIsSaveGame = false; // Serialize all properties
 
 	// Recursively serialize the tree starting from the root list
-	SerializeNodes(Ar, LDTRoot);
+	FLearningDecisionTreeWrittenNodes Written;
+	SerializeNodes(Ar, LDTRoot, Written);
+}
+
+bool ULearningDecisionTree::DeserializeDecisionTree(const TArray<uint8>& Bytes)
+{
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_DeserializeDecisionTree);
+
+	FMemoryReader MemoryReader(Bytes, true);
+	FObjectAndNameAsStringProxyArchive Ar(MemoryReader, true);
+	Ar.ArIsSaveGame = false;
+
+	// Deserialize recursively, reconstructing the UObject graph.
+	// The nodes go to a scratch list first so a damaged file leaves the current tree in place.
+	TArray<ULearningDecisionTreeNode*> LoadedRoot;
+	FLearningDecisionTreeReadNodes Read;
+	DeserializeNodes(Ar, LoadedRoot, this, Read);
+	if (Ar.IsError() || MemoryReader.IsError())
+	{
+		return false;
+	}
+
+	CancelDecisionTreeBuild();
+	LDTRoot = MoveTemp(LoadedRoot);
+	FlatTree.Reset();
+
+	// Trees saved before FeatureIndex existed only carry relative column indices
+	ResolveFeatureIndices();
+	BumpTreeVersion();
+	return true;
+}
+
+void ULearningDecisionTree::LaunchIORequest(const TSharedRef<FLearningDecisionTreeIORequest>& Request)
+{
+	PendingIO.Add(Request);
+
+	IOPipe.Launch(TEXT("LearningDecisionTreeIO"), [Request, WeakThis = TWeakObjectPtr<ULearningDecisionTree>(this)]()
+	{
+		Request->Run();
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+		{
+			if (ULearningDecisionTree* Tree = WeakThis.Get())
+			{
+				Tree->FinishPendingIO();
+			}
+		});
+	});
+}
+
+void ULearningDecisionTree::WaitForPendingIO()
+{
+	IOPipe.WaitUntilEmpty();
+	FinishPendingIO();
+}
+
+void ULearningDecisionTree::FinishPendingIO()
+{
+	// IOPipe runs requests in order, so the finished ones are always at the front.
+	// Each is removed before it is applied, since its delegate may start or wait for other requests.
+	while (PendingIO.Num() > 0 && PendingIO[0]->bDone)
+	{
+		TSharedRef<FLearningDecisionTreeIORequest> Request = PendingIO[0];
+		PendingIO.RemoveAt(0);
+		ApplyIORequest(*Request);
+	}
+}
+
+void ULearningDecisionTree::ApplyIORequest(FLearningDecisionTreeIORequest& Request)
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+	using EKind = FLearningDecisionTreeIORequest::EKind;
+
+	if (Request.bSucceeded)
+	{
+		switch (Request.Kind)
+		{
+		case EKind::SaveTable:
+			SyncedTablePath = Request.FullPath;
+			SyncedSnapshot = Request.Snapshot;
+			SyncedChangeSerial = Request.TableChangeSerial;
 
-	FFileHelper::SaveArrayToFile(Bytes, *FullPath);
+			// The new snapshot holds everything the journal had recorded when the table was taken.
+			// Records journaled while an async save was writing are kept on top of it.
+			if (TableJournal && JournalTablePath == Request.FullPath)
+			{
+				if (Request.JournalPosition >= 0)
+				{
+					TableJournal->Rebase(Request.Snapshot, Request.JournalPosition);
+				}
+				else
+				{
+					TableJournal->Reset(Request.Snapshot);
+				}
+			}
+			break;
+
+		case EKind::LoadTable:
+			// Table is replaced only now that the whole file has been validated
+			Table = MoveTemp(Request.CopiedTable);
+			TableChangeSerial++;
+			SyncedTablePath = Request.FullPath;
+			SyncedSnapshot = Request.Snapshot;
+			SyncedChangeSerial = TableChangeSerial;
+			break;
+
+		case EKind::SaveTree:
+			break;
+
+		case EKind::LoadTree:
+			if (TreeVersion != Request.TreeVersion)
+			{
+				Request.bSucceeded = false;
+				Request.Error = FString::Printf(TEXT("LoadDecisionTree: Discarded %s, the tree was replaced while it was loading"), *Request.FullPath);
+			}
+			else if (!DeserializeDecisionTree(Request.Bytes))
+			{
+				Request.bSucceeded = false;
+				Request.Error = FString::Printf(TEXT("LoadDecisionTree: %s is not a valid decision tree"), *Request.FullPath);
+			}
+			break;
+		}
+	}
+
+	if (!Request.bSucceeded)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s"), *Request.Error);
+	}
+	Request.OnComplete.ExecuteIfBound(Request.bSucceeded, Request.Error);
 }
 
-void ULearningDecisionTree::LoadDecisionTree(FString FolderPath, FString FileName)
+bool ULearningDecisionTree::SaveFlatDecisionTree(FString FolderPath, FString FileName)
 {
-	FString FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".tree"));
+	if (LDTRoot.Num() == 0 || !LDTRoot[0])
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveFlatDecisionTree: No decision tree to save."));
+		return false;
+	}
+
+	ResolveFeatureIndices();
+
 	TArray<uint8> Bytes;
+	FString FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".ftree"));
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_SaveDecisionTree);
+	if (!FLearningDecisionTreeFlatView::Build(LDTRoot[0], Bytes) || !FFileHelper::SaveArrayToFile(Bytes, *FullPath))
+	{
+		return false;
+	}
+	INC_DWORD_STAT_BY(STAT_LearningDecisionTree_BytesWritten, Bytes.Num());
+	return true;
+}
+
+bool ULearningDecisionTree::LoadFlatDecisionTree(FString FolderPath, FString FileName)
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
 
-	if (FFileHelper::LoadFileToArray(Bytes, *FullPath))
+	FString FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".ftree"));
+	TSharedPtr<FLearningDecisionTreeFlatModel> Model = FLearningDecisionTreeFlatModel::OpenFile(FullPath);
+	if (!Model.IsValid())
 	{
-		FMemoryReader MemoryReader(Bytes, true);
-		FObjectAndNameAsStringProxyArchive Ar(MemoryReader, true);
-		Ar.ArIsSaveGame = false;
+		UE_LOG(LogTemp, Error, TEXT("LoadFlatDecisionTree: Failed to open %s"), *FullPath);
+		return false;
+	}
+
+	CancelDecisionTreeBuild();
+	LDTRoot.Empty();
+	FlatTree = Model;
+	BumpTreeVersion();
+	return true;
+}
 
-		// Deserialize recursively, reconstructing the UObject graph
-		DeserializeNodes(Ar, LDTRoot, this);
+bool ULearningDecisionTree::LoadDecisionTreeFromAsset(const ULearningDecisionTreeModelAsset* Asset)
+{
+	if (!Asset || !Asset->HasModel())
+	{
+		UE_LOG(LogTemp, Error, TEXT("LoadDecisionTreeFromAsset: No model in %s"), Asset ? *Asset->GetPathName() : TEXT("null"));
+		return false;
 	}
+
+	CancelDecisionTreeBuild();
+	LDTRoot.Empty();
+	FlatTree = Asset->GetModel();
+	BumpTreeVersion();
+	return true;
 }
 
 // Helpers for manual polymorphic serialization of the node tree
 
-static void SerializeSingleNode(FArchive& Ar, ULearningDecisionTreeNode* Node);
-static ULearningDecisionTreeNode* DeserializeSingleNode(FArchive& Ar, UObject* Outer);
+static void SerializeSingleNode(FArchive& Ar, ULearningDecisionTreeNode* Node, FLearningDecisionTreeWrittenNodes& Written);
+static ULearningDecisionTreeNode* DeserializeSingleNode(FArchive& Ar, UObject* Outer, FLearningDecisionTreeReadNodes& Read);
 
-void SerializeNodes(FArchive& Ar, TArray<ULearningDecisionTreeNode*>& Nodes)
+static void SerializeNodes(FArchive& Ar, TArray<ULearningDecisionTreeNode*>& Nodes, FLearningDecisionTreeWrittenNodes& Written)
 {
 	int32 Num = Nodes.Num();
 	Ar << Num;
 	for (ULearningDecisionTreeNode* Node : Nodes)
 	{
-		SerializeSingleNode(Ar, Node);
+		SerializeSingleNode(Ar, Node, Written);
 	}
 }
 
-void DeserializeNodes(FArchive& Ar, TArray<ULearningDecisionTreeNode*>& Nodes, UObject* Outer)
+static void DeserializeNodes(FArchive& Ar, TArray<ULearningDecisionTreeNode*>& Nodes, UObject* Outer, FLearningDecisionTreeReadNodes& Read)
 {
 	Nodes.Empty();
 	int32 Num = 0;
 	Ar << Num;
-	for (int32 i = 0; i < Num; i++)
+	if (Num < 0)
+	{
+		Ar.SetError();
+		return;
+	}
+	for (int32 i = 0; i < Num && !Ar.IsError(); i++)
 	{
-		ULearningDecisionTreeNode* Node = DeserializeSingleNode(Ar, Outer);
+		ULearningDecisionTreeNode* Node = DeserializeSingleNode(Ar, Outer, Read);
 		if (Node)
 		{
 			Nodes.Add(Node);
@@ -238,10 +1672,10 @@ void DeserializeNodes(FArchive& Ar, TArray<ULearningDecisionTreeNode*>& Nodes, U
 	}
 }
 
-static void SerializeSingleNode(FArchive& Ar, ULearningDecisionTreeNode* Node)
+static void SerializeSingleNode(FArchive& Ar, ULearningDecisionTreeNode* Node, FLearningDecisionTreeWrittenNodes& Written)
 {
 	// Write a type identifier to handle polymorphism
-	// 0: Null, 1: TableNode, 2: DecisionNode, 3: ActionNode
+	// 0: Null, 1: TableNode, 2: DecisionNode, 3: ActionNode, 4: Reference to a node written before
 	uint8 NodeType = 0;
 	if (!Node)
 	{
@@ -249,6 +1683,15 @@ static void SerializeSingleNode(FArchive& Ar, ULearningDecisionTreeNode* Node)
 		return;
 	}
 
+	if (const int32* WrittenIndex = Written.Find(Node))
+	{
+		NodeType = 4;
+		int32 Index = *WrittenIndex;
+		Ar << NodeType;
+		Ar << Index;
+		return;
+	}
+
 	if (Node->IsA(ULearningDecisionTreeTableNode::StaticClass())) NodeType = 1;
 	else if (Node->IsA(ULearningDecisionTreeDecisionNode::StaticClass())) NodeType = 2;
 	else if (Node->IsA(ULearningDecisionTreeActionNode::StaticClass())) NodeType = 3;
@@ -262,16 +1705,31 @@ static void SerializeSingleNode(FArchive& Ar, ULearningDecisionTreeNode* Node)
 	if (NodeType == 2) // DecisionNode
 	{
 		ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node);
-		SerializeNodes(Ar, DNode->Nodes);
+		SerializeNodes(Ar, DNode->Nodes, Written);
 	}
 	// TableNodes and ActionNodes don't have persistent children structure to save
+
+	// Numbered once complete, so references can only point at finished nodes and never form a cycle
+	Written.Add(Node, Written.Num());
 }
 
-static ULearningDecisionTreeNode* DeserializeSingleNode(FArchive& Ar, UObject* Outer)
+static ULearningDecisionTreeNode* DeserializeSingleNode(FArchive& Ar, UObject* Outer, FLearningDecisionTreeReadNodes& Read)
 {
 	uint8 NodeType = 0;
 	Ar << NodeType;
 
+	if (NodeType == 4)
+	{
+		int32 Index = INDEX_NONE;
+		Ar << Index;
+		if (!Read.IsValidIndex(Index))
+		{
+			Ar.SetError();
+			return nullptr;
+		}
+		return Read[Index];
+	}
+
 	ULearningDecisionTreeNode* Node = nullptr;
 
 	// Instantiate the correct class based on type identifier
@@ -281,6 +1739,8 @@ static ULearningDecisionTreeNode* DeserializeSingleNode(FArchive& Ar, UObject* O
 
 	if (Node)
 	{
+		INC_DWORD_STAT(STAT_LearningDecisionTree_NodesCreated);
+
 		// Deserialize properties
 		Node->Serialize(Ar);
 
@@ -288,8 +1748,9 @@ static ULearningDecisionTreeNode* DeserializeSingleNode(FArchive& Ar, UObject* O
 		if (NodeType == 2)
 		{
 			ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node);
-			DeserializeNodes(Ar, DNode->Nodes, Outer);
+			DeserializeNodes(Ar, DNode->Nodes, Outer, Read);
 		}
+		Read.Add(Node);
 	}
 
 	return Node;
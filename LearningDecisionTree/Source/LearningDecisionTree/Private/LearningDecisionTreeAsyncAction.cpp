@@ -0,0 +1,76 @@
+#include "LearningDecisionTreeAsyncAction.h"
+#include "LearningDecisionTree.h"
+
+ULearningDecisionTreeAsyncAction* ULearningDecisionTreeAsyncAction::SaveTableAsync(UObject* WorldContextObject, ULearningDecisionTree* Tree, FString FolderPath, FString FileName, ELearningDecisionTreeCompression Compression)
+{
+	ULearningDecisionTreeAsyncAction* Action = Create(WorldContextObject, Tree, EOperation::SaveTable, FolderPath, FileName);
+	Action->Compression = Compression;
+	return Action;
+}
+
+ULearningDecisionTreeAsyncAction* ULearningDecisionTreeAsyncAction::LoadTableAsync(UObject* WorldContextObject, ULearningDecisionTree* Tree, FString FolderPath, FString FileName)
+{
+	return Create(WorldContextObject, Tree, EOperation::LoadTable, FolderPath, FileName);
+}
+
+ULearningDecisionTreeAsyncAction* ULearningDecisionTreeAsyncAction::SaveDecisionTreeAsync(UObject* WorldContextObject, ULearningDecisionTree* Tree, FString FolderPath, FString FileName)
+{
+	return Create(WorldContextObject, Tree, EOperation::SaveTree, FolderPath, FileName);
+}
+
+ULearningDecisionTreeAsyncAction* ULearningDecisionTreeAsyncAction::LoadDecisionTreeAsync(UObject* WorldContextObject, ULearningDecisionTree* Tree, FString FolderPath, FString FileName)
+{
+	return Create(WorldContextObject, Tree, EOperation::LoadTree, FolderPath, FileName);
+}
+
+ULearningDecisionTreeAsyncAction* ULearningDecisionTreeAsyncAction::Create(UObject* WorldContextObject, ULearningDecisionTree* InTree, EOperation InOperation, const FString& InFolderPath, const FString& InFileName)
+{
+	ULearningDecisionTreeAsyncAction* Action = NewObject<ULearningDecisionTreeAsyncAction>();
+	Action->Tree = InTree;
+	Action->Operation = InOperation;
+	Action->FolderPath = InFolderPath;
+	Action->FileName = InFileName;
+
+	// Keeps the action alive until SetReadyToDestroy()
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void ULearningDecisionTreeAsyncAction::Activate()
+{
+	if (!Tree)
+	{
+		HandleComplete(false, TEXT("No LearningDecisionTree given"));
+		return;
+	}
+
+	FOnLearningDecisionTreeIOComplete OnComplete = FOnLearningDecisionTreeIOComplete::CreateUObject(this, &ULearningDecisionTreeAsyncAction::HandleComplete);
+	switch (Operation)
+	{
+	case EOperation::SaveTable:
+		Tree->SaveTableAsync(FolderPath, FileName, Compression, OnComplete);
+		break;
+	case EOperation::LoadTable:
+		Tree->LoadTableAsync(FolderPath, FileName, OnComplete);
+		break;
+	case EOperation::SaveTree:
+		Tree->SaveDecisionTreeAsync(FolderPath, FileName, OnComplete);
+		break;
+	case EOperation::LoadTree:
+		Tree->LoadDecisionTreeAsync(FolderPath, FileName, OnComplete);
+		break;
+	}
+}
+
+void ULearningDecisionTreeAsyncAction::HandleComplete(bool bSucceeded, const FString& Error)
+{
+	if (bSucceeded)
+	{
+		OnSucceeded.Broadcast(Error);
+	}
+	else
+	{
+		OnFailed.Broadcast(Error);
+	}
+	SetReadyToDestroy();
+}
@@ -0,0 +1,195 @@
+#include "LearningDecisionTreeBenchmark.h"
+#include "LearningDecisionTree.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/EngineVersion.h"
+#include "UObject/GCObjectScopeGuard.h"
+#include "UObject/Package.h"
+#include "HAL/PlatformMemory.h"
+
+namespace
+{
+	/** Every benchmark Run() measures, in order. */
+	const TCHAR* const BenchmarkCases[] =
+	{
+		TEXT("AddRow"),
+		TEXT("CreateDecisionTree"),
+		TEXT("Eval"),
+		TEXT("EvalWithContext"),
+		TEXT("EvalRow"),
+		TEXT("SaveTable"),
+		TEXT("LoadTable"),
+		TEXT("SaveDecisionTree"),
+		TEXT("LoadDecisionTree"),
+	};
+
+	/** Runs Body once and records how long it took for Operations calls. */
+	template <typename FunctionType>
+	void Measure(TArray<FLearningDecisionTreeBenchmarkResult>& Results, const TCHAR* Name, int64 Operations, FunctionType&& Body)
+	{
+		double StartTime = FPlatformTime::Seconds();
+		Body();
+		double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		FLearningDecisionTreeBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+		Result.Name = Name;
+		Result.Operations = Operations;
+		Result.Milliseconds = Seconds * 1000.0;
+		Result.OpsPerSecond = Seconds > 0.0 ? Operations / Seconds : 0.0;
+		Result.PeakMemoryMB = FPlatformMemory::GetStats().PeakUsedPhysical / (1024.0 * 1024.0);
+
+		UE_LOG(LogTemp, Display, TEXT("LearningDecisionTree benchmark: %-20s %10lld ops %12.3f ms %14.1f ops/s %10.1f MB process peak"),
+			Name, Operations, Result.Milliseconds, Result.OpsPerSecond, Result.PeakMemoryMB);
+	}
+}
+
+TArray<FLearningDecisionTreeBenchmarkResult> FLearningDecisionTreeBenchmark::Run(const FLearningDecisionTreeBenchmarkSettings& Settings)
+{
+	check(IsInGameThread());
+
+	const FLearningDecisionTreeSyntheticSpec& Spec = Settings.Spec;
+	const int32 Width = Spec.NumFeatures + 1;
+	const FString FileName = TEXT("LearningDecisionTreeBenchmark");
+
+	TArray<int32> Rows;
+	FLearningDecisionTreeSyntheticData::Generate(Spec, Rows);
+
+	ULearningDecisionTree* Tree = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard TreeGuard(Tree);
+	for (const FName& ColumnName : FLearningDecisionTreeSyntheticData::MakeColumnNames(Spec))
+	{
+		Tree->AddColumn(ColumnName);
+	}
+
+	TArray<FLearningDecisionTreeBenchmarkResult> Results;
+
+	Measure(Results, TEXT("AddRow"), Spec.NumRows, [&]()
+	{
+		TArray<int32> Row;
+		for (int32 RowIndex = 0; RowIndex < Spec.NumRows; RowIndex++)
+		{
+			Row.Reset();
+			Row.Append(Rows.GetData() + RowIndex * Width, Width);
+			Tree->AddRow(Row);
+		}
+	});
+
+	Measure(Results, TEXT("CreateDecisionTree"), 1, [&]()
+	{
+		Tree->CreateDecisionTree();
+	});
+
+	// Feature rows to evaluate, cycling through the training rows
+	const int32 NumEvals = FMath::Max(1, Settings.NumEvals);
+	const int32 NumEvalRows = FMath::Min(FMath::Max(1, Spec.NumRows), NumEvals);
+	TArray<TArray<int32>> EvalRows;
+	EvalRows.SetNum(NumEvalRows);
+	for (int32 RowIndex = 0; RowIndex < NumEvalRows; RowIndex++)
+	{
+		EvalRows[RowIndex] = Spec.NumRows > 0
+			? TArray<int32>(Rows.GetData() + RowIndex * Width, Spec.NumFeatures)
+			: TArray<int32>();
+		EvalRows[RowIndex].SetNumZeroed(Spec.NumFeatures);
+	}
+
+	int64 Checksum = 0;
+
+	Measure(Results, TEXT("Eval"), NumEvals, [&]()
+	{
+		for (int32 Eval = 0; Eval < NumEvals; Eval++)
+		{
+			Tree->RefreshStates(EvalRows[Eval % NumEvalRows]);
+			Checksum += Tree->Eval();
+		}
+	});
+
+	Measure(Results, TEXT("EvalWithContext"), NumEvals, [&]()
+	{
+		FLearningDecisionTreeEvalContext Context(Spec.Seed);
+		for (int32 Eval = 0; Eval < NumEvals; Eval++)
+		{
+			Context.SetStates(EvalRows[Eval % NumEvalRows]);
+			Checksum += Tree->EvalWithContext(Context);
+		}
+	});
+
+	Measure(Results, TEXT("EvalRow"), NumEvals, [&]()
+	{
+		FRandomStream RandomStream(Spec.Seed);
+		for (int32 Eval = 0; Eval < NumEvals; Eval++)
+		{
+			Checksum += Tree->EvalRow(EvalRows[Eval % NumEvalRows], RandomStream);
+		}
+	});
+
+	// Keeps the evaluations from being optimized away
+	UE_LOG(LogTemp, Verbose, TEXT("LearningDecisionTree benchmark: eval checksum %lld"), Checksum);
+
+	Measure(Results, TEXT("SaveTable"), 1, [&]()
+	{
+		Tree->SaveTable(Settings.WorkingFolder, FileName);
+	});
+
+	Measure(Results, TEXT("LoadTable"), 1, [&]()
+	{
+		Tree->LoadTable(Settings.WorkingFolder, FileName);
+	});
+
+	Measure(Results, TEXT("SaveDecisionTree"), 1, [&]()
+	{
+		Tree->SaveDecisionTree(Settings.WorkingFolder, FileName);
+	});
+
+	Measure(Results, TEXT("LoadDecisionTree"), 1, [&]()
+	{
+		Tree->LoadDecisionTree(Settings.WorkingFolder, FileName);
+	});
+
+	ensureMsgf(Results.Num() == UE_ARRAY_COUNT(BenchmarkCases), TEXT("Add new benchmarks to BenchmarkCases"));
+	return Results;
+}
+
+TConstArrayView<const TCHAR*> FLearningDecisionTreeBenchmark::GetCaseNames()
+{
+	return BenchmarkCases;
+}
+
+FString FLearningDecisionTreeBenchmark::ToJson(const FLearningDecisionTreeBenchmarkSettings& Settings, const TArray<FLearningDecisionTreeBenchmarkResult>& Results)
+{
+	const FLearningDecisionTreeSyntheticSpec& Spec = Settings.Spec;
+
+	TSharedRef<FJsonObject> SpecObject = MakeShared<FJsonObject>();
+	SpecObject->SetNumberField(TEXT("Rows"), Spec.NumRows);
+	SpecObject->SetNumberField(TEXT("Features"), Spec.NumFeatures);
+	SpecObject->SetNumberField(TEXT("Cardinality"), Spec.Cardinality);
+	SpecObject->SetNumberField(TEXT("Actions"), Spec.NumActions);
+	SpecObject->SetNumberField(TEXT("InformativeFeatures"), Spec.NumInformativeFeatures);
+	SpecObject->SetNumberField(TEXT("LabelNoise"), Spec.LabelNoise);
+	SpecObject->SetNumberField(TEXT("Seed"), Spec.Seed);
+	SpecObject->SetNumberField(TEXT("Evals"), Settings.NumEvals);
+
+	TArray<TSharedPtr<FJsonValue>> ResultValues;
+	for (const FLearningDecisionTreeBenchmarkResult& Result : Results)
+	{
+		TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+		ResultObject->SetStringField(TEXT("Name"), Result.Name);
+		ResultObject->SetNumberField(TEXT("Operations"), (double)Result.Operations);
+		ResultObject->SetNumberField(TEXT("Milliseconds"), Result.Milliseconds);
+		ResultObject->SetNumberField(TEXT("OpsPerSecond"), Result.OpsPerSecond);
+		ResultObject->SetNumberField(TEXT("PeakMemoryMB"), Result.PeakMemoryMB);
+		ResultValues.Add(MakeShared<FJsonValueObject>(ResultObject));
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("EngineVersion"), FEngineVersion::Current().ToString());
+	Root->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	Root->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+	Root->SetObjectField(TEXT("Spec"), SpecObject);
+	Root->SetArrayField(TEXT("Results"), ResultValues);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+	return Json;
+}
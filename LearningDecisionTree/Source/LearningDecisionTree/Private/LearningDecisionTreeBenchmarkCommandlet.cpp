@@ -0,0 +1,46 @@
+#include "LearningDecisionTreeBenchmarkCommandlet.h"
+#include "LearningDecisionTreeBenchmark.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+ULearningDecisionTreeBenchmarkCommandlet::ULearningDecisionTreeBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 ULearningDecisionTreeBenchmarkCommandlet::Main(const FString& Params)
+{
+	FLearningDecisionTreeBenchmarkSettings Settings;
+	FLearningDecisionTreeSyntheticSpec& Spec = Settings.Spec;
+	FParse::Value(*Params, TEXT("Rows="), Spec.NumRows);
+	FParse::Value(*Params, TEXT("Features="), Spec.NumFeatures);
+	FParse::Value(*Params, TEXT("Cardinality="), Spec.Cardinality);
+	FParse::Value(*Params, TEXT("Actions="), Spec.NumActions);
+	FParse::Value(*Params, TEXT("Informative="), Spec.NumInformativeFeatures);
+	FParse::Value(*Params, TEXT("Noise="), Spec.LabelNoise);
+	FParse::Value(*Params, TEXT("Seed="), Spec.Seed);
+	FParse::Value(*Params, TEXT("Evals="), Settings.NumEvals);
+
+	if (Spec.NumRows < 0 || Spec.NumFeatures < 1 || Spec.Cardinality < 1 || Spec.NumActions < 1)
+	{
+		UE_LOG(LogTemp, Error, TEXT("LearningDecisionTreeBenchmark: invalid parameters '%s'"), *Params);
+		return 1;
+	}
+
+	FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LearningDecisionTree"), TEXT("Benchmark.json"));
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	Settings.WorkingFolder = FPaths::GetPath(OutputPath);
+
+	TArray<FLearningDecisionTreeBenchmarkResult> Results = FLearningDecisionTreeBenchmark::Run(Settings);
+	if (!FFileHelper::SaveStringToFile(FLearningDecisionTreeBenchmark::ToJson(Settings, Results), *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("LearningDecisionTreeBenchmark: could not write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("LearningDecisionTreeBenchmark: results written to %s"), *OutputPath);
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include "LearningDecisionTreeCoreAdapter.h"
+#include "LearningDecisionTreeFlat.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "LearningDecisionTreeCore/Builder.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace LearningDecisionTreeCoreAdapter
+{
+	void ToCoreTable(const FLearningDecisionTreeTable& Table, LearningDecisionTreeCore::FTable& OutTable)
+	{
+		OutTable.Reset();
+		OutTable.ColumnNames.reserve(Table.ColumnNames.Num());
+		OutTable.Columns.reserve(Table.ColumnNames.Num());
+		for (const FName& Name : Table.ColumnNames)
+		{
+			OutTable.ColumnNames.emplace_back(TCHAR_TO_UTF8(*Name.ToString()));
+
+			// A column missing from TableData stays empty, which the core reports as inconsistent
+			std::vector<int32_t>& Column = OutTable.Columns.emplace_back();
+			if (const TArray<int32>* Data = Table.TableData.Find(Name))
+			{
+				Column.assign(Data->GetData(), Data->GetData() + Data->Num());
+			}
+		}
+		OutTable.DuplicateCounts.assign(Table.DuplicateCounts.GetData(), Table.DuplicateCounts.GetData() + Table.DuplicateCounts.Num());
+		OutTable.TotalRows = Table.TotalRows;
+	}
+
+	bool FromCoreTable(const LearningDecisionTreeCore::FTable& Table, FLearningDecisionTreeTable& OutTable)
+	{
+		if (!Table.IsConsistent())
+		{
+			return false;
+		}
+
+		FLearningDecisionTreeTable NewTable;
+		for (size_t Column = 0; Column < Table.Columns.size(); Column++)
+		{
+			FName Name(UTF8_TO_TCHAR(Table.ColumnNames[Column].c_str()));
+			if (!NewTable.AddColumn(Name))
+			{
+				UE_LOG(LogTemp, Error, TEXT("FromCoreTable: Column %s appears twice"), *Name.ToString());
+				return false;
+			}
+			NewTable.TableData[Name].Append(Table.Columns[Column].data(), (int32)Table.Columns[Column].size());
+		}
+		NewTable.DuplicateCounts.Append(Table.DuplicateCounts.data(), (int32)Table.DuplicateCounts.size());
+		NewTable.TotalRows = Table.TotalRows;
+
+		OutTable = MoveTemp(NewTable);
+		return true;
+	}
+
+	TSharedPtr<FLearningDecisionTreeFlatModel> BuildFlatModel(const FLearningDecisionTreeTable& Table, LearningDecisionTreeCore::EBuildMode Mode)
+	{
+		LearningDecisionTreeCore::FTable CoreTable;
+		ToCoreTable(Table, CoreTable);
+
+		std::vector<uint8_t> Bytes;
+		if (!LearningDecisionTreeCore::BuildFlatTree(CoreTable, Bytes, nullptr, Mode))
+		{
+			return nullptr;
+		}
+		return FLearningDecisionTreeFlatModel::FromBytes(TArray<uint8>(Bytes.data(), (int32)Bytes.size()));
+	}
+}
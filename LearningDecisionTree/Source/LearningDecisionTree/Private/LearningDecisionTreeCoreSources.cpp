@@ -0,0 +1,11 @@
+#include "CoreMinimal.h"
+
+// The engine-independent core is compiled into this module from the same sources its CMake build uses.
+// The plugin's flat tree view and table file reader and writer wrap it, so the offline tools share their code;
+// only the UObject node builder is the plugin's own, and is tested to produce the core builder's trees.
+THIRD_PARTY_INCLUDES_START
+#include "../../ThirdParty/LearningDecisionTreeCore/Source/Builder.cpp"
+#include "../../ThirdParty/LearningDecisionTreeCore/Source/Flat.cpp"
+#include "../../ThirdParty/LearningDecisionTreeCore/Source/Table.cpp"
+#include "../../ThirdParty/LearningDecisionTreeCore/Source/TableFile.cpp"
+THIRD_PARTY_INCLUDES_END
@@ -0,0 +1,144 @@
+#include "LearningDecisionTreeDiscretizer.h"
+#include "Math/VectorRegister.h"
+
+void FLearningDecisionTreeDiscretizer::SetEdges(int32 Column, TArray<float> Edges)
+{
+	if (Column < 0)
+	{
+		return;
+	}
+	if (Column >= Columns.Num())
+	{
+		Columns.SetNum(Column + 1);
+	}
+
+	Edges.RemoveAll([](float Edge) { return FMath::IsNaN(Edge); });
+	Edges.Sort();
+	for (int32 Index = Edges.Num() - 1; Index > 0; Index--)
+	{
+		if (Edges[Index] == Edges[Index - 1])
+		{
+			Edges.RemoveAt(Index);
+		}
+	}
+	Columns[Column].Edges = MoveTemp(Edges);
+}
+
+void FLearningDecisionTreeDiscretizer::FitQuantiles(TArrayView<const float> Samples, int32 NumRows, int32 NumBins)
+{
+	if (NumRows <= 0 || NumBins < 1 || Samples.Num() % NumRows != 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Discretizer: %d samples do not form %d rows"), Samples.Num(), NumRows);
+		return;
+	}
+
+	int32 NumFeatures = Samples.Num() / NumRows;
+	Columns.SetNum(NumFeatures);
+
+	TArray<float> Sorted;
+	for (int32 Column = 0; Column < NumFeatures; Column++)
+	{
+		Sorted.Reset();
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			float Value = Samples[Row * NumFeatures + Column];
+			if (!FMath::IsNaN(Value))
+			{
+				Sorted.Add(Value);
+			}
+		}
+		Sorted.Sort();
+
+		TArray<float>& Edges = Columns[Column].Edges;
+		Edges.Reset();
+		for (int32 Bin = 1; Bin < NumBins && Sorted.Num() > 0; Bin++)
+		{
+			float Edge = Sorted[(int32)((int64)Bin * Sorted.Num() / NumBins)];
+
+			// Heavily repeated values would give empty bins; keep one edge per distinct value
+			if ((Edges.Num() == 0 || Edge > Edges.Last()) && Edge > Sorted[0])
+			{
+				Edges.Add(Edge);
+			}
+		}
+	}
+}
+
+int32 FLearningDecisionTreeDiscretizer::Discretize(int32 Column, float Value) const
+{
+	if (!Columns.IsValidIndex(Column) || Columns[Column].Edges.Num() == 0)
+	{
+		return FMath::FloorToInt(Value);
+	}
+
+	// Branchless count of the edges at or below Value
+	int32 State = 0;
+	for (float Edge : Columns[Column].Edges)
+	{
+		State += Value >= Edge ? 1 : 0;
+	}
+	return State;
+}
+
+void FLearningDecisionTreeDiscretizer::DiscretizeRow(TArrayView<const float> Values, TArrayView<int32> OutStates) const
+{
+	check(OutStates.Num() >= Values.Num());
+	for (int32 Column = 0; Column < Values.Num(); Column++)
+	{
+		OutStates[Column] = Discretize(Column, Values[Column]);
+	}
+}
+
+void FLearningDecisionTreeDiscretizer::DiscretizeBatch(TArrayView<const float> Values, int32 NumRows, TArrayView<int32> OutStates) const
+{
+	// Rows may be narrower or wider than the fitted columns, as in DiscretizeRow(): unfitted columns pass through
+	const int32 NumFeatures = NumRows > 0 ? Values.Num() / NumRows : 0;
+	if (NumFeatures == 0 || Values.Num() != NumRows * NumFeatures || OutStates.Num() < Values.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Discretizer: Batch of %d values does not hold %d rows of equal length"), Values.Num(), NumRows);
+		return;
+	}
+
+	// Work on one column at a time, gathered into a contiguous array padded to the vector width
+	const int32 PaddedRows = Align(NumRows, 4);
+	TArray<float, TInlineAllocator<256>> ColumnValues;
+	TArray<float, TInlineAllocator<256>> Counts;
+	ColumnValues.SetNumZeroed(PaddedRows);
+	Counts.SetNumUninitialized(PaddedRows);
+
+	const TArray<float> NoEdges;
+	for (int32 Column = 0; Column < NumFeatures; Column++)
+	{
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			ColumnValues[Row] = Values[Row * NumFeatures + Column];
+		}
+
+		const TArray<float>& Edges = Columns.IsValidIndex(Column) ? Columns[Column].Edges : NoEdges;
+		if (Edges.Num() == 0)
+		{
+			for (int32 Row = 0; Row < NumRows; Row++)
+			{
+				OutStates[Row * NumFeatures + Column] = FMath::FloorToInt(ColumnValues[Row]);
+			}
+			continue;
+		}
+
+		// Counts += (Value >= Edge) for four rows per step; the compare mask selects 1.0 or 0.0
+		FMemory::Memzero(Counts.GetData(), PaddedRows * sizeof(float));
+		for (float Edge : Edges)
+		{
+			const VectorRegister4Float EdgeVector = VectorSetFloat1(Edge);
+			for (int32 Row = 0; Row < PaddedRows; Row += 4)
+			{
+				VectorRegister4Float Above = VectorBitwiseAnd(VectorCompareGE(VectorLoad(&ColumnValues[Row]), EdgeVector), GlobalVectorConstants::FloatOne);
+				VectorStore(VectorAdd(VectorLoad(&Counts[Row]), Above), &Counts[Row]);
+			}
+		}
+
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			OutStates[Row * NumFeatures + Column] = (int32)Counts[Row];
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#include "LearningDecisionTreeEvalContext.h"
+#include <atomic>
+
+FLearningDecisionTreeEvalContext::FLearningDecisionTreeEvalContext()
+{
+	RandomStream.GenerateNewSeed();
+}
+
+FLearningDecisionTreeEvalContext::FLearningDecisionTreeEvalContext(int32 Seed)
+	: RandomStream(Seed)
+{
+}
+
+void FLearningDecisionTreeEvalContext::SetState(int32 FeatureIndex, int32 Value)
+{
+	if (FeatureIndex < 0)
+	{
+		return;
+	}
+
+	if (FeatureIndex >= States.Num())
+	{
+		// A longer row can change which branches are reachable
+		States.SetNumZeroed(FeatureIndex + 1);
+		Invalidate();
+	}
+	else if (States[FeatureIndex] != Value && PathFeatures.Contains(FeatureIndex))
+	{
+		Invalidate();
+	}
+
+	States[FeatureIndex] = Value;
+}
+
+void FLearningDecisionTreeEvalContext::SetStates(TArrayView<const int32> Row)
+{
+	if (Row.Num() != States.Num())
+	{
+		States.Reset();
+		States.Append(Row.GetData(), Row.Num());
+		Invalidate();
+		return;
+	}
+
+	if (CachedTreeVersion != 0)
+	{
+		for (int32 Feature : PathFeatures)
+		{
+			if (States[Feature] != Row[Feature])
+			{
+				Invalidate();
+				break;
+			}
+		}
+	}
+
+	FMemory::Memcpy(States.GetData(), Row.GetData(), Row.Num() * sizeof(int32));
+}
+
+void FLearningDecisionTreeEvalContext::Invalidate()
+{
+	CachedLeaf = nullptr;
+	CachedFlatLeaf = INDEX_NONE;
+	CachedMostLikelyAction = -1;
+	PathFeatures.Reset();
+	CachedTreeVersion = 0;
+}
+
+void FLearningDecisionTreeEvalContext::ResetCounters()
+{
+	CacheHits = 0;
+	CacheMisses = 0;
+}
+
+uint32 FLearningDecisionTreeEvalContext::AllocateTreeVersion()
+{
+	static std::atomic<uint32> NextTreeVersion(1);
+	return NextTreeVersion.fetch_add(1);
+}
@@ -0,0 +1,184 @@
+#include "LearningDecisionTree.h"
+#include "LearningDecisionTreeNode.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_EDITOR
+
+// ============================================================================
+// C++ Export
+// ============================================================================
+
+namespace LearningDecisionTreeExport
+{
+	/** Flattened leaf distributions, written out as constexpr tables. */
+	struct FLeafTables
+	{
+		TArray<int32> Offsets;
+		TArray<int32> Actions;
+		TArray<uint32> CumulativeCounts;
+		TArray<int32> MostLikelyActions;
+		int32 NumFeatures = 0;
+	};
+
+	static FString Indent(int32 Depth)
+	{
+		return FString::ChrN(Depth, TEXT('\t'));
+	}
+
+	static int32 AddLeaf(FLeafTables& Tables, const ULearningDecisionTreeActionNode* ActionNode)
+	{
+		int32 LeafIndex = Tables.Offsets.Num();
+		Tables.Offsets.Add(Tables.Actions.Num());
+
+		uint32 Cumulative = 0;
+		int32 BestCount = -1;
+		int32 BestAction = -1;
+		int32 NumActions = FMath::Min(ActionNode->ActionNames.Num(), ActionNode->ActionCounts.Num());
+		for (int32 i = 0; i < NumActions; i++)
+		{
+			int32 Count = ActionNode->ActionCounts[i];
+			Cumulative += (uint32)FMath::Max(Count, 0);
+			Tables.Actions.Add(ActionNode->ActionNames[i]);
+			Tables.CumulativeCounts.Add(Cumulative);
+
+			if (Count > BestCount)
+			{
+				BestCount = Count;
+				BestAction = ActionNode->ActionNames[i];
+			}
+		}
+		Tables.MostLikelyActions.Add(BestAction);
+		return LeafIndex;
+	}
+
+	/** Writes the statement(s) that return the leaf index reached from Node. */
+	static void WriteNode(FString& Out, FLeafTables& Tables, const ULearningDecisionTreeNode* Node, int32 Depth)
+	{
+		if (const ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node))
+		{
+			Tables.NumFeatures = FMath::Max(Tables.NumFeatures, DNode->FeatureIndex + 1);
+
+			Out += Indent(Depth) + FString::Printf(TEXT("switch (Features[%d])\n"), DNode->FeatureIndex);
+			Out += Indent(Depth) + TEXT("{\n");
+			int32 NumBranches = FMath::Min(DNode->ColumnStates.Num(), DNode->Nodes.Num());
+			for (int32 i = 0; i < NumBranches; i++)
+			{
+				Out += Indent(Depth) + FString::Printf(TEXT("case %d:\n"), DNode->ColumnStates[i]);
+				Out += Indent(Depth) + TEXT("{\n");
+				WriteNode(Out, Tables, DNode->Nodes[i], Depth + 1);
+				Out += Indent(Depth) + TEXT("}\n");
+			}
+			Out += Indent(Depth) + TEXT("default:\n");
+			Out += Indent(Depth + 1) + TEXT("return -1;\n");
+			Out += Indent(Depth) + TEXT("}\n");
+		}
+		else if (const ULearningDecisionTreeActionNode* ActionNode = Cast<ULearningDecisionTreeActionNode>(Node))
+		{
+			Out += Indent(Depth) + FString::Printf(TEXT("return %d;\n"), AddLeaf(Tables, ActionNode));
+		}
+		else
+		{
+			// Null or unfinished TableNode: nothing to predict on this branch
+			Out += Indent(Depth) + TEXT("return -1;\n");
+		}
+	}
+
+	template <typename T>
+	static FString JoinTable(const TArray<T>& Values)
+	{
+		FString Result;
+		for (int32 i = 0; i < Values.Num(); i++)
+		{
+			if (i > 0)
+			{
+				Result += (i % 16 == 0) ? TEXT(",\n\t\t") : TEXT(", ");
+			}
+			Result += LexToString(Values[i]);
+		}
+		// Zero-sized constexpr arrays are ill-formed
+		return Values.Num() > 0 ? Result : FString(TEXT("0"));
+	}
+}
+
+bool ULearningDecisionTree::ExportDecisionTreeToCpp(FString FolderPath, FString FileName, FString Namespace)
+{
+	using namespace LearningDecisionTreeExport;
+
+	if (LDTRoot.Num() == 0 || !LDTRoot[0])
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ExportDecisionTreeToCpp: No decision tree to export."));
+		return false;
+	}
+
+	if (Namespace.IsEmpty())
+	{
+		Namespace = TEXT("LearningDecisionTreeModel");
+	}
+
+	// Make sure FeatureIndex is valid even on trees assembled by hand
+	ResolveFeatureIndices();
+
+	FLeafTables Tables;
+	Tables.NumFeatures = FMath::Max(Table.ColumnNames.Num() - 1, 0);
+
+	FString FindLeafBody;
+	WriteNode(FindLeafBody, Tables, LDTRoot[0], 2);
+	Tables.Offsets.Add(Tables.Actions.Num());
+
+	FString Out;
+	Out += TEXT("// Generated by ULearningDecisionTree::ExportDecisionTreeToCpp. Do not edit by hand.\n");
+	Out += TEXT("#pragma once\n\n");
+	Out += TEXT("#include <cstdint>\n\n");
+	Out += FString::Printf(TEXT("namespace %s\n{\n"), *Namespace);
+
+	Out += TEXT("\t/** Number of feature values expected in a row (the Action column is not included). */\n");
+	Out += FString::Printf(TEXT("\tconstexpr int32_t NumFeatures = %d;\n\n"), Tables.NumFeatures);
+	Out += TEXT("\t/** Number of leaves (ActionNodes) in the model. */\n");
+	Out += FString::Printf(TEXT("\tconstexpr int32_t NumLeaves = %d;\n\n"), Tables.MostLikelyActions.Num());
+
+	Out += TEXT("\t/** Leaf L owns entries [LeafOffsets[L], LeafOffsets[L + 1]) of LeafActions and LeafCumulativeCounts. */\n");
+	Out += FString::Printf(TEXT("\tconstexpr int32_t LeafOffsets[] = {\n\t\t%s };\n\n"), *JoinTable(Tables.Offsets));
+	Out += FString::Printf(TEXT("\tconstexpr int32_t LeafActions[] = {\n\t\t%s };\n\n"), *JoinTable(Tables.Actions));
+	Out += FString::Printf(TEXT("\tconstexpr uint32_t LeafCumulativeCounts[] = {\n\t\t%s };\n\n"), *JoinTable(Tables.CumulativeCounts));
+	Out += TEXT("\t/** The action with the highest count in each leaf. */\n");
+	Out += FString::Printf(TEXT("\tconstexpr int32_t LeafMostLikelyActions[] = {\n\t\t%s };\n\n"), *JoinTable(Tables.MostLikelyActions));
+
+	Out += TEXT("\t/** Returns the leaf reached by Features, or -1 if a feature value was never seen during training. */\n");
+	Out += TEXT("\tinline int32_t FindLeaf(const int32_t* Features)\n\t{\n");
+	Out += FindLeafBody;
+	Out += TEXT("\t}\n\n");
+
+	Out += TEXT("\t/**\n");
+	Out += TEXT("\t * Samples an action from the leaf reached by Features, weighted by the training counts.\n");
+	Out += TEXT("\t * Random is any uniformly distributed 32-bit value. Returns -1 if no action is found.\n");
+	Out += TEXT("\t */\n");
+	Out += TEXT("\tinline int32_t Eval(const int32_t* Features, uint32_t Random)\n\t{\n");
+	Out += TEXT("\t\tconst int32_t Leaf = FindLeaf(Features);\n");
+	Out += TEXT("\t\tif (Leaf < 0)\n\t\t{\n\t\t\treturn -1;\n\t\t}\n\n");
+	Out += TEXT("\t\tconst int32_t Begin = LeafOffsets[Leaf];\n");
+	Out += TEXT("\t\tconst int32_t End = LeafOffsets[Leaf + 1];\n");
+	Out += TEXT("\t\tif (Begin == End || LeafCumulativeCounts[End - 1] == 0)\n\t\t{\n\t\t\treturn -1;\n\t\t}\n\n");
+	Out += TEXT("\t\tconst uint32_t Pick = Random % LeafCumulativeCounts[End - 1];\n");
+	Out += TEXT("\t\tfor (int32_t i = Begin; i < End - 1; ++i)\n\t\t{\n");
+	Out += TEXT("\t\t\tif (Pick < LeafCumulativeCounts[i])\n\t\t\t{\n\t\t\t\treturn LeafActions[i];\n\t\t\t}\n\t\t}\n");
+	Out += TEXT("\t\treturn LeafActions[End - 1];\n");
+	Out += TEXT("\t}\n\n");
+
+	Out += TEXT("\t/** Returns the most likely action for Features, or -1 if no action is found. */\n");
+	Out += TEXT("\tinline int32_t EvalMostLikely(const int32_t* Features)\n\t{\n");
+	Out += TEXT("\t\tconst int32_t Leaf = FindLeaf(Features);\n");
+	Out += TEXT("\t\treturn Leaf < 0 ? -1 : LeafMostLikelyActions[Leaf];\n");
+	Out += TEXT("\t}\n");
+	Out += TEXT("}\n");
+
+	FString FullPath = FPaths::Combine(FolderPath, FileName + TEXT(".h"));
+	if (!FFileHelper::SaveStringToFile(Out, *FullPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ExportDecisionTreeToCpp: Could not write %s"), *FullPath);
+		return false;
+	}
+	return true;
+}
+
+#endif // WITH_EDITOR
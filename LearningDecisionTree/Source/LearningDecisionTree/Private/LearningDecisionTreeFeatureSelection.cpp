@@ -0,0 +1,147 @@
+#include "LearningDecisionTreeFeatureSelection.h"
+#include "LearningDecisionTreeStats.h"
+
+FLearningDecisionTreeFeatureSelection FLearningDecisionTreeFeatureSelection::Select(const FLearningDecisionTreeTable& Table, const FLearningDecisionTreeFeatureSelectionSettings& Settings)
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	FLearningDecisionTreeFeatureSelection Selection;
+	Selection.ColumnNames = Table.ColumnNames;
+
+	const TArray<int32> NoStates;
+	auto GetColumn = [&Table, &NoStates](int32 ColumnIndex) -> const TArray<int32>&
+	{
+		const TArray<int32>* Column = Table.TableData.Find(Table.GetColumnName(ColumnIndex));
+		return Column ? *Column : NoStates;
+	};
+
+	// Kept features by a hash of their states, to find the duplicates among them
+	TMap<uint32, TArray<int32>> KeptByStates;
+	for (int32 Feature = 0; Feature < Table.ColumnNames.Num() - 1; Feature++)
+	{
+		const TArray<int32>& Column = GetColumn(Feature);
+		if (Settings.bDropConstantColumns && Column.Num() > 0 && !Column.ContainsByPredicate([First = Column[0]](int32 State) { return State != First; }))
+		{
+			Selection.DroppedFeatures.Add(Feature);
+			Selection.NumConstant++;
+			continue;
+		}
+
+		TArray<int32>* SameStates = nullptr;
+		if (Settings.bDropDuplicateColumns)
+		{
+			SameStates = &KeptByStates.FindOrAdd(FCrc::MemCrc32(Column.GetData(), Column.Num() * sizeof(int32)));
+			if (SameStates->ContainsByPredicate([&GetColumn, &Column](int32 Kept) { return GetColumn(Kept) == Column; }))
+			{
+				Selection.DroppedFeatures.Add(Feature);
+				Selection.NumDuplicate++;
+				continue;
+			}
+		}
+
+		if (Settings.MinMutualInformation > 0.0f && MutualInformation(Table, Feature) < Settings.MinMutualInformation)
+		{
+			Selection.DroppedFeatures.Add(Feature);
+			Selection.NumLowInformation++;
+			continue;
+		}
+
+		Selection.KeptFeatures.Add(Feature);
+		if (SameStates)
+		{
+			SameStates->Add(Feature);
+		}
+	}
+	return Selection;
+}
+
+void FLearningDecisionTreeFeatureSelection::BuildTable(const FLearningDecisionTreeTable& Table, FLearningDecisionTreeTable& OutTable) const
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	OutTable = FLearningDecisionTreeTable();
+	if (ColumnNames.Num() == 0)
+	{
+		return;
+	}
+
+	auto CopyColumn = [&Table, &OutTable](FName Name)
+	{
+		OutTable.ColumnNames.Add(Name);
+		if (const TArray<int32>* Column = Table.TableData.Find(Name))
+		{
+			OutTable.TableData.Add(Name, *Column);
+		}
+	};
+	for (int32 Feature : KeptFeatures)
+	{
+		CopyColumn(ColumnNames[Feature]);
+	}
+	CopyColumn(ColumnNames.Last());
+
+	// Rows that only differed in dropped columns stay separate rows; their counts add up the same
+	OutTable.DuplicateCounts = Table.DuplicateCounts;
+	OutTable.TotalRows = Table.TotalRows;
+}
+
+int32 FLearningDecisionTreeFeatureSelection::ToOriginalColumn(int32 RelativeColumn, const TArray<FName>& RemainingColumns) const
+{
+	if (!RemainingColumns.IsValidIndex(RelativeColumn))
+	{
+		return RelativeColumn;
+	}
+
+	// Dropped columns are never split on, so they remain at every node of the full tree: the ones before the
+	// split column are the only columns the full table has ahead of it that the narrower one does not
+	const int32 Feature = ColumnNames.IndexOfByKey(RemainingColumns[RelativeColumn]);
+	int32 DroppedBefore = 0;
+	while (DroppedBefore < DroppedFeatures.Num() && DroppedFeatures[DroppedBefore] < Feature)
+	{
+		DroppedBefore++;
+	}
+	return RelativeColumn + DroppedBefore;
+}
+
+double FLearningDecisionTreeFeatureSelection::MutualInformation(const FLearningDecisionTreeTable& Table, int32 ColumnIndex)
+{
+	const TArray<int32>* Column = Table.TableData.Find(Table.GetColumnName(ColumnIndex));
+	const TArray<int32>* Actions = Table.ColumnNames.Num() > 0 ? Table.TableData.Find(Table.ColumnNames.Last()) : nullptr;
+	if (!Column || !Actions || Column->Num() != Actions->Num())
+	{
+		return 0.0;
+	}
+
+	TMap<int32, int64> StateCounts;
+	TMap<int32, int64> ActionCounts;
+	TMap<TPair<int32, int32>, int64> JointCounts;
+	int64 Total = 0;
+	for (int32 Row = 0; Row < Column->Num(); Row++)
+	{
+		const int32 Count = Table.GetDuplicateCount(Row);
+		StateCounts.FindOrAdd((*Column)[Row]) += Count;
+		ActionCounts.FindOrAdd((*Actions)[Row]) += Count;
+		JointCounts.FindOrAdd(TPair<int32, int32>((*Column)[Row], (*Actions)[Row])) += Count;
+		Total += Count;
+	}
+	if (Total <= 0)
+	{
+		return 0.0;
+	}
+
+	auto Entropy = [Total](const auto& Counts)
+	{
+		double Sum = 0.0;
+		for (const auto& Pair : Counts)
+		{
+			const double Probability = (double)Pair.Value / (double)Total;
+			if (Probability > 0.0)
+			{
+				Sum -= Probability * FMath::Log2(Probability);
+			}
+		}
+		return Sum;
+	};
+
+	// I(S; A) = H(S) + H(A) - H(S, A)
+	return FMath::Max(0.0, Entropy(StateCounts) + Entropy(ActionCounts) - Entropy(JointCounts));
+}
@@ -0,0 +1,321 @@
+#include "LearningDecisionTreeFlat.h"
+#include "LearningDecisionTreeNode.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+namespace LearningDecisionTreeFlat
+{
+	/** Assigns flat indices to UObject nodes in depth-first order. */
+	struct FBuilder
+	{
+		TArray<FLearningDecisionTreeFlatNode> Nodes;
+		TArray<FLearningDecisionTreeFlatBranch> Branches;
+		TArray<FLearningDecisionTreeFlatLeafEntry> LeafEntries;
+		TMap<const ULearningDecisionTreeNode*, uint32> NodeIndices;
+		int32 NumFeatures = 0;
+		bool bValid = true;
+
+		uint32 AddNode(const ULearningDecisionTreeNode* Node)
+		{
+			if (const uint32* Existing = NodeIndices.Find(Node))
+			{
+				return *Existing;
+			}
+
+			uint32 NodeIndex = (uint32)Nodes.AddZeroed();
+			NodeIndices.Add(Node, NodeIndex);
+
+			if (const ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node))
+			{
+				if (DNode->FeatureIndex < 0)
+				{
+					// FeatureIndex must be resolved before flattening
+					bValid = false;
+				}
+				NumFeatures = FMath::Max(NumFeatures, DNode->FeatureIndex + 1);
+
+				int32 NumBranches = FMath::Min(DNode->ColumnStates.Num(), DNode->Nodes.Num());
+				uint32 First = (uint32)Branches.AddZeroed(NumBranches);
+				Nodes[NodeIndex] = { DNode->FeatureIndex, First, (uint32)NumBranches, -1 };
+
+				for (int32 i = 0; i < NumBranches; i++)
+				{
+					// Children may grow the arrays, so never hold references across this call
+					uint32 Child = AddNode(DNode->Nodes[i]);
+					Branches[First + i] = { DNode->ColumnStates[i], Child };
+				}
+			}
+			else if (const ULearningDecisionTreeActionNode* ActionNode = Cast<ULearningDecisionTreeActionNode>(Node))
+			{
+				int32 NumActions = FMath::Min(ActionNode->ActionNames.Num(), ActionNode->ActionCounts.Num());
+				uint32 First = (uint32)LeafEntries.Num();
+				uint32 Cumulative = 0;
+				for (int32 i = 0; i < NumActions; i++)
+				{
+					Cumulative += (uint32)FMath::Max(ActionNode->ActionCounts[i], 0);
+					LeafEntries.Add({ ActionNode->ActionNames[i], Cumulative });
+				}
+				Nodes[NodeIndex] = { INDEX_NONE, First, (uint32)NumActions, ActionNode->MostLikelyAction() };
+			}
+			else
+			{
+				// Null or unfinished TableNode: an empty leaf that predicts nothing
+				Nodes[NodeIndex] = { INDEX_NONE, 0, 0, -1 };
+			}
+
+			return NodeIndex;
+		}
+
+		/** Writes the header and the sections, with RootNode as the root. */
+		void Write(uint32 RootNode, TArray<uint8>& OutBytes) const
+		{
+			std::vector<uint8_t> Bytes;
+			LearningDecisionTreeCore::WriteFlatTree(Nodes.GetData(), Nodes.Num(), Branches.GetData(), Branches.Num(),
+				LeafEntries.GetData(), LeafEntries.Num(), (uint32)NumFeatures, RootNode, Bytes);
+			OutBytes = TArray<uint8>(Bytes.data(), (int32)Bytes.size());
+		}
+	};
+}
+
+// ============================================================================
+// FLearningDecisionTreeFlatView
+// ============================================================================
+
+bool FLearningDecisionTreeFlatView::Initialize(const uint8* Data, int64 Size)
+{
+	return Core.Initialize(Data, Size > 0 ? (size_t)Size : 0);
+}
+
+int32 FLearningDecisionTreeFlatView::FindLeaf(TArrayView<const int32> Row, FLearningDecisionTreePath* OutPath) const
+{
+	if (!OutPath)
+	{
+		return Core.FindLeaf(Row.GetData(), (size_t)Row.Num());
+	}
+
+	// Every tested feature goes on the path, including one whose state has no branch, so a change to it is noticed
+	return Core.FindLeaf(Row.GetData(), (size_t)Row.Num(), [OutPath](const FLearningDecisionTreeFlatNode& Node, uint32)
+	{
+		OutPath->Add(Node.FeatureIndex);
+	});
+}
+
+int32 FLearningDecisionTreeFlatView::SampleAction(int32 LeafIndex, FRandomStream& RandomStream) const
+{
+	return Core.SampleActionWith(LeafIndex, [&RandomStream](uint32 Total)
+	{
+		return (uint32)RandomStream.RandRange(0, (int32)FMath::Min<uint32>(Total - 1, MAX_int32));
+	});
+}
+
+int32 FLearningDecisionTreeFlatView::Eval(TArrayView<const int32> Row, FRandomStream& RandomStream, bool bMostLikelyAction) const
+{
+	int32 LeafIndex = FindLeaf(Row);
+	return bMostLikelyAction ? MostLikelyAction(LeafIndex) : SampleAction(LeafIndex, RandomStream);
+}
+
+int32 FLearningDecisionTreeFlatView::EvalWithContext(FLearningDecisionTreeEvalContext& Context, uint32 TreeVersion) const
+{
+	if (TreeVersion != 0 && Context.CachedTreeVersion == TreeVersion)
+	{
+		Context.CacheHits++;
+	}
+	else
+	{
+		Context.CacheMisses++;
+		Context.PathFeatures.Reset();
+		Context.CachedLeaf = nullptr;
+		Context.CachedFlatLeaf = FindLeaf(Context.States, &Context.PathFeatures);
+		Context.CachedMostLikelyAction = MostLikelyAction(Context.CachedFlatLeaf);
+		Context.CachedTreeVersion = TreeVersion;
+	}
+
+	return Context.bUseMostLikelyAction ? Context.CachedMostLikelyAction : SampleAction(Context.CachedFlatLeaf, Context.RandomStream);
+}
+
+TArrayView<const uint8> FLearningDecisionTreeFlatView::GetBytes() const
+{
+	return TArrayView<const uint8>(reinterpret_cast<const uint8*>(Core.GetHeader()), (int32)Core.GetSize());
+}
+
+bool FLearningDecisionTreeFlatView::Build(const ULearningDecisionTreeNode* Root, TArray<uint8>& OutBytes)
+{
+	using namespace LearningDecisionTreeFlat;
+
+	FBuilder Builder;
+	uint32 RootNode = Builder.AddNode(Root);
+	if (!Builder.bValid)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Flat decision tree: DecisionNode without a resolved FeatureIndex."));
+		return false;
+	}
+
+	Builder.Write(RootNode, OutBytes);
+	return true;
+}
+
+void FLearningDecisionTreeFlatView::CountBranchHits(TArrayView<const int32> Row, TArrayView<int32> BranchHits) const
+{
+	if (BranchHits.Num() != (int32)GetNumBranches())
+	{
+		return;
+	}
+
+	Core.FindLeaf(Row.GetData(), (size_t)Row.Num(), [BranchHits](const FLearningDecisionTreeFlatNode&, uint32 Branch)
+	{
+		if (Branch != LearningDecisionTreeCore::FFlatView::NoBranch)
+		{
+			FPlatformAtomics::InterlockedIncrement(&BranchHits[Branch]);
+		}
+	});
+}
+
+bool FLearningDecisionTreeFlatView::BuildHotFirst(TArrayView<const int32> BranchHits, TArray<uint8>& OutBytes) const
+{
+	using namespace LearningDecisionTreeFlat;
+
+	const FLearningDecisionTreeFlatHeader* Header = GetHeader();
+	if (!Header || Header->NumNodes == 0 || BranchHits.Num() != (int32)Header->NumBranches)
+	{
+		return false;
+	}
+
+	auto IsValidNode = [Header](const FLearningDecisionTreeFlatNode& Node)
+	{
+		uint32 NumEntries = Node.FeatureIndex == INDEX_NONE ? Header->NumLeafEntries : Header->NumBranches;
+		return Node.First <= NumEntries && Node.Num <= NumEntries - Node.First;
+	};
+
+	// The branches of a decision node, most taken first; ties keep their order
+	auto SortBranches = [BranchHits](const FLearningDecisionTreeFlatNode& Node)
+	{
+		TArray<uint32, TInlineAllocator<16>> Sorted;
+		for (uint32 Branch = Node.First; Branch < Node.First + Node.Num; Branch++)
+		{
+			Sorted.Add(Branch);
+		}
+		Sorted.StableSort([BranchHits](uint32 A, uint32 B) { return BranchHits[A] > BranchHits[B]; });
+		return Sorted;
+	};
+
+	// Order the nodes depth-first, always descending into the most taken branch first
+	TArray<uint32> Order;
+	TMap<uint32, uint32> NewIndices;
+	TArray<uint32> Stack;
+	Stack.Add(Header->RootNode);
+	while (Stack.Num() > 0)
+	{
+		uint32 NodeIndex = Stack.Pop();
+		if (NewIndices.Contains(NodeIndex))
+		{
+			continue;
+		}
+
+		const FLearningDecisionTreeFlatNode& Node = GetNode(NodeIndex);
+		if (!IsValidNode(Node))
+		{
+			return false;
+		}
+		NewIndices.Add(NodeIndex, (uint32)Order.Add(NodeIndex));
+
+		if (Node.FeatureIndex != INDEX_NONE)
+		{
+			TArray<uint32, TInlineAllocator<16>> Sorted = SortBranches(Node);
+			for (int32 i = Sorted.Num() - 1; i >= 0; i--)
+			{
+				if (GetBranch(Sorted[i]).Child >= Header->NumNodes)
+				{
+					return false;
+				}
+				Stack.Add(GetBranch(Sorted[i]).Child);
+			}
+		}
+	}
+
+	FBuilder Builder;
+	Builder.NumFeatures = (int32)Header->NumFeatures;
+	for (uint32 NodeIndex : Order)
+	{
+		const FLearningDecisionTreeFlatNode& Node = GetNode(NodeIndex);
+		if (Node.FeatureIndex == INDEX_NONE)
+		{
+			uint32 First = (uint32)Builder.LeafEntries.Num();
+			if (Node.Num > 0)
+			{
+				Builder.LeafEntries.Append(&GetLeafEntry(Node.First), Node.Num);
+			}
+			Builder.Nodes.Add({ INDEX_NONE, First, Node.Num, Node.MostLikelyAction });
+		}
+		else
+		{
+			uint32 First = (uint32)Builder.Branches.Num();
+			for (uint32 Branch : SortBranches(Node))
+			{
+				Builder.Branches.Add({ GetBranch(Branch).State, NewIndices[GetBranch(Branch).Child] });
+			}
+			Builder.Nodes.Add({ Node.FeatureIndex, First, Node.Num, -1 });
+		}
+	}
+
+	Builder.Write(0, OutBytes);
+	return true;
+}
+
+// ============================================================================
+// FLearningDecisionTreeFlatModel
+// ============================================================================
+
+FLearningDecisionTreeFlatModel::FLearningDecisionTreeFlatModel()
+{
+}
+
+FLearningDecisionTreeFlatModel::~FLearningDecisionTreeFlatModel()
+{
+	// The region must be unmapped before its file handle is closed
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+}
+
+TSharedPtr<FLearningDecisionTreeFlatModel> FLearningDecisionTreeFlatModel::OpenFile(const FString& FullPath)
+{
+	TSharedPtr<FLearningDecisionTreeFlatModel> Model = MakeShared<FLearningDecisionTreeFlatModel>();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	Model->MappedHandle.Reset(PlatformFile.OpenMapped(*FullPath));
+	if (Model->MappedHandle && Model->MappedHandle->GetFileSize() > 0)
+	{
+		Model->MappedRegion.Reset(Model->MappedHandle->MapRegion(0, Model->MappedHandle->GetFileSize()));
+	}
+
+	if (Model->MappedRegion)
+	{
+		if (Model->View.Initialize(Model->MappedRegion->GetMappedPtr(), Model->MappedRegion->GetMappedSize()))
+		{
+			return Model;
+		}
+		UE_LOG(LogTemp, Error, TEXT("Flat decision tree: %s is not a valid .ftree file."), *FullPath);
+		return nullptr;
+	}
+
+	// No mapping support on this platform or file system: read the blob instead
+	Model->MappedHandle.Reset();
+	TArray<uint8> FileBytes;
+	if (!FFileHelper::LoadFileToArray(FileBytes, *FullPath))
+	{
+		return nullptr;
+	}
+	return FromBytes(MoveTemp(FileBytes));
+}
+
+TSharedPtr<FLearningDecisionTreeFlatModel> FLearningDecisionTreeFlatModel::FromBytes(TArray<uint8>&& InBytes)
+{
+	TSharedPtr<FLearningDecisionTreeFlatModel> Model = MakeShared<FLearningDecisionTreeFlatModel>();
+	Model->Bytes = MoveTemp(InBytes);
+	if (!Model->View.Initialize(Model->Bytes.GetData(), Model->Bytes.Num()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Flat decision tree: Invalid blob."));
+		return nullptr;
+	}
+	return Model;
+}
@@ -0,0 +1,96 @@
+#include "LearningDecisionTreeModelAsset.h"
+#include "LearningDecisionTree.h"
+#include "LearningDecisionTreeStats.h"
+
+#if WITH_EDITOR
+bool ULearningDecisionTreeModelAsset::BuildFromDecisionTree(ULearningDecisionTree* Tree)
+{
+	if (!Tree)
+	{
+		return false;
+	}
+
+	// A tree loaded from a flat file or asset already is the blob; otherwise compile the node tree
+	TArray<uint8> Bytes;
+	if (TSharedPtr<const FLearningDecisionTreeFlatModel> FlatTree = Tree->GetFlatTree())
+	{
+		Bytes = TArray<uint8>(FlatTree->GetView().GetBytes());
+	}
+	else if (Tree->LDTRoot.Num() == 0 || !Tree->LDTRoot[0] || !FLearningDecisionTreeFlatView::Build(Tree->LDTRoot[0], Bytes))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BuildFromDecisionTree: %s has no decision tree to build from."), *Tree->GetName());
+		return false;
+	}
+
+	Modify();
+
+	Payload.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(Payload.Realloc(Bytes.Num()), Bytes.GetData(), Bytes.Num());
+	Payload.Unlock();
+
+	FeatureNames = Tree->Table.ColumnNames;
+	ActionName = FeatureNames.Num() > 0 ? FeatureNames.Pop() : NAME_None;
+
+	CreateModel();
+	return Model.IsValid();
+}
+#endif
+
+int32 ULearningDecisionTreeModelAsset::GetNumFeatures() const
+{
+	return Model.IsValid() ? (int32)Model->GetView().GetHeader()->NumFeatures : 0;
+}
+
+int32 ULearningDecisionTreeModelAsset::EvalWithContext(FLearningDecisionTreeEvalContext& Context) const
+{
+	return Model.IsValid() ? Model->GetView().EvalWithContext(Context, TreeVersion) : -1;
+}
+
+int32 ULearningDecisionTreeModelAsset::EvalRow(const TArray<int32>& Row, FLearningDecisionTreeEvalContext& Context) const
+{
+	return Model.IsValid() ? Model->GetView().Eval(Row, Context.RandomStream, Context.bUseMostLikelyAction) : -1;
+}
+
+void ULearningDecisionTreeModelAsset::Serialize(FArchive& Ar)
+{
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+	Super::Serialize(Ar);
+
+	Payload.Serialize(Ar, this);
+
+	// Build the model as part of loading, which may run on the async loading thread; it touches no UObjects
+	if (Ar.IsLoading())
+	{
+		CreateModel();
+	}
+}
+
+void ULearningDecisionTreeModelAsset::CreateModel()
+{
+	Model.Reset();
+	TreeVersion = 0;
+
+	int64 Size = Payload.GetBulkDataSize();
+	if (Size <= 0)
+	{
+		return;
+	}
+
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized((int32)Size);
+	FMemory::Memcpy(Bytes.GetData(), Payload.LockReadOnly(), Size);
+	Payload.Unlock();
+
+#if !WITH_EDITOR
+	// Cooked games never save the asset, so the model's copy is the only one needed
+	Payload.RemoveBulkData();
+#endif
+
+	Model = FLearningDecisionTreeFlatModel::FromBytes(MoveTemp(Bytes));
+	if (!Model.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("LearningDecisionTreeModelAsset: %s holds an invalid model."), *GetPathName());
+		return;
+	}
+	TreeVersion = FLearningDecisionTreeEvalContext::AllocateTreeVersion();
+}
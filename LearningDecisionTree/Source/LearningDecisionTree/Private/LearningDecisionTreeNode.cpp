@@ -1,5 +1,16 @@
 #include "LearningDecisionTreeNode.h"
 #include "LearningDecisionTreeTable.h"
+#include "LearningDecisionTreeStats.h"
+#include "Algo/BinarySearch.h"
+
+// NewObject for the nodes created while building, tracked by the AllocateNodes stat
+template <typename NodeType>
+static NodeType* NewBuildNode(UObject* Outer)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LearningDecisionTree_AllocateNodes);
+	INC_DWORD_STAT(STAT_LearningDecisionTree_NodesCreated);
+	return NewObject<NodeType>(Outer);
+}
 
 int32 ULearningDecisionTreeNode::Eval(const TArray<int32>& Row)
 {
@@ -12,6 +23,17 @@ void ULearningDecisionTreeNode::ExplodeNode(TArray<ULearningDecisionTreeNode*>&
 	// Default implementation does nothing
 }
 
+SIZE_T ULearningDecisionTreeNode::GetAllocatedSize() const
+{
+	return 0;
+}
+
+void ULearningDecisionTreeNode::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(GetAllocatedSize());
+}
+
 // ============================================================================
 // ULearningDecisionTreeTableNode
 // ============================================================================
@@ -59,6 +81,8 @@ float ULearningDecisionTreeTableNode::ArrayEntropy(const TArray<int32>& Occurren
 
 float ULearningDecisionTreeTableNode::InfoGain(int32 ColumnIndex)
 {
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_InfoGain);
+
 	// The target action column is the last column
 	int32 ActionColumn = Table.ColumnNames.Num() - 1;
 	int32 TableRowCount = Table.GetTableRowCount();
@@ -68,6 +92,7 @@ float ULearningDecisionTreeTableNode::InfoGain(int32 ColumnIndex)
 
 	TArray<int32> ColumnStates = Table.GetColumnStates(ColumnIndex);
 	TArray<int32> ActionStates = Table.GetColumnStates(ActionColumn);
+	INC_DWORD_STAT_BY(STAT_LearningDecisionTree_RowsScanned, TableRowCount * ColumnStates.Num() * ActionStates.Num());
 
 	// Subtract conditional entropy for each state in the column
 	for (int32 State : ColumnStates)
@@ -125,6 +150,8 @@ int32 ULearningDecisionTreeTableNode::IndexBestInfoGainColumn()
 
 void ULearningDecisionTreeTableNode::ExplodeNode(TArray<ULearningDecisionTreeNode*>& NodesToExplode)
 {
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_ExplodeNode);
+
 	int32 ActionColumn = Table.ColumnNames.Num() - 1;
 	float ActionColumnEntropy = ColumnEntropy(ActionColumn);
 
@@ -139,7 +166,7 @@ void ULearningDecisionTreeTableNode::ExplodeNode(TArray<ULearningDecisionTreeNod
 		// Create child nodes for each state of the best column
 		for (int32 State : StateNames)
 		{
-			ULearningDecisionTreeTableNode* NewNode = NewObject<ULearningDecisionTreeTableNode>(GetOuter());
+			ULearningDecisionTreeTableNode* NewNode = NewBuildNode<ULearningDecisionTreeTableNode>(GetOuter());
 			FLearningDecisionTreeTable FilteredTable = Table.FilterTableByState(BestCol, State);
 			// Initialize new node and add to processing queue (NodesToExplode)
 			// Pass 'NextNodes' as parent list so we can link them to the DecisionNode later
@@ -148,7 +175,7 @@ void ULearningDecisionTreeTableNode::ExplodeNode(TArray<ULearningDecisionTreeNod
 		}
 
 		// Create a DecisionNode to replace this TableNode
-		ULearningDecisionTreeDecisionNode* DecisionNode = NewObject<ULearningDecisionTreeDecisionNode>(GetOuter());
+		ULearningDecisionTreeDecisionNode* DecisionNode = NewBuildNode<ULearningDecisionTreeDecisionNode>(GetOuter());
 		DecisionNode->Init(NextNodes, StateNames, BestCol);
 
 		// CRITICAL: Update children to point to the new DecisionNode's list.
@@ -180,7 +207,7 @@ void ULearningDecisionTreeTableNode::ExplodeNode(TArray<ULearningDecisionTreeNod
 			IndividualStateCounts.Add(Table.GetStateCount(ActionColumn, State));
 		}
 
-		ULearningDecisionTreeActionNode* ActionNode = NewObject<ULearningDecisionTreeActionNode>(GetOuter());
+		ULearningDecisionTreeActionNode* ActionNode = NewBuildNode<ULearningDecisionTreeActionNode>(GetOuter());
 		ActionNode->Init(StateNames, IndividualStateCounts);
 
 		// Replace self in the parent list with the new ActionNode
@@ -197,6 +224,11 @@ int32 ULearningDecisionTreeTableNode::Eval(const TArray<int32>& Row)
 	return -1;
 }
 
+SIZE_T ULearningDecisionTreeTableNode::GetAllocatedSize() const
+{
+	return Table.GetAllocatedSize() + NextNodes.GetAllocatedSize();
+}
+
 
 // ============================================================================
 // ULearningDecisionTreeDecisionNode
@@ -211,33 +243,49 @@ void ULearningDecisionTreeDecisionNode::Init(const TArray<ULearningDecisionTreeN
 
 int32 ULearningDecisionTreeDecisionNode::Eval(const TArray<int32>& Row)
 {
-	int32 SelectedNodeIndex = -1;
-
-	// Find which branch to take based on the row value at the split column
-	for (int32 i = 0; i < ColumnStates.Num(); i++)
+	// Walk down in place of building each level's row without its split column:
+	// UsedColumns holds the positions in Row split on so far, sorted, to map BestInfoGainColumn back into Row.
+	TArray<int32, TInlineAllocator<64>> UsedColumns;
+	ULearningDecisionTreeNode* Node = this;
+	while (ULearningDecisionTreeDecisionNode* DNode = Cast<ULearningDecisionTreeDecisionNode>(Node))
 	{
-		if (Row.IsValidIndex(BestInfoGainColumn) && ColumnStates[i] == Row[BestInfoGainColumn])
+		int32 Column = DNode->BestInfoGainColumn;
+		for (int32 UsedColumn : UsedColumns)
 		{
-			SelectedNodeIndex = i;
-			break;
+			if (UsedColumn > Column)
+			{
+				break;
+			}
+			Column++;
 		}
+
+		// Find which branch to take based on the row value at the split column
+		int32 SelectedNodeIndex = Row.IsValidIndex(Column) ? DNode->ColumnStates.Find(Row[Column]) : INDEX_NONE;
+		if (!DNode->Nodes.IsValidIndex(SelectedNodeIndex))
+		{
+			return -1;
+		}
+
+		UsedColumns.Insert(Column, Algo::LowerBound(UsedColumns, Column));
+		Node = DNode->Nodes[SelectedNodeIndex];
 	}
 
-	if (SelectedNodeIndex > -1 && Nodes.IsValidIndex(SelectedNodeIndex))
+	return Node ? Node->Eval(Row) : -1;
+}
+
+int32 ULearningDecisionTreeDecisionNode::FindBranch(TArrayView<const int32> Row) const
+{
+	if (Row.IsValidIndex(FeatureIndex))
 	{
-		// Construct new row without the used column for the next evaluation step
-		TArray<int32> NewRow;
-		for (int32 i = 0; i < Row.Num(); i++)
+		int32 State = Row[FeatureIndex];
+		for (int32 i = 0; i < ColumnStates.Num(); i++)
 		{
-			if (i != BestInfoGainColumn)
+			if (ColumnStates[i] == State)
 			{
-				NewRow.Add(Row[i]);
+				return Nodes.IsValidIndex(i) ? i : -1;
 			}
 		}
-
-		return Nodes[SelectedNodeIndex]->Eval(NewRow);
 	}
-
 	return -1;
 }
 
@@ -246,6 +294,48 @@ void ULearningDecisionTreeDecisionNode::ExplodeNode(TArray<ULearningDecisionTree
 	// DecisionNode is a finished node, nothing to explode
 }
 
+SIZE_T ULearningDecisionTreeDecisionNode::GetAllocatedSize() const
+{
+	return Nodes.GetAllocatedSize() + ColumnStates.GetAllocatedSize() + BranchHits.GetAllocatedSize();
+}
+
+void ULearningDecisionTreeDecisionNode::AddBranchHit(int32 Branch) const
+{
+	if (BranchHits.IsValidIndex(Branch))
+	{
+		FPlatformAtomics::InterlockedIncrement(&BranchHits[Branch]);
+	}
+}
+
+void ULearningDecisionTreeDecisionNode::SortBranchesByHits()
+{
+	int32 NumBranches = FMath::Min(Nodes.Num(), ColumnStates.Num());
+	if (BranchHits.Num() != NumBranches)
+	{
+		return;
+	}
+
+	TArray<int32> Order;
+	for (int32 i = 0; i < NumBranches; i++)
+	{
+		Order.Add(i);
+	}
+	Order.StableSort([this](int32 A, int32 B) { return BranchHits[A] > BranchHits[B]; });
+
+	TArray<ULearningDecisionTreeNode*> SortedNodes;
+	TArray<int32> SortedStates;
+	TArray<int32> SortedHits;
+	for (int32 i : Order)
+	{
+		SortedNodes.Add(Nodes[i]);
+		SortedStates.Add(ColumnStates[i]);
+		SortedHits.Add(BranchHits[i]);
+	}
+	Nodes = MoveTemp(SortedNodes);
+	ColumnStates = MoveTemp(SortedStates);
+	BranchHits = MoveTemp(SortedHits);
+}
+
 
 // ============================================================================
 // ULearningDecisionTreeActionNode
@@ -257,7 +347,7 @@ void ULearningDecisionTreeActionNode::Init(const TArray<int32>& InActionNames, c
 	ActionCounts = InActionCounts;
 }
 
-int32 ULearningDecisionTreeActionNode::RandAction(const TArray<int32>& Probs)
+int32 ULearningDecisionTreeActionNode::RandAction(const TArray<int32>& Probs, FRandomStream* RandomStream) const
 {
 	int32 Total = 0;
 	for (int32 Prob : Probs)
@@ -267,7 +357,7 @@ int32 ULearningDecisionTreeActionNode::RandAction(const TArray<int32>& Probs)
 
 	// Random selection weighted by counts
 	// FMath::RandRange is inclusive on both ends, so use Total - 1
-	int32 Rand = FMath::RandRange(0, Total - 1);
+	int32 Rand = RandomStream ? RandomStream->RandRange(0, Total - 1) : FMath::RandRange(0, Total - 1);
 
 	int32 CurrentTotal = 0;
 	int32 IndexObstacle = -1;
@@ -291,6 +381,11 @@ int32 ULearningDecisionTreeActionNode::RandAction(const TArray<int32>& Probs)
 int32 ULearningDecisionTreeActionNode::Eval(const TArray<int32>& Row)
 {
 	// Return an action based on learned probabilities
+	return SampleAction();
+}
+
+int32 ULearningDecisionTreeActionNode::SampleAction() const
+{
 	int32 Index = RandAction(ActionCounts);
 	if (ActionNames.IsValidIndex(Index))
 	{
@@ -299,7 +394,40 @@ int32 ULearningDecisionTreeActionNode::Eval(const TArray<int32>& Row)
 	return -1;
 }
 
+int32 ULearningDecisionTreeActionNode::SampleAction(FRandomStream& RandomStream) const
+{
+	int32 Index = RandAction(ActionCounts, &RandomStream);
+	if (ActionNames.IsValidIndex(Index))
+	{
+		return ActionNames[Index];
+	}
+	return -1;
+}
+
+int32 ULearningDecisionTreeActionNode::MostLikelyAction() const
+{
+	int32 BestIndex = -1;
+	for (int32 i = 0; i < ActionCounts.Num(); i++)
+	{
+		if (BestIndex == -1 || ActionCounts[i] > ActionCounts[BestIndex])
+		{
+			BestIndex = i;
+		}
+	}
+
+	if (ActionNames.IsValidIndex(BestIndex))
+	{
+		return ActionNames[BestIndex];
+	}
+	return -1;
+}
+
 void ULearningDecisionTreeActionNode::ExplodeNode(TArray<ULearningDecisionTreeNode*>& NodesToExplode)
 {
 	// ActionNode is a leaf node, nothing to explode
 }
+
+SIZE_T ULearningDecisionTreeActionNode::GetAllocatedSize() const
+{
+	return ActionNames.GetAllocatedSize() + ActionCounts.GetAllocatedSize();
+}
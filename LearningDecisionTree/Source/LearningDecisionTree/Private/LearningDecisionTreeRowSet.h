@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeTable.h"
+
+/**
+ * Distinct rows of a fixed width with their counts, deduplicated through an open-addressing hash set.
+ * Builds tables in O(rows), where FLearningDecisionTreeTable::AddRow scans every existing row.
+ */
+class FLearningDecisionTreeRowSet
+{
+public:
+	explicit FLearningDecisionTreeRowSet(int32 InWidth)
+		: Width(InWidth)
+	{
+	}
+
+	int32 Num() const { return Counts.Num(); }
+	const int32* GetRow(int32 Index) const { return Values.GetData() + (int64)Index * Width; }
+	const TArray<int32>& GetCounts() const { return Counts; }
+
+	/** Adds Count samples of Row, merging them into an equal row if there is one. */
+	void Add(const int32* Row, int32 Count)
+	{
+		if ((Counts.Num() + 1) * 2 > Slots.Num())
+		{
+			Grow();
+		}
+
+		uint32 Mask = (uint32)Slots.Num() - 1;
+		for (uint32 Slot = Hash(Row) & Mask; ; Slot = (Slot + 1) & Mask)
+		{
+			int32 Index = Slots[Slot];
+			if (Index == INDEX_NONE)
+			{
+				Slots[Slot] = Counts.Num();
+				Values.Append(Row, Width);
+				Counts.Add(Count);
+				return;
+			}
+			if (FMemory::Memcmp(GetRow(Index), Row, Width * sizeof(int32)) == 0)
+			{
+				Counts[Index] += Count;
+				return;
+			}
+		}
+	}
+
+	/** Replaces OutTable with these rows, in the order they were first added, under the given columns. */
+	void ToTable(const TArray<FName>& ColumnNames, FLearningDecisionTreeTable& OutTable) const
+	{
+		check(ColumnNames.Num() == Width);
+
+		OutTable = FLearningDecisionTreeTable();
+		for (int32 Column = 0; Column < Width; Column++)
+		{
+			OutTable.AddColumn(ColumnNames[Column]);
+			TArray<int32>& ColumnData = OutTable.TableData[ColumnNames[Column]];
+			ColumnData.SetNumUninitialized(Num());
+			for (int32 Index = 0; Index < Num(); Index++)
+			{
+				ColumnData[Index] = GetRow(Index)[Column];
+			}
+		}
+
+		OutTable.DuplicateCounts = Counts;
+		OutTable.TotalRows = 0;
+		for (int32 Count : Counts)
+		{
+			OutTable.TotalRows += Count;
+		}
+	}
+
+private:
+	uint32 Hash(const int32* Row) const
+	{
+		uint32 H = 2166136261u;
+		for (int32 Column = 0; Column < Width; Column++)
+		{
+			H = (H ^ (uint32)Row[Column]) * 16777619u;
+		}
+		return H ^ (H >> 15);
+	}
+
+	void Grow()
+	{
+		Slots.Init(INDEX_NONE, FMath::Max(64, Slots.Num() * 2));
+		uint32 Mask = (uint32)Slots.Num() - 1;
+		for (int32 Index = 0; Index < Counts.Num(); Index++)
+		{
+			uint32 Slot = Hash(GetRow(Index)) & Mask;
+			while (Slots[Slot] != INDEX_NONE)
+			{
+				Slot = (Slot + 1) & Mask;
+			}
+			Slots[Slot] = Index;
+		}
+	}
+
+	int32 Width;
+	TArray<int32> Values;
+	TArray<int32> Counts;
+	TArray<int32> Slots;
+};
@@ -0,0 +1,143 @@
+#include "LearningDecisionTreeSampling.h"
+#include "LearningDecisionTreeRowSet.h"
+
+// ============================================================================
+// FLearningDecisionTreeReservoir
+// ============================================================================
+
+void FLearningDecisionTreeReservoir::Reset(int32 InCapacity, int32 InWidth, int32 Seed)
+{
+	Capacity = FMath::Max(1, InCapacity);
+	Width = InWidth;
+	Rows.Reset();
+	NumSeen = 0;
+	RandomStream.Initialize(Seed);
+
+	W = FMath::Exp(FMath::Loge(FMath::Max((double)RandomStream.GetFraction(), 1e-9)) / Capacity);
+	NextAccepted = Capacity + DrawSkip();
+}
+
+int64 FLearningDecisionTreeReservoir::DrawSkip()
+{
+	double U = FMath::Max((double)RandomStream.GetFraction(), 1e-9);
+	double Skip = FMath::FloorToDouble(FMath::Loge(U) / FMath::Loge(1.0 - W));
+	return (int64)FMath::Clamp(Skip, 0.0, 1e15);
+}
+
+void FLearningDecisionTreeReservoir::Add(TArrayView<const int32> Row, int32 Count)
+{
+	check(Row.Num() == Width);
+
+	const int64 End = NumSeen + FMath::Max(Count, 0);
+
+	// Take every sample until the reservoir is full
+	for (; NumSeen < End && Num() < Capacity; NumSeen++)
+	{
+		Rows.Append(Row.GetData(), Width);
+	}
+
+	// Then only the samples Algorithm L picks, each replacing a random one
+	while (NextAccepted < End)
+	{
+		int32 Slot = RandomStream.RandRange(0, Capacity - 1);
+		FMemory::Memcpy(Rows.GetData() + (int64)Slot * Width, Row.GetData(), Width * sizeof(int32));
+
+		W *= FMath::Exp(FMath::Loge(FMath::Max((double)RandomStream.GetFraction(), 1e-9)) / Capacity);
+		NextAccepted += DrawSkip() + 1;
+	}
+	NumSeen = End;
+}
+
+// ============================================================================
+// FLearningDecisionTreeTableSampler
+// ============================================================================
+
+void FLearningDecisionTreeTableSampler::Reset(ELearningDecisionTreeSampling InMode, int32 InSampleSize, int32 InWidth, int32 InSeed)
+{
+	Mode = InMode;
+	SampleSize = InSampleSize;
+	Width = InWidth;
+	Seed = InSeed;
+	Strata.Reset();
+}
+
+void FLearningDecisionTreeTableSampler::AddTable(const FLearningDecisionTreeTable& Table)
+{
+	TArray<const TArray<int32>*> Columns;
+	for (const FName& Name : Table.ColumnNames)
+	{
+		Columns.Add(&Table.TableData[Name]);
+	}
+
+	TArray<int32> Row;
+	Row.SetNumUninitialized(Columns.Num());
+	for (int32 Index = 0; Index < Table.GetTableRowCount(); Index++)
+	{
+		for (int32 Column = 0; Column < Columns.Num(); Column++)
+		{
+			Row[Column] = (*Columns[Column])[Index];
+		}
+		AddRow(Row, Table.DuplicateCounts[Index]);
+	}
+}
+
+void FLearningDecisionTreeTableSampler::AddRow(TArrayView<const int32> Row, int32 Count)
+{
+	if (Row.Num() != Width || Width == 0)
+	{
+		return;
+	}
+
+	int32 Key = Mode == ELearningDecisionTreeSampling::StratifiedByAction ? Row.Last() : 0;
+	FLearningDecisionTreeReservoir* Reservoir = Strata.Find(Key);
+	if (!Reservoir)
+	{
+		Reservoir = &Strata.Add(Key);
+		Reservoir->Reset(SampleSize, Width, Seed ^ (int32)GetTypeHash(Key));
+	}
+	Reservoir->Add(Row, Count);
+}
+
+void FLearningDecisionTreeTableSampler::BuildTable(const TArray<FName>& ColumnNames, FLearningDecisionTreeTable& OutTable) const
+{
+	FLearningDecisionTreeRowSet Rows(Width);
+	for (const TPair<int32, FLearningDecisionTreeReservoir>& Stratum : Strata)
+	{
+		const FLearningDecisionTreeReservoir& Reservoir = Stratum.Value;
+
+		// A stratified sample under-represents frequent actions; weigh each row by the samples it stands for
+		int32 Weight = 1;
+		if (Mode == ELearningDecisionTreeSampling::StratifiedByAction && Reservoir.Num() > 0)
+		{
+			Weight = FMath::Max(1, (int32)FMath::RoundToDouble((double)Reservoir.GetNumSeen() / Reservoir.Num()));
+		}
+
+		for (int32 Index = 0; Index < Reservoir.Num(); Index++)
+		{
+			Rows.Add(Reservoir.GetRow(Index), Weight);
+		}
+	}
+	Rows.ToTable(ColumnNames, OutTable);
+}
+
+bool FLearningDecisionTreeTableSampler::IsComplete() const
+{
+	for (const TPair<int32, FLearningDecisionTreeReservoir>& Stratum : Strata)
+	{
+		if (Stratum.Value.Num() < Stratum.Value.GetNumSeen())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+SIZE_T FLearningDecisionTreeTableSampler::GetAllocatedSize() const
+{
+	SIZE_T Size = Strata.GetAllocatedSize();
+	for (const TPair<int32, FLearningDecisionTreeReservoir>& Stratum : Strata)
+	{
+		Size += Stratum.Value.GetAllocatedSize();
+	}
+	return Size;
+}
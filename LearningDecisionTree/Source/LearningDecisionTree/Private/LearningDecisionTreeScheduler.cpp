@@ -0,0 +1,278 @@
+#include "LearningDecisionTreeScheduler.h"
+#include "LearningDecisionTree.h"
+#include "LearningDecisionTreeStats.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+int32 ULearningDecisionTreeScheduler::RegisterAgent(UObject* Agent, ULearningDecisionTree* Model, FLearningDecisionTreeDecisionEvent OnDecision)
+{
+	int32 AgentId = AddAgent(Agent, Model);
+	if (FAgent* Entry = FindAgent(AgentId))
+	{
+		Entry->OnDecisionEvent = OnDecision;
+	}
+	return AgentId;
+}
+
+int32 ULearningDecisionTreeScheduler::RegisterAgent(UObject* Agent, ULearningDecisionTree* Model, FLearningDecisionTreeStateSource StateSource, FOnLearningDecisionTreeDecision OnDecision)
+{
+	int32 AgentId = AddAgent(Agent, Model);
+	if (FAgent* Entry = FindAgent(AgentId))
+	{
+		Entry->StateSource = MoveTemp(StateSource);
+		Entry->OnDecision = MoveTemp(OnDecision);
+	}
+	return AgentId;
+}
+
+int32 ULearningDecisionTreeScheduler::AddAgent(UObject* Agent, ULearningDecisionTree* Model)
+{
+	if (!Model)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("LearningDecisionTreeScheduler: Cannot register %s without a model"), *GetNameSafe(Agent));
+		return INDEX_NONE;
+	}
+
+	FAgent& Entry = Agents.AddDefaulted_GetRef();
+	Entry.Id = NextAgentId++;
+	Entry.Agent = Agent;
+	Entry.bHasAgent = Agent != nullptr;
+	Entry.Model = Model;
+
+	// Due right away, so every agent gets a first decision
+	const double Now = FPlatformTime::Seconds();
+	Entry.LastDecisionTime = Now;
+	Entry.StateChangedTime = Now;
+
+	AgentIndices.Add(Entry.Id, Agents.Num() - 1);
+	return Entry.Id;
+}
+
+void ULearningDecisionTreeScheduler::UnregisterAgent(int32 AgentId)
+{
+	int32 Index = INDEX_NONE;
+	if (!AgentIndices.RemoveAndCopyValue(AgentId, Index))
+	{
+		return;
+	}
+
+	Agents.RemoveAtSwap(Index);
+	if (Agents.IsValidIndex(Index))
+	{
+		AgentIndices[Agents[Index].Id] = Index;
+	}
+}
+
+ULearningDecisionTreeScheduler::FAgent* ULearningDecisionTreeScheduler::FindAgent(int32 AgentId)
+{
+	const int32* Index = AgentIndices.Find(AgentId);
+	return Index ? &Agents[*Index] : nullptr;
+}
+
+void ULearningDecisionTreeScheduler::SetAgentStates(int32 AgentId, const TArray<int32>& States)
+{
+	FAgent* Entry = FindAgent(AgentId);
+	if (!Entry || Entry->Context.States == States)
+	{
+		return;
+	}
+
+	Entry->Context.SetStates(States);
+	if (Entry->StateChangedTime == 0.0)
+	{
+		Entry->StateChangedTime = FPlatformTime::Seconds();
+	}
+}
+
+void ULearningDecisionTreeScheduler::SetAgentState(int32 AgentId, int32 FeatureIndex, int32 Value)
+{
+	FAgent* Entry = FindAgent(AgentId);
+	if (!Entry || FeatureIndex < 0 || (Entry->Context.States.IsValidIndex(FeatureIndex) && Entry->Context.States[FeatureIndex] == Value))
+	{
+		return;
+	}
+
+	Entry->Context.SetState(FeatureIndex, Value);
+	if (Entry->StateChangedTime == 0.0)
+	{
+		Entry->StateChangedTime = FPlatformTime::Seconds();
+	}
+}
+
+void ULearningDecisionTreeScheduler::MarkStateChanged(int32 AgentId)
+{
+	FAgent* Entry = FindAgent(AgentId);
+	if (Entry && Entry->StateChangedTime == 0.0)
+	{
+		Entry->StateChangedTime = FPlatformTime::Seconds();
+	}
+}
+
+int32 ULearningDecisionTreeScheduler::GetLastAction(int32 AgentId) const
+{
+	const int32* Index = AgentIndices.Find(AgentId);
+	return Index ? Agents[*Index].LastAction : -1;
+}
+
+// Location used for the distance priority, if the agent has one
+static bool GetAgentLocation(const UObject* Agent, FVector& OutLocation)
+{
+	const AActor* Actor = Cast<AActor>(Agent);
+	if (!Actor)
+	{
+		if (const UActorComponent* Component = Cast<UActorComponent>(Agent))
+		{
+			Actor = Component->GetOwner();
+		}
+	}
+	if (!Actor)
+	{
+		return false;
+	}
+	OutLocation = Actor->GetActorLocation();
+	return true;
+}
+
+void ULearningDecisionTreeScheduler::Tick(float DeltaTime)
+{
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_Schedule);
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + BudgetMicroseconds / 1000000.0;
+
+	// Drop agents whose object or model is gone
+	for (int32 Index = Agents.Num() - 1; Index >= 0; Index--)
+	{
+		if (!Agents[Index].Model.IsValid() || (Agents[Index].bHasAgent && !Agents[Index].Agent.IsValid()))
+		{
+			UnregisterAgent(Agents[Index].Id);
+		}
+	}
+
+	FVector ViewLocation = FVector::ZeroVector;
+	bool bHasView = false;
+	if (APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
+	{
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		bHasView = true;
+	}
+
+	// Score the due agents
+	struct FDueAgent
+	{
+		int32 Index;
+		float Priority;
+		double DueTime;
+	};
+	TArray<FDueAgent> Due;
+	for (int32 Index = 0; Index < Agents.Num(); Index++)
+	{
+		const FAgent& Entry = Agents[Index];
+		const bool bChanged = Entry.StateChangedTime != 0.0;
+		const double IntervalTime = Entry.LastDecisionTime + MaxDecisionInterval;
+		if (!bChanged && StartTime < IntervalTime)
+		{
+			continue;
+		}
+
+		const double DueTime = bChanged ? FMath::Min(Entry.StateChangedTime, IntervalTime) : IntervalTime;
+		float Priority = (bChanged ? StateChangedWeight : 0.0f) + WaitWeight * (float)(StartTime - DueTime);
+		FVector Location;
+		if (bHasView && GetAgentLocation(Entry.Agent.Get(), Location))
+		{
+			Priority += DistanceWeight * FMath::Max(0.0f, 1.0f - (float)FVector::Dist(Location, ViewLocation) / MaxPriorityDistance);
+		}
+		Due.Add({ Index, Priority, DueTime });
+	}
+	// Most urgent first. Agents of equal priority are grouped by model, so a tree stays hot in cache
+	// without letting a less urgent agent go before a more urgent one.
+	Due.Sort([this](const FDueAgent& A, const FDueAgent& B)
+	{
+		if (A.Priority != B.Priority)
+		{
+			return A.Priority > B.Priority;
+		}
+		return Agents[A.Index].Model.Get() < Agents[B.Index].Model.Get();
+	});
+
+	// Evaluate in that order. The budget is checked after every agent, so an over-budget tick still evaluates exactly one.
+	struct FDecision
+	{
+		int32 AgentId;
+		int32 Action;
+	};
+	TArray<FDecision> Decisions;
+	double TotalLatency = 0.0;
+	double MaxLatency = 0.0;
+	int32 NumEvaluated = 0;
+
+	// Rows pulled from state sources, reused for every agent of the tick
+	TArray<int32> States;
+	for (const FDueAgent& DueAgent : Due)
+	{
+		FAgent& Entry = Agents[DueAgent.Index];
+		if (Entry.StateSource.IsBound())
+		{
+			States.Reset();
+			States.Append(Entry.Context.States);
+			Entry.StateSource.Execute(States);
+			Entry.Context.SetStates(States);
+		}
+
+		Entry.LastAction = Entry.Model->EvalWithContext(Entry.Context);
+		Decisions.Add({ Entry.Id, Entry.LastAction });
+
+		const double Now = FPlatformTime::Seconds();
+		Entry.LastDecisionTime = Now;
+		Entry.StateChangedTime = 0.0;
+		TotalLatency += Now - DueAgent.DueTime;
+		MaxLatency = FMath::Max(MaxLatency, Now - DueAgent.DueTime);
+		NumEvaluated++;
+
+		// The rest are deferred to the next tick
+		if (Now >= EndTime)
+		{
+			break;
+		}
+	}
+
+	Stats.NumAgents = Agents.Num();
+	Stats.NumDue = Due.Num();
+	Stats.NumEvaluated = NumEvaluated;
+	Stats.NumDeferred = Due.Num() - NumEvaluated;
+	Stats.AverageLatencyMs = NumEvaluated > 0 ? (float)(TotalLatency / NumEvaluated * 1000.0) : 0.0f;
+	Stats.MaxLatencyMs = (float)(MaxLatency * 1000.0);
+
+	// Callbacks run last, as they may register or unregister agents
+	for (const FDecision& Decision : Decisions)
+	{
+		if (FAgent* Entry = FindAgent(Decision.AgentId))
+		{
+			Entry->OnDecision.ExecuteIfBound(Decision.AgentId, Decision.Action);
+		}
+		if (FAgent* Entry = FindAgent(Decision.AgentId))
+		{
+			Entry->OnDecisionEvent.ExecuteIfBound(Entry->Agent.Get(), Decision.Action);
+		}
+	}
+	Stats.TickMicroseconds = (float)((FPlatformTime::Seconds() - StartTime) * 1000000.0);
+
+	INC_DWORD_STAT_BY(STAT_LearningDecisionTree_ScheduledEvals, Stats.NumEvaluated);
+	INC_DWORD_STAT_BY(STAT_LearningDecisionTree_DeferredAgents, Stats.NumDeferred);
+	SET_FLOAT_STAT(STAT_LearningDecisionTree_DecisionLatency, Stats.AverageLatencyMs);
+	SET_FLOAT_STAT(STAT_LearningDecisionTree_MaxDecisionLatency, Stats.MaxLatencyMs);
+}
+
+TStatId ULearningDecisionTreeScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULearningDecisionTreeScheduler, STATGROUP_Tickables);
+}
+
+bool ULearningDecisionTreeScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
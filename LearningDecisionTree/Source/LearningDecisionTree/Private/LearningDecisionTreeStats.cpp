@@ -0,0 +1,34 @@
+#include "LearningDecisionTreeStats.h"
+
+LLM_DEFINE_TAG(LearningDecisionTree);
+
+DEFINE_STAT(STAT_LearningDecisionTree_CreateDecisionTree);
+DEFINE_STAT(STAT_LearningDecisionTree_TickBuild);
+DEFINE_STAT(STAT_LearningDecisionTree_ExplodeNode);
+DEFINE_STAT(STAT_LearningDecisionTree_InfoGain);
+DEFINE_STAT(STAT_LearningDecisionTree_FilterTableByState);
+DEFINE_STAT(STAT_LearningDecisionTree_RefreshTable);
+DEFINE_STAT(STAT_LearningDecisionTree_AllocateNodes);
+DEFINE_STAT(STAT_LearningDecisionTree_AddRow);
+DEFINE_STAT(STAT_LearningDecisionTree_Eval);
+DEFINE_STAT(STAT_LearningDecisionTree_SaveTable);
+DEFINE_STAT(STAT_LearningDecisionTree_LoadTable);
+DEFINE_STAT(STAT_LearningDecisionTree_SaveDecisionTree);
+DEFINE_STAT(STAT_LearningDecisionTree_LoadDecisionTree);
+DEFINE_STAT(STAT_LearningDecisionTree_SerializeDecisionTree);
+DEFINE_STAT(STAT_LearningDecisionTree_DeserializeDecisionTree);
+DEFINE_STAT(STAT_LearningDecisionTree_JournalWrite);
+DEFINE_STAT(STAT_LearningDecisionTree_CsvImport);
+DEFINE_STAT(STAT_LearningDecisionTree_CsvExport);
+DEFINE_STAT(STAT_LearningDecisionTree_Schedule);
+
+DEFINE_STAT(STAT_LearningDecisionTree_NodesCreated);
+DEFINE_STAT(STAT_LearningDecisionTree_RowsScanned);
+DEFINE_STAT(STAT_LearningDecisionTree_Evals);
+DEFINE_STAT(STAT_LearningDecisionTree_BytesWritten);
+DEFINE_STAT(STAT_LearningDecisionTree_BytesRead);
+DEFINE_STAT(STAT_LearningDecisionTree_ScheduledEvals);
+DEFINE_STAT(STAT_LearningDecisionTree_DeferredAgents);
+DEFINE_STAT(STAT_LearningDecisionTree_DecisionLatency);
+DEFINE_STAT(STAT_LearningDecisionTree_MaxDecisionLatency);
+DEFINE_STAT(STAT_LearningDecisionTree_TreeDepth);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * Stats for `stat LearningDecisionTree` and Unreal Insights.
+ * Cycle stats cover training, evaluation and I/O; counters are reset every frame, except TreeDepth.
+ */
+DECLARE_STATS_GROUP(TEXT("LearningDecisionTree"), STATGROUP_LearningDecisionTree, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CreateDecisionTree"), STAT_LearningDecisionTree_CreateDecisionTree, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TickBuild"), STAT_LearningDecisionTree_TickBuild, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ExplodeNode"), STAT_LearningDecisionTree_ExplodeNode, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("InfoGain"), STAT_LearningDecisionTree_InfoGain, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FilterTableByState"), STAT_LearningDecisionTree_FilterTableByState, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RefreshTable"), STAT_LearningDecisionTree_RefreshTable, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AllocateNodes"), STAT_LearningDecisionTree_AllocateNodes, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AddRow"), STAT_LearningDecisionTree_AddRow, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Eval"), STAT_LearningDecisionTree_Eval, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SaveTable"), STAT_LearningDecisionTree_SaveTable, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LoadTable"), STAT_LearningDecisionTree_LoadTable, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SaveDecisionTree"), STAT_LearningDecisionTree_SaveDecisionTree, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LoadDecisionTree"), STAT_LearningDecisionTree_LoadDecisionTree, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SerializeDecisionTree"), STAT_LearningDecisionTree_SerializeDecisionTree, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("DeserializeDecisionTree"), STAT_LearningDecisionTree_DeserializeDecisionTree, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("JournalWrite"), STAT_LearningDecisionTree_JournalWrite, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CsvImport"), STAT_LearningDecisionTree_CsvImport, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CsvExport"), STAT_LearningDecisionTree_CsvExport, STATGROUP_LearningDecisionTree, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Schedule"), STAT_LearningDecisionTree_Schedule, STATGROUP_LearningDecisionTree, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nodes Created"), STAT_LearningDecisionTree_NodesCreated, STATGROUP_LearningDecisionTree, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rows Scanned"), STAT_LearningDecisionTree_RowsScanned, STATGROUP_LearningDecisionTree, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Evals"), STAT_LearningDecisionTree_Evals, STATGROUP_LearningDecisionTree, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bytes Written"), STAT_LearningDecisionTree_BytesWritten, STATGROUP_LearningDecisionTree, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bytes Read"), STAT_LearningDecisionTree_BytesRead, STATGROUP_LearningDecisionTree, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Scheduled Evals"), STAT_LearningDecisionTree_ScheduledEvals, STATGROUP_LearningDecisionTree, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Deferred Agents"), STAT_LearningDecisionTree_DeferredAgents, STATGROUP_LearningDecisionTree, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Decision Latency (ms)"), STAT_LearningDecisionTree_DecisionLatency, STATGROUP_LearningDecisionTree, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Max Decision Latency (ms)"), STAT_LearningDecisionTree_MaxDecisionLatency, STATGROUP_LearningDecisionTree, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Tree Depth"), STAT_LearningDecisionTree_TreeDepth, STATGROUP_LearningDecisionTree, );
+
+/** LLM tag for the plugin's allocations. Set with LLM_SCOPE_BYTAG(LearningDecisionTree) wherever plugin code is entered. */
+LLM_DECLARE_TAG(LearningDecisionTree);
+
+/** A cycle stat that also shows up as a CPU event in Insights. For scopes doing real work, not per-eval paths. */
+#define LEARNINGDECISIONTREE_SCOPE(Stat) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat); \
+	SCOPE_CYCLE_COUNTER(Stat)
@@ -0,0 +1,58 @@
+#include "LearningDecisionTreeSynthetic.h"
+#include "LearningDecisionTreeRowSet.h"
+
+TArray<FName> FLearningDecisionTreeSyntheticData::MakeColumnNames(const FLearningDecisionTreeSyntheticSpec& Spec)
+{
+	TArray<FName> Names;
+	for (int32 Feature = 0; Feature < Spec.NumFeatures; Feature++)
+	{
+		Names.Add(FName(*FString::Printf(TEXT("Feature%d"), Feature)));
+	}
+	Names.Add(FName(TEXT("Action")));
+	return Names;
+}
+
+int32 FLearningDecisionTreeSyntheticData::Label(const FLearningDecisionTreeSyntheticSpec& Spec, TArrayView<const int32> Features)
+{
+	int32 Sum = 0;
+	int32 NumInformative = FMath::Min(Spec.NumInformativeFeatures, Features.Num());
+	for (int32 Feature = 0; Feature < NumInformative; Feature++)
+	{
+		Sum += Features[Feature] * (Feature + 1);
+	}
+	return Sum % FMath::Max(1, Spec.NumActions);
+}
+
+void FLearningDecisionTreeSyntheticData::Generate(const FLearningDecisionTreeSyntheticSpec& Spec, TArray<int32>& OutRows)
+{
+	FRandomStream RandomStream(Spec.Seed);
+	const int32 Width = Spec.NumFeatures + 1;
+
+	OutRows.SetNumUninitialized(Spec.NumRows * Width);
+	for (int32 Row = 0; Row < Spec.NumRows; Row++)
+	{
+		int32* Values = OutRows.GetData() + Row * Width;
+		for (int32 Feature = 0; Feature < Spec.NumFeatures; Feature++)
+		{
+			Values[Feature] = RandomStream.RandRange(0, FMath::Max(1, Spec.Cardinality) - 1);
+		}
+
+		Values[Spec.NumFeatures] = RandomStream.GetFraction() < Spec.LabelNoise
+			? RandomStream.RandRange(0, FMath::Max(1, Spec.NumActions) - 1)
+			: Label(Spec, TArrayView<const int32>(Values, Spec.NumFeatures));
+	}
+}
+
+void FLearningDecisionTreeSyntheticData::GenerateTable(const FLearningDecisionTreeSyntheticSpec& Spec, FLearningDecisionTreeTable& OutTable)
+{
+	TArray<int32> Rows;
+	Generate(Spec, Rows);
+
+	const int32 Width = Spec.NumFeatures + 1;
+	FLearningDecisionTreeRowSet RowSet(Width);
+	for (int32 Row = 0; Row < Spec.NumRows; Row++)
+	{
+		RowSet.Add(Rows.GetData() + Row * Width, 1);
+	}
+	RowSet.ToTable(MakeColumnNames(Spec), OutTable);
+}
@@ -1,5 +1,6 @@
 #include "LearningDecisionTreeTable.h"
 #include "Misc/ScopeLock.h"
+#include "LearningDecisionTreeStats.h"
 
 FLearningDecisionTreeTable::FLearningDecisionTreeTable()
 {
@@ -16,6 +17,16 @@ int32 FLearningDecisionTreeTable::GetTotalRowCount() const
 	return TotalRows;
 }
 
+SIZE_T FLearningDecisionTreeTable::GetAllocatedSize() const
+{
+	SIZE_T Size = TableData.GetAllocatedSize() + ColumnNames.GetAllocatedSize() + DuplicateCounts.GetAllocatedSize();
+	for (const TPair<FName, TArray<int32>>& Column : TableData)
+	{
+		Size += Column.Value.GetAllocatedSize();
+	}
+	return Size;
+}
+
 int32 FLearningDecisionTreeTable::GetStateCount(const FName& Column, int32 State)
 {
 	if (TableData.Contains(Column))
@@ -104,6 +115,8 @@ bool FLearningDecisionTreeTable::AddColumn(const FName& Name)
 
 bool FLearningDecisionTreeTable::AddRow(const TArray<int32>& Row)
 {
+	SCOPE_CYCLE_COUNTER(STAT_LearningDecisionTree_AddRow);
+
 	// Row should contain values for all columns (features + action).
 	// Duplicates are managed internally via DuplicateCounts array.
 	if (Row.Num() != ColumnNames.Num())
@@ -115,6 +128,7 @@ bool FLearningDecisionTreeTable::AddRow(const TArray<int32>& Row)
 	bool bDup = false;
 	int32 DupedRow = -1;
 	int32 TableRowCount = GetTableRowCount();
+	INC_DWORD_STAT_BY(STAT_LearningDecisionTree_RowsScanned, TableRowCount);
 
 	// Check for duplicates
 	for (int32 TableRow = 0; TableRow < TableRowCount; TableRow++)
@@ -232,6 +246,9 @@ float FLearningDecisionTreeTable::IndividualStateProbability(int32 ColumnIndex,
 
 FLearningDecisionTreeTable FLearningDecisionTreeTable::FilterTableByState(const FName& Column, int32 State)
 {
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_FilterTableByState);
+	INC_DWORD_STAT_BY(STAT_LearningDecisionTree_RowsScanned, GetTableRowCount());
+
 	FLearningDecisionTreeTable NewTable = *this; // Create a deep copy
 
 	if (NewTable.TableData.Contains(Column))
@@ -270,6 +287,8 @@ FLearningDecisionTreeTable FLearningDecisionTreeTable::FilterTableByState(int32
 
 void FLearningDecisionTreeTable::RefreshTable()
 {
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_RefreshTable);
+
 	// Merge duplicate rows that might have been created after removing a column
 	if (ColumnNames.Num() > 0 && GetTableRowCount() > 0)
 	{
@@ -294,8 +313,10 @@ void FLearningDecisionTreeTable::RefreshTable()
 
 				if (DupedStates == ColumnNames.Num())
 				{
-					// If rows are identical, merge counts and remove the duplicate
+					// If rows are identical, merge counts and remove the duplicate.
+					// The merged rows are still part of the table, so TotalRows must not drop.
 					DuplicateCounts[SelectedRow] += DuplicateCounts[Row];
+					TotalRows += DuplicateCounts[Row];
 					RemoveRow(Row);
 					// Do not increment Row index, check the same index again (which is now a new row)
 				}
@@ -0,0 +1,425 @@
+#include "LearningDecisionTreeTableCsv.h"
+#include "LearningDecisionTreeRowSet.h"
+#include "LearningDecisionTreeStats.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+namespace LearningDecisionTreeCsv
+{
+	static bool IsPadding(uint8 Char, uint8 Delimiter)
+	{
+		return Char == ' ' || (Char == '\t' && Delimiter != '\t');
+	}
+
+	static bool IsBlankLine(const uint8* Begin, const uint8* End)
+	{
+		for (const uint8* P = Begin; P < End; P++)
+		{
+			if (*P != ' ' && *P != '\t')
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Parses a line (without its line break) of exactly Width integer fields into OutRow. */
+	static bool ParseLine(const uint8* P, const uint8* End, uint8 Delimiter, int32 Width, int32* OutRow)
+	{
+		for (int32 Column = 0; Column < Width; Column++)
+		{
+			while (P < End && IsPadding(*P, Delimiter))
+			{
+				P++;
+			}
+
+			bool bQuoted = P < End && *P == '"';
+			P += bQuoted ? 1 : 0;
+
+			bool bNegative = P < End && *P == '-';
+			P += (bNegative || (P < End && *P == '+')) ? 1 : 0;
+
+			const uint8* Digits = P;
+			int64 Value = 0;
+			while (P < End && *P >= '0' && *P <= '9')
+			{
+				Value = Value * 10 + (*P++ - '0');
+				if (Value > (int64)MAX_int32 + 1)
+				{
+					return false;
+				}
+			}
+			Value = bNegative ? -Value : Value;
+			if (P == Digits || Value > MAX_int32)
+			{
+				return false;
+			}
+
+			if (bQuoted)
+			{
+				if (P == End || *P != '"')
+				{
+					return false;
+				}
+				P++;
+			}
+			while (P < End && IsPadding(*P, Delimiter))
+			{
+				P++;
+			}
+
+			if (Column + 1 < Width)
+			{
+				if (P == End || *P != Delimiter)
+				{
+					return false;
+				}
+				P++;
+			}
+			OutRow[Column] = (int32)Value;
+		}
+		return P == End;
+	}
+
+	/** Splits the header line into column names. */
+	static TArray<FName> ParseHeader(const uint8* Begin, const uint8* End, uint8 Delimiter)
+	{
+		TArray<FName> Names;
+		const uint8* FieldBegin = Begin;
+		for (const uint8* P = Begin; ; P++)
+		{
+			if (P == End || *P == Delimiter)
+			{
+				FUTF8ToTCHAR Field(reinterpret_cast<const ANSICHAR*>(FieldBegin), (int32)(P - FieldBegin));
+				FString Name(Field.Length(), Field.Get());
+				Name.TrimStartAndEndInline();
+				if (Name.Len() >= 2 && Name.StartsWith(TEXT("\"")) && Name.EndsWith(TEXT("\"")))
+				{
+					Name = Name.Mid(1, Name.Len() - 2);
+				}
+				Names.Add(FName(*Name));
+
+				if (P == End)
+				{
+					break;
+				}
+				FieldBegin = P + 1;
+			}
+		}
+		return Names;
+	}
+
+	static void AppendInt(TArray<ANSICHAR>& Out, int32 Value)
+	{
+		ANSICHAR Digits[12];
+		int32 NumDigits = 0;
+		uint32 Magnitude = Value < 0 ? 0u - (uint32)Value : (uint32)Value;
+		do
+		{
+			Digits[NumDigits++] = (ANSICHAR)('0' + Magnitude % 10);
+			Magnitude /= 10;
+		}
+		while (Magnitude != 0);
+
+		if (Value < 0)
+		{
+			Out.Add('-');
+		}
+		while (NumDigits > 0)
+		{
+			Out.Add(Digits[--NumDigits]);
+		}
+	}
+}
+
+bool FLearningDecisionTreeTableCsv::Import(const FString& FullPath, FLearningDecisionTreeTable& OutTable, FLearningDecisionTreeCsvStats* OutStats, TCHAR Delimiter)
+{
+	using namespace LearningDecisionTreeCsv;
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_CsvImport);
+	LLM_SCOPE_BYTAG(LearningDecisionTree);
+
+	double StartTime = FPlatformTime::Seconds();
+
+	// Map the file so the parsing threads read straight from the page cache; read it in where mapping is not supported
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	TUniquePtr<IMappedFileHandle> MappedHandle(PlatformFile.OpenMapped(*FullPath));
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	if (MappedHandle && MappedHandle->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	}
+
+	TArray<uint8> FileBytes;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(FileBytes, *FullPath))
+	{
+		Data = FileBytes.GetData();
+		Size = FileBytes.Num();
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("ImportCsv: Could not read %s"), *FullPath);
+		return false;
+	}
+
+	const uint8* DataEnd = Data + Size;
+	const uint8* Cursor = Data;
+	if (Size >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF)
+	{
+		Cursor += 3;
+	}
+
+	// Header
+	const uint8* HeaderEnd = Cursor;
+	while (HeaderEnd < DataEnd && *HeaderEnd != '\n')
+	{
+		HeaderEnd++;
+	}
+	const uint8* BodyBegin = HeaderEnd < DataEnd ? HeaderEnd + 1 : DataEnd;
+	if (HeaderEnd > Cursor && HeaderEnd[-1] == '\r')
+	{
+		HeaderEnd--;
+	}
+
+	if (Delimiter == 0)
+	{
+		bool bHasTab = false;
+		for (const uint8* P = Cursor; P < HeaderEnd && !bHasTab; P++)
+		{
+			bHasTab = *P == '\t';
+		}
+		Delimiter = bHasTab ? TEXT('\t') : TEXT(',');
+	}
+	uint8 Separator = (uint8)Delimiter;
+
+	FLearningDecisionTreeTable Table;
+	for (const FName& Name : ParseHeader(Cursor, HeaderEnd, Separator))
+	{
+		if (Name.IsNone() || !Table.AddColumn(Name))
+		{
+			UE_LOG(LogTemp, Error, TEXT("ImportCsv: %s has an empty or repeated column name in its header"), *FullPath);
+			return false;
+		}
+	}
+	int32 Width = Table.ColumnNames.Num();
+
+	// Split the body into line-aligned chunks
+	TArray<TPair<const uint8*, const uint8*>> Chunks;
+	for (const uint8* ChunkBegin = BodyBegin; ChunkBegin < DataEnd; )
+	{
+		const uint8* ChunkEnd = ChunkBegin + FMath::Min<int64>(ImportChunkBytes, DataEnd - ChunkBegin);
+		while (ChunkEnd < DataEnd && ChunkEnd[-1] != '\n')
+		{
+			ChunkEnd++;
+		}
+		Chunks.Emplace(ChunkBegin, ChunkEnd);
+		ChunkBegin = ChunkEnd;
+	}
+
+	// Parse and deduplicate every chunk on its own
+	TArray<FLearningDecisionTreeRowSet> ChunkRows;
+	ChunkRows.Reserve(Chunks.Num());
+	for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ChunkIndex++)
+	{
+		ChunkRows.Emplace(Width);
+	}
+	TArray<int32> ChunkLines;
+	TArray<int32> ChunkSkipped;
+	ChunkLines.SetNumZeroed(Chunks.Num());
+	ChunkSkipped.SetNumZeroed(Chunks.Num());
+
+	ParallelFor(Chunks.Num(), [&](int32 ChunkIndex)
+	{
+		LLM_SCOPE_BYTAG(LearningDecisionTree);
+		TArray<int32, TInlineAllocator<64>> Row;
+		Row.SetNumUninitialized(Width);
+
+		const uint8* ChunkEnd = Chunks[ChunkIndex].Value;
+		for (const uint8* LineBegin = Chunks[ChunkIndex].Key; LineBegin < ChunkEnd; )
+		{
+			const uint8* LineEnd = LineBegin;
+			while (LineEnd < ChunkEnd && *LineEnd != '\n')
+			{
+				LineEnd++;
+			}
+			const uint8* NextLine = LineEnd < ChunkEnd ? LineEnd + 1 : ChunkEnd;
+			if (LineEnd > LineBegin && LineEnd[-1] == '\r')
+			{
+				LineEnd--;
+			}
+
+			if (!IsBlankLine(LineBegin, LineEnd))
+			{
+				if (ParseLine(LineBegin, LineEnd, Separator, Width, Row.GetData()))
+				{
+					ChunkRows[ChunkIndex].Add(Row.GetData(), 1);
+					ChunkLines[ChunkIndex]++;
+				}
+				else
+				{
+					ChunkSkipped[ChunkIndex]++;
+				}
+			}
+			LineBegin = NextLine;
+		}
+	});
+
+	// Merge the chunks in file order, so rows keep the order in which they first appear
+	FLearningDecisionTreeRowSet Rows(Width);
+	int32 NumLines = 0;
+	int32 NumSkipped = 0;
+	for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ChunkIndex++)
+	{
+		const FLearningDecisionTreeRowSet& Chunk = ChunkRows[ChunkIndex];
+		for (int32 Index = 0; Index < Chunk.Num(); Index++)
+		{
+			Rows.Add(Chunk.GetRow(Index), Chunk.GetCounts()[Index]);
+		}
+		NumLines += ChunkLines[ChunkIndex];
+		NumSkipped += ChunkSkipped[ChunkIndex];
+	}
+	ChunkRows.Empty();
+
+	Rows.ToTable(Table.ColumnNames, OutTable);
+
+	FLearningDecisionTreeCsvStats Stats;
+	Stats.Bytes = Size;
+	INC_DWORD_STAT_BY(STAT_LearningDecisionTree_BytesRead, Size);
+	Stats.Rows = NumLines;
+	Stats.UniqueRows = Rows.Num();
+	Stats.SkippedLines = NumSkipped;
+	Stats.Seconds = (float)(FPlatformTime::Seconds() - StartTime);
+
+	if (NumSkipped > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ImportCsv: Skipped %d lines of %s that were not %d integers"), NumSkipped, *FullPath, Width);
+	}
+	UE_LOG(LogTemp, Log, TEXT("ImportCsv: %s: %d rows (%d unique) in %.3fs, %.1f MB/s, %.0f rows/s"),
+		*FullPath, Stats.Rows, Stats.UniqueRows, Stats.Seconds, Stats.GetMegabytesPerSecond(), Stats.GetRowsPerSecond());
+
+	if (OutStats)
+	{
+		*OutStats = Stats;
+	}
+	return true;
+}
+
+bool FLearningDecisionTreeTableCsv::Export(const FString& FullPath, const FLearningDecisionTreeTable& Table, FLearningDecisionTreeCsvStats* OutStats, TCHAR Delimiter, bool bExpandDuplicates)
+{
+	using namespace LearningDecisionTreeCsv;
+	LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_CsvExport);
+
+	double StartTime = FPlatformTime::Seconds();
+	ANSICHAR Separator = (ANSICHAR)Delimiter;
+	int32 NumRows = Table.GetTableRowCount();
+
+	TArray<const TArray<int32>*> Columns;
+	FString Header;
+	for (const FName& Name : Table.ColumnNames)
+	{
+		const TArray<int32>* ColumnData = Table.TableData.Find(Name);
+		if (!ColumnData || ColumnData->Num() != NumRows)
+		{
+			UE_LOG(LogTemp, Error, TEXT("ExportCsv: Column %s does not have %d rows"), *Name.ToString(), NumRows);
+			return false;
+		}
+		Columns.Add(ColumnData);
+
+		if (!Header.IsEmpty())
+		{
+			Header.AppendChar(Delimiter);
+		}
+		Header += Name.ToString();
+	}
+	Header.AppendChar(TEXT('\n'));
+
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*FullPath));
+	if (!FileWriter)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ExportCsv: Could not open %s for writing"), *FullPath);
+		return false;
+	}
+
+	FTCHARToUTF8 HeaderUtf8(*Header);
+	FileWriter->Serialize(const_cast<ANSICHAR*>(HeaderUtf8.Get()), HeaderUtf8.Length());
+
+	// Format a batch of blocks in parallel, then write them out in order.
+	// Only one batch is held in memory at a time.
+	const int32 BlocksPerBatch = FMath::Max(1, FPlatformMisc::NumberOfCoresIncludingHyperthreads()) * 2;
+	const int32 RowsPerBatch = BlocksPerBatch * ExportBlockRows;
+	TArray<TArray<ANSICHAR>> Blocks;
+
+	for (int32 BatchBegin = 0; BatchBegin < NumRows && !FileWriter->IsError(); BatchBegin += RowsPerBatch)
+	{
+		int32 BatchEnd = FMath::Min(NumRows, BatchBegin + RowsPerBatch);
+		Blocks.SetNum(FMath::DivideAndRoundUp(BatchEnd - BatchBegin, ExportBlockRows));
+
+		ParallelFor(Blocks.Num(), [&](int32 BlockIndex)
+		{
+			LLM_SCOPE_BYTAG(LearningDecisionTree);
+			TArray<ANSICHAR>& Out = Blocks[BlockIndex];
+			Out.Reset();
+
+			int32 RowBegin = BatchBegin + BlockIndex * ExportBlockRows;
+			int32 RowEnd = FMath::Min(BatchEnd, RowBegin + ExportBlockRows);
+			for (int32 Row = RowBegin; Row < RowEnd; Row++)
+			{
+				int32 LineBegin = Out.Num();
+				for (int32 Column = 0; Column < Columns.Num(); Column++)
+				{
+					if (Column > 0)
+					{
+						Out.Add(Separator);
+					}
+					AppendInt(Out, (*Columns[Column])[Row]);
+				}
+				Out.Add('\n');
+
+				int32 Repeats = bExpandDuplicates ? Table.DuplicateCounts[Row] : 1;
+				int32 LineLength = Out.Num() - LineBegin;
+				for (int32 Repeat = 1; Repeat < Repeats; Repeat++)
+				{
+					int32 CopyTo = Out.AddUninitialized(LineLength);
+					FMemory::Memcpy(Out.GetData() + CopyTo, Out.GetData() + LineBegin, LineLength);
+				}
+			}
+		});
+
+		for (TArray<ANSICHAR>& Block : Blocks)
+		{
+			FileWriter->Serialize(Block.GetData(), Block.Num());
+		}
+	}
+
+	FLearningDecisionTreeCsvStats Stats;
+	Stats.Bytes = FileWriter->TotalSize();
+	INC_DWORD_STAT_BY(STAT_LearningDecisionTree_BytesWritten, Stats.Bytes);
+	bool bWritten = !FileWriter->IsError() && FileWriter->Close();
+	FileWriter.Reset();
+	if (!bWritten)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ExportCsv: Failed to write %s"), *FullPath);
+		return false;
+	}
+
+	Stats.Rows = bExpandDuplicates ? Table.GetTotalRowCount() : NumRows;
+	Stats.UniqueRows = NumRows;
+	Stats.Seconds = (float)(FPlatformTime::Seconds() - StartTime);
+	UE_LOG(LogTemp, Log, TEXT("ExportCsv: %s: %d rows in %.3fs, %.1f MB/s, %.0f rows/s"),
+		*FullPath, Stats.Rows, Stats.Seconds, Stats.GetMegabytesPerSecond(), Stats.GetRowsPerSecond());
+
+	if (OutStats)
+	{
+		*OutStats = Stats;
+	}
+	return true;
+}
@@ -0,0 +1,129 @@
+#include "LearningDecisionTreeTableFile.h"
+#include "LearningDecisionTreeCoreAdapter.h"
+#include "Misc/Compression.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "LearningDecisionTreeCore/TableFile.h"
+THIRD_PARTY_INCLUDES_END
+
+static_assert(FLearningDecisionTreeTableFile::Magic == LearningDecisionTreeCore::FTableFile::Magic, "Table file magic differs from the core library's.");
+static_assert(FLearningDecisionTreeTableFile::Version == LearningDecisionTreeCore::FTableFile::Version, "Table file version differs from the core library's.");
+static_assert((uint8)ELearningDecisionTreeCompression::Zlib == (uint8)LearningDecisionTreeCore::ECompression::Zlib
+	&& (uint8)ELearningDecisionTreeCompression::Oodle == (uint8)LearningDecisionTreeCore::ECompression::Oodle, "Compression ids differ from the core library's.");
+
+namespace LearningDecisionTreeTableFile
+{
+	static FName GetCompressionFormat(LearningDecisionTreeCore::ECompression Compression)
+	{
+		switch (Compression)
+		{
+		case LearningDecisionTreeCore::ECompression::Zlib: return NAME_Zlib;
+		case LearningDecisionTreeCore::ECompression::Oodle: return NAME_Oodle;
+		default: return NAME_None;
+		}
+	}
+
+	/** Compresses the core's table file blocks with FCompression. */
+	class FEngineCodec final : public LearningDecisionTreeCore::ICompressionCodec
+	{
+	public:
+		virtual bool Compress(LearningDecisionTreeCore::ECompression Compression, const uint8_t* In, size_t InSize, std::vector<uint8_t>& Out) const override
+		{
+			const FName Format = GetCompressionFormat(Compression);
+			if (Format.IsNone() || InSize > (size_t)MAX_int32)
+			{
+				return false;
+			}
+
+			int32 CompressedSize = FCompression::CompressMemoryBound(Format, (int32)InSize);
+			Out.resize((size_t)CompressedSize);
+			if (!FCompression::CompressMemory(Format, Out.data(), CompressedSize, In, (int32)InSize))
+			{
+				return false;
+			}
+			Out.resize((size_t)CompressedSize);
+			return true;
+		}
+
+		virtual bool Uncompress(LearningDecisionTreeCore::ECompression Compression, const uint8_t* In, size_t InSize, uint8_t* Out, size_t OutSize) const override
+		{
+			const FName Format = GetCompressionFormat(Compression);
+			return !Format.IsNone() && InSize <= (size_t)MAX_int32 && OutSize <= (size_t)MAX_int32
+				&& FCompression::UncompressMemory(Format, Out, (int32)OutSize, In, (int32)InSize);
+		}
+	};
+
+	static const FEngineCodec EngineCodec;
+}
+
+// ============================================================================
+// FLearningDecisionTreeTableWriter
+// ============================================================================
+
+FLearningDecisionTreeTableWriter::FLearningDecisionTreeTableWriter(FArchive& InAr, ELearningDecisionTreeCompression InCompression)
+	: Ar(InAr)
+	, Compression(InCompression)
+{
+}
+
+bool FLearningDecisionTreeTableWriter::Write(const FLearningDecisionTreeTable& Table)
+{
+	Crc = 0;
+
+	LearningDecisionTreeCore::FTable CoreTable;
+	LearningDecisionTreeCoreAdapter::ToCoreTable(Table, CoreTable);
+
+	std::vector<uint8_t> Bytes;
+	if (!LearningDecisionTreeCore::WriteTable(CoreTable, Bytes, (LearningDecisionTreeCore::ECompression)Compression, &Crc, &LearningDecisionTreeTableFile::EngineCodec))
+	{
+		UE_LOG(LogTemp, Error, TEXT("SaveTable: The table has a missing column or columns of different lengths."));
+		return false;
+	}
+
+	Ar.Serialize(Bytes.data(), (int64)Bytes.size());
+	return !Ar.IsError();
+}
+
+// ============================================================================
+// FLearningDecisionTreeTableReader
+// ============================================================================
+
+FLearningDecisionTreeTableReader::FLearningDecisionTreeTableReader(FArchive& InAr)
+	: Ar(InAr)
+{
+}
+
+bool FLearningDecisionTreeTableReader::Read(FLearningDecisionTreeTable& OutTable)
+{
+	Crc = 0;
+	bLegacyFormat = false;
+
+	const int64 Size = Ar.TotalSize() - Ar.Tell();
+	if (Size < 0 || Size > MAX_int32)
+	{
+		return false;
+	}
+
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized((int32)Size);
+	Ar.Serialize(Bytes.GetData(), Size);
+	if (Ar.IsError())
+	{
+		return false;
+	}
+
+	uint32 FileMagic = 0;
+	if (Size >= (int64)sizeof(FileMagic))
+	{
+		FMemory::Memcpy(&FileMagic, Bytes.GetData(), sizeof(FileMagic));
+	}
+	bLegacyFormat = FileMagic != FLearningDecisionTreeTableFile::Magic;
+
+	LearningDecisionTreeCore::FTable CoreTable;
+	if (!LearningDecisionTreeCore::ReadTable(Bytes.GetData(), Bytes.Num(), CoreTable, &Crc, &LearningDecisionTreeTableFile::EngineCodec))
+	{
+		UE_LOG(LogTemp, Error, TEXT("LoadTable: The table file is corrupt, truncated or from a newer version."));
+		return false;
+	}
+	return LearningDecisionTreeCoreAdapter::FromCoreTable(CoreTable, OutTable);
+}
@@ -0,0 +1,401 @@
+#include "LearningDecisionTreeTableJournal.h"
+#include "LearningDecisionTreeStats.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "LearningDecisionTreeCore/Encoding.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace LearningDecisionTreeTableJournal
+{
+	using LearningDecisionTreeCore::Encoding::ZigZagEncode;
+	using LearningDecisionTreeCore::Encoding::ZigZagDecode;
+
+	/** The core library's varints, on engine arrays. */
+	static void WriteVarUInt(TArray<uint8>& Out, uint32 Value)
+	{
+		uint8 Bytes[LearningDecisionTreeCore::Encoding::MaxVarUIntSize];
+		Out.Append(Bytes, (int32)LearningDecisionTreeCore::Encoding::EncodeVarUInt(Value, Bytes));
+	}
+
+	static bool ReadVarUInt(TArrayView<const uint8> In, int32& Offset, uint32& OutValue)
+	{
+		size_t Cursor = (size_t)Offset;
+		const bool bRead = LearningDecisionTreeCore::Encoding::ReadVarUInt(In.GetData(), (size_t)In.Num(), Cursor, OutValue);
+		Offset = (int32)Cursor;
+		return bRead;
+	}
+
+	enum ERecordType : uint8
+	{
+		Record_Rows = 1,
+		Record_Column = 2
+	};
+
+	static constexpr int32 HeaderSize = 20;
+	static constexpr int32 RecordHeaderSize = 9;
+
+	/**
+	 * Validates the header and walks the records of a journal file, stopping at the first torn or corrupt record.
+	 * @param Visitor Called for every intact record. Returning false stops the walk at that record.
+	 * @return False if the file is not a journal for Snapshot.
+	 */
+	static bool ScanRecords(TArrayView<const uint8> Bytes, const FLearningDecisionTreeSnapshotId& Snapshot, int64& OutValidSize,
+		TFunctionRef<bool(uint8 Type, TArrayView<const uint8> Payload)> Visitor)
+	{
+		OutValidSize = 0;
+		if (Bytes.Num() < HeaderSize)
+		{
+			return false;
+		}
+
+		FMemoryReaderView Reader(Bytes);
+		uint32 FileMagic = 0;
+		uint16 FileVersion = 0;
+		uint16 Reserved = 0;
+		FLearningDecisionTreeSnapshotId FileSnapshot;
+		Reader << FileMagic << FileVersion << Reserved << FileSnapshot.Checksum << FileSnapshot.Size;
+
+		if (FileMagic != FLearningDecisionTreeTableJournal::Magic || FileVersion != FLearningDecisionTreeTableJournal::Version || FileSnapshot != Snapshot)
+		{
+			return false;
+		}
+
+		int32 Offset = HeaderSize;
+		OutValidSize = Offset;
+		while (Bytes.Num() - Offset >= RecordHeaderSize)
+		{
+			uint8 Type = 0;
+			uint32 PayloadSize = 0;
+			uint32 PayloadCrc = 0;
+			Reader.Seek(Offset);
+			Reader << Type << PayloadSize << PayloadCrc;
+
+			int32 PayloadOffset = Offset + RecordHeaderSize;
+			if ((int64)PayloadSize > Bytes.Num() - PayloadOffset)
+			{
+				break;
+			}
+
+			TArrayView<const uint8> Payload = Bytes.Slice(PayloadOffset, (int32)PayloadSize);
+			if (FCrc::MemCrc32(Payload.GetData(), Payload.Num()) != PayloadCrc || !Visitor(Type, Payload))
+			{
+				break;
+			}
+
+			Offset = PayloadOffset + (int32)PayloadSize;
+			OutValidSize = Offset;
+		}
+		return true;
+	}
+
+	/** Returns the number of rows in a Rows record, or -1 if the payload is malformed. */
+	static int32 CountRows(TArrayView<const uint8> Payload)
+	{
+		int32 Offset = 0;
+		uint32 Count = 0;
+		return ReadVarUInt(Payload, Offset, Count) ? (int32)Count : -1;
+	}
+}
+
+FLearningDecisionTreeTableJournal::FLearningDecisionTreeTableJournal()
+	: WritePipe(TEXT("LearningDecisionTreeJournal"))
+{
+}
+
+FLearningDecisionTreeTableJournal::~FLearningDecisionTreeTableJournal()
+{
+	Close();
+}
+
+bool FLearningDecisionTreeTableJournal::Open(const FString& InJournalPath, const FLearningDecisionTreeSnapshotId& InSnapshot)
+{
+	using namespace LearningDecisionTreeTableJournal;
+
+	Close();
+	JournalPath = InJournalPath;
+	Snapshot = InSnapshot;
+	NumRows = 0;
+	RebasedBytes = 0;
+
+	TArray<uint8> Existing;
+	int64 ValidSize = 0;
+	bool bExtendsSnapshot = FFileHelper::LoadFileToArray(Existing, *JournalPath, FILEREAD_Silent) &&
+		ScanRecords(Existing, Snapshot, ValidSize, [this](uint8 Type, TArrayView<const uint8> Payload)
+		{
+			if (Type == Record_Rows)
+			{
+				int32 Count = CountRows(Payload);
+				if (Count < 0)
+				{
+					return false;
+				}
+				NumRows += Count;
+			}
+			return true;
+		});
+
+	if (!bExtendsSnapshot)
+	{
+		return CreateEmpty();
+	}
+
+	if (ValidSize < Existing.Num())
+	{
+		// Cut off a torn tail so new records are not appended behind unreadable bytes
+		UE_LOG(LogTemp, Warning, TEXT("Table journal: Dropping %lld unreadable bytes at the end of %s"), Existing.Num() - ValidSize, *JournalPath);
+		Existing.SetNum((int32)ValidSize);
+		FString TempPath = JournalPath + TEXT(".tmp");
+		if (!FFileHelper::SaveArrayToFile(Existing, *TempPath) || !IFileManager::Get().Move(*JournalPath, *TempPath, true, true))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Table journal: Could not repair %s"), *JournalPath);
+			return false;
+		}
+	}
+
+	FileWriter.Reset(IFileManager::Get().CreateFileWriter(*JournalPath, FILEWRITE_Append));
+	return FileWriter.IsValid();
+}
+
+void FLearningDecisionTreeTableJournal::Close()
+{
+	if (FileWriter)
+	{
+		Flush(true);
+		FileWriter->Close();
+		FileWriter.Reset();
+	}
+	PendingRecords.Reset();
+	BatchValues.Reset();
+	BatchRowCount = 0;
+}
+
+bool FLearningDecisionTreeTableJournal::Reset(const FLearningDecisionTreeSnapshotId& NewSnapshot)
+{
+	// Anything still buffered is already part of the new snapshot
+	PendingRecords.Reset();
+	BatchValues.Reset();
+	BatchRowCount = 0;
+	Close();
+
+	Snapshot = NewSnapshot;
+	NumRows = 0;
+	RebasedBytes = 0;
+	return CreateEmpty();
+}
+
+bool FLearningDecisionTreeTableJournal::Rebase(const FLearningDecisionTreeSnapshotId& NewSnapshot, int64 KeepFromPosition)
+{
+	using namespace LearningDecisionTreeTableJournal;
+
+	Close();
+
+	TArray<uint8> Existing;
+	FFileHelper::LoadFileToArray(Existing, *JournalPath, FILEREAD_Silent);
+	int64 KeepFrom = FMath::Clamp<int64>(KeepFromPosition - RebasedBytes, HeaderSize, FMath::Max<int64>(Existing.Num(), HeaderSize));
+
+	TArray<uint8> Rebased;
+	FMemoryWriter Writer(Rebased);
+	uint32 FileMagic = Magic;
+	uint16 FileVersion = Version;
+	uint16 Reserved = 0;
+	FLearningDecisionTreeSnapshotId Header = NewSnapshot;
+	Writer << FileMagic << FileVersion << Reserved << Header.Checksum << Header.Size;
+	if (KeepFrom < Existing.Num())
+	{
+		Rebased.Append(Existing.GetData() + KeepFrom, Existing.Num() - (int32)KeepFrom);
+	}
+
+	FString TempPath = JournalPath + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(Rebased, *TempPath) || !IFileManager::Get().Move(*JournalPath, *TempPath, true, true))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Table journal: Could not rebase %s"), *JournalPath);
+		return false;
+	}
+
+	// Reopening counts the rows that were kept
+	int64 TotalRebasedBytes = RebasedBytes + KeepFrom - HeaderSize;
+	bool bOpened = Open(JournalPath, NewSnapshot);
+	RebasedBytes = TotalRebasedBytes;
+	return bOpened;
+}
+
+int64 FLearningDecisionTreeTableJournal::GetPosition()
+{
+	Flush(true);
+	return FileWriter ? FileWriter->Tell() + RebasedBytes : RebasedBytes;
+}
+
+bool FLearningDecisionTreeTableJournal::CreateEmpty()
+{
+	FileWriter.Reset(IFileManager::Get().CreateFileWriter(*JournalPath));
+	if (!FileWriter)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Table journal: Could not create %s"), *JournalPath);
+		return false;
+	}
+
+	uint32 FileMagic = Magic;
+	uint16 FileVersion = Version;
+	uint16 Reserved = 0;
+	*FileWriter << FileMagic << FileVersion << Reserved << Snapshot.Checksum << Snapshot.Size;
+	FileWriter->Flush();
+	return !FileWriter->IsError();
+}
+
+void FLearningDecisionTreeTableJournal::AppendRow(TArrayView<const int32> Row)
+{
+	using namespace LearningDecisionTreeTableJournal;
+
+	if (BatchRowCount > 0 && Row.Num() != BatchRowWidth)
+	{
+		CloseRowBatch();
+	}
+
+	BatchRowWidth = Row.Num();
+	for (int32 Value : Row)
+	{
+		WriteVarUInt(BatchValues, ZigZagEncode(Value));
+	}
+	BatchRowCount++;
+	NumRows++;
+
+	if (BatchValues.Num() + PendingRecords.Num() >= FlushThresholdBytes)
+	{
+		Flush(false);
+	}
+}
+
+void FLearningDecisionTreeTableJournal::AppendColumn(const FName& ColumnName)
+{
+	CloseRowBatch();
+
+	FTCHARToUTF8 Utf8(*ColumnName.ToString());
+	TArray<uint8> Payload;
+	Payload.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	AddRecord(LearningDecisionTreeTableJournal::Record_Column, Payload);
+}
+
+void FLearningDecisionTreeTableJournal::CloseRowBatch()
+{
+	using namespace LearningDecisionTreeTableJournal;
+
+	if (BatchRowCount == 0)
+	{
+		return;
+	}
+
+	TArray<uint8> Payload;
+	Payload.Reserve(BatchValues.Num() + 10);
+	WriteVarUInt(Payload, (uint32)BatchRowCount);
+	WriteVarUInt(Payload, (uint32)BatchRowWidth);
+	Payload.Append(BatchValues);
+	AddRecord(LearningDecisionTreeTableJournal::Record_Rows, Payload);
+
+	BatchValues.Reset();
+	BatchRowCount = 0;
+}
+
+void FLearningDecisionTreeTableJournal::AddRecord(uint8 Type, const TArray<uint8>& Payload)
+{
+	uint32 PayloadSize = (uint32)Payload.Num();
+	uint32 PayloadCrc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+
+	FMemoryWriter Writer(PendingRecords);
+	Writer.Seek(PendingRecords.Num());
+	Writer << Type << PayloadSize << PayloadCrc;
+	Writer.Serialize(const_cast<uint8*>(Payload.GetData()), Payload.Num());
+}
+
+void FLearningDecisionTreeTableJournal::Flush(bool bWait)
+{
+	CloseRowBatch();
+
+	if (FileWriter && PendingRecords.Num() > 0)
+	{
+		if (bAsyncWrites)
+		{
+			WritePipe.Launch(TEXT("LearningDecisionTreeJournalWrite"), [Writer = FileWriter.Get(), Bytes = MoveTemp(PendingRecords)]() mutable
+			{
+				LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_JournalWrite);
+				LLM_SCOPE_BYTAG(LearningDecisionTree);
+				INC_DWORD_STAT_BY(STAT_LearningDecisionTree_BytesWritten, Bytes.Num());
+				Writer->Serialize(Bytes.GetData(), Bytes.Num());
+				Writer->Flush();
+			});
+		}
+		else
+		{
+			LEARNINGDECISIONTREE_SCOPE(STAT_LearningDecisionTree_JournalWrite);
+			INC_DWORD_STAT_BY(STAT_LearningDecisionTree_BytesWritten, PendingRecords.Num());
+			FileWriter->Serialize(PendingRecords.GetData(), PendingRecords.Num());
+			FileWriter->Flush();
+		}
+		PendingRecords.Reset();
+	}
+
+	if (bWait)
+	{
+		WritePipe.WaitUntilEmpty();
+	}
+}
+
+bool FLearningDecisionTreeTableJournal::Replay(const FString& JournalPath, const FLearningDecisionTreeSnapshotId& Snapshot, FLearningDecisionTreeTable& Table, int32& OutNumRows, int64& OutValidSize)
+{
+	using namespace LearningDecisionTreeTableJournal;
+
+	OutNumRows = 0;
+	OutValidSize = 0;
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *JournalPath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	TArray<int32> Row;
+	return ScanRecords(Bytes, Snapshot, OutValidSize, [&Table, &Row, &OutNumRows](uint8 Type, TArrayView<const uint8> Payload)
+	{
+		if (Type == Record_Column)
+		{
+			FUTF8ToTCHAR Name(reinterpret_cast<const ANSICHAR*>(Payload.GetData()), Payload.Num());
+			Table.AddColumn(FName(FString(Name.Length(), Name.Get())));
+			return true;
+		}
+
+		if (Type == Record_Rows)
+		{
+			int32 Offset = 0;
+			uint32 Count = 0;
+			uint32 Width = 0;
+			if (!ReadVarUInt(Payload, Offset, Count) || !ReadVarUInt(Payload, Offset, Width) || (int64)Width > Payload.Num())
+			{
+				return false;
+			}
+
+			Row.SetNumUninitialized((int32)Width);
+			for (uint32 i = 0; i < Count; i++)
+			{
+				for (uint32 Column = 0; Column < Width; Column++)
+				{
+					uint32 Encoded = 0;
+					if (!ReadVarUInt(Payload, Offset, Encoded))
+					{
+						return false;
+					}
+					Row[Column] = ZigZagDecode(Encoded);
+				}
+				Table.AddRow(Row);
+				OutNumRows++;
+			}
+			return true;
+		}
+
+		// Unknown record type from a newer version: stop here rather than guess
+		return false;
+	});
+}
@@ -0,0 +1,165 @@
+#include "LearningDecisionTreeTrainCommandlet.h"
+#include "LearningDecisionTree.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "UObject/GarbageCollection.h"
+#include "UObject/UObjectHash.h"
+
+namespace LearningDecisionTreeTrain
+{
+	/** What happened to one model. */
+	struct FModelReport
+	{
+		FString TablePath;
+		FString TreePath;
+		int32 Rows = 0;
+		int32 UniqueRows = 0;
+		int32 TreeNodes = 0;
+		int64 TableFileBytes = 0;
+		int64 TreeFileBytes = 0;
+		double LoadSeconds = 0.0;
+		double BuildSeconds = 0.0;
+		double SaveSeconds = 0.0;
+		bool bSucceeded = false;
+	};
+
+	bool IsTableFile(const FString& Path)
+	{
+		FString Extension = FPaths::GetExtension(Path);
+		return Extension == TEXT("dat") || Extension == TEXT("csv") || Extension == TEXT("tsv");
+	}
+
+	/** Loads, trains and saves one model. Runs on a worker thread. */
+	void TrainModel(ULearningDecisionTree* Tree, const FString& OutputFolder, bool bWriteFlat, FModelReport& Report)
+	{
+		const FString Folder = FPaths::GetPath(Report.TablePath);
+		const FString Name = FPaths::GetBaseFilename(Report.TablePath);
+		const FString OutFolder = OutputFolder.IsEmpty() ? Folder : OutputFolder;
+		Report.TableFileBytes = IFileManager::Get().FileSize(*Report.TablePath);
+
+		double StartTime = FPlatformTime::Seconds();
+		bool bLoaded = false;
+		if (FPaths::GetExtension(Report.TablePath) == TEXT("dat"))
+		{
+			bLoaded = Tree->LoadTable(Folder, Name);
+		}
+		else
+		{
+			FLearningDecisionTreeCsvStats CsvStats;
+			bLoaded = Tree->ImportTableCsv(Folder, FPaths::GetCleanFilename(Report.TablePath), CsvStats);
+		}
+		Report.LoadSeconds = FPlatformTime::Seconds() - StartTime;
+		if (!bLoaded || Tree->GetColumnCount() < 2)
+		{
+			UE_LOG(LogTemp, Error, TEXT("LearningDecisionTreeTrain: %s has no trainable table"), *Report.TablePath);
+			return;
+		}
+		Report.Rows = Tree->GetTotalRowCount();
+		Report.UniqueRows = Tree->GetTableRowCount();
+
+		StartTime = FPlatformTime::Seconds();
+		Tree->CreateDecisionTree();
+		Report.BuildSeconds = FPlatformTime::Seconds() - StartTime;
+		Report.TreeNodes = Tree->GetMemoryReport().TreeNodes;
+
+		StartTime = FPlatformTime::Seconds();
+		Report.bSucceeded = Tree->SaveDecisionTree(OutFolder, Name);
+		if (bWriteFlat)
+		{
+			Report.bSucceeded &= Tree->SaveFlatDecisionTree(OutFolder, Name);
+		}
+		Report.SaveSeconds = FPlatformTime::Seconds() - StartTime;
+
+		Report.TreePath = FPaths::Combine(OutFolder, Name + TEXT(".tree"));
+		Report.TreeFileBytes = IFileManager::Get().FileSize(*Report.TreePath);
+	}
+}
+
+ULearningDecisionTreeTrainCommandlet::ULearningDecisionTreeTrainCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 ULearningDecisionTreeTrainCommandlet::Main(const FString& Params)
+{
+	using namespace LearningDecisionTreeTrain;
+
+	TArray<FString> TablePaths;
+	FString TablesParam;
+	if (FParse::Value(*Params, TEXT("Tables="), TablesParam, false))
+	{
+		TablesParam.ParseIntoArray(TablePaths, TEXT("+"));
+	}
+	FString Dir;
+	if (FParse::Value(*Params, TEXT("Dir="), Dir))
+	{
+		TArray<FString> Found;
+		IFileManager::Get().FindFiles(Found, *Dir, nullptr);
+		Found.Sort();
+		for (const FString& File : Found)
+		{
+			TablePaths.Add(FPaths::Combine(Dir, File));
+		}
+	}
+	TablePaths.RemoveAll([](const FString& Path) { return !IsTableFile(Path); });
+
+	if (TablePaths.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("LearningDecisionTreeTrain: No table files. Use -Tables=<a.dat>+<b.dat> or -Dir=<folder>"));
+		return 1;
+	}
+
+	FString OutputFolder;
+	FParse::Value(*Params, TEXT("Output="), OutputFolder);
+	const bool bWriteFlat = FParse::Param(*Params, TEXT("Flat"));
+	const bool bSingleThread = FParse::Param(*Params, TEXT("SingleThread"));
+
+	TArray<FModelReport> Reports;
+	Reports.SetNum(TablePaths.Num());
+	Trees.Reset();
+	for (int32 Index = 0; Index < TablePaths.Num(); Index++)
+	{
+		Reports[Index].TablePath = TablePaths[Index];
+		Trees.Add(NewObject<ULearningDecisionTree>(this));
+	}
+
+	double StartTime = FPlatformTime::Seconds();
+	{
+		// Nodes are UObjects created on the workers; keep GC from running until every build is done
+		FGCScopeGuard GCGuard;
+		ParallelFor(Trees.Num(), [this, &Reports, &OutputFolder, bWriteFlat](int32 Index)
+		{
+			TrainModel(Trees[Index], OutputFolder, bWriteFlat, Reports[Index]);
+		}, bSingleThread ? EParallelForFlags::ForceSingleThread : EParallelForFlags::Unbalanced);
+	}
+	double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// Objects created off the game thread are flagged as async; hand them over to the game thread
+	for (ULearningDecisionTree* Tree : Trees)
+	{
+		ForEachObjectWithOuter(Tree, [](UObject* Object)
+		{
+			Object->AtomicallyClearInternalFlags(EInternalObjectFlags::Async);
+		});
+	}
+
+	int32 NumFailed = 0;
+	UE_LOG(LogTemp, Display, TEXT("LearningDecisionTreeTrain: %-32s %10s %10s %8s %10s %10s %10s %12s %12s"),
+		TEXT("Model"), TEXT("Rows"), TEXT("Unique"), TEXT("Nodes"), TEXT("Load ms"), TEXT("Build ms"), TEXT("Save ms"), TEXT("Table KB"), TEXT("Tree KB"));
+	for (const FModelReport& Report : Reports)
+	{
+		NumFailed += Report.bSucceeded ? 0 : 1;
+		UE_LOG(LogTemp, Display, TEXT("LearningDecisionTreeTrain: %-32s %10d %10d %8d %10.1f %10.1f %10.1f %12.1f %12.1f%s"),
+			*FPaths::GetBaseFilename(Report.TablePath), Report.Rows, Report.UniqueRows, Report.TreeNodes,
+			Report.LoadSeconds * 1000.0, Report.BuildSeconds * 1000.0, Report.SaveSeconds * 1000.0,
+			Report.TableFileBytes / 1024.0, Report.TreeFileBytes / 1024.0, Report.bSucceeded ? TEXT("") : TEXT("  FAILED"));
+	}
+	UE_LOG(LogTemp, Display, TEXT("LearningDecisionTreeTrain: %d models in %.2fs, %d failed"), Reports.Num(), TotalSeconds, NumFailed);
+
+	Trees.Reset();
+	return NumFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,735 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LearningDecisionTree.h"
+#include "LearningDecisionTreeBenchmark.h"
+#include "LearningDecisionTreeCoreAdapter.h"
+#include "LearningDecisionTreeScheduler.h"
+#include "LearningDecisionTreeSynthetic.h"
+#include "LearningDecisionTreeTyped.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTLS.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/GCObjectScopeGuard.h"
+#include "UObject/Package.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "LearningDecisionTreeCore/TableFile.h"
+THIRD_PARTY_INCLUDES_END
+
+#include <atomic>
+
+namespace LearningDecisionTreeTests
+{
+	constexpr auto TestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	FString GetTestFolder()
+	{
+		return FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("LearningDecisionTree"));
+	}
+
+	/** A tree trained on a small noise-free synthetic table. */
+	ULearningDecisionTree* CreateTrainedTree(const FLearningDecisionTreeSyntheticSpec& Spec)
+	{
+		ULearningDecisionTree* Tree = NewObject<ULearningDecisionTree>(GetTransientPackage());
+		FLearningDecisionTreeSyntheticData::GenerateTable(Spec, Tree->Table);
+		Tree->CreateDecisionTree();
+		return Tree;
+	}
+
+	enum class EWeapon : uint8 { Sword, Bow, Staff, Count };
+	enum class EHealth : uint8 { Low, Medium, High, Count };
+	enum class EAction : uint8 { Attack, Retreat, Heal, Count };
+
+	FLearningDecisionTreeSyntheticSpec MakeSmallSpec()
+	{
+		FLearningDecisionTreeSyntheticSpec Spec;
+		Spec.NumRows = 2000;
+		Spec.NumFeatures = 5;
+		Spec.Cardinality = 3;
+		Spec.NumActions = 3;
+		Spec.NumInformativeFeatures = 2;
+		Spec.LabelNoise = 0.0f;
+		return Spec;
+	}
+
+	/**
+	 * Counts the heap allocations of the thread that called Start(), by standing in for GMalloc until Stop().
+	 * Other threads pass straight through. Never destroyed, so a thread that still holds it keeps working.
+	 */
+	class FAllocationCounter final : public FMalloc
+	{
+	public:
+		static FAllocationCounter& Get()
+		{
+			static FAllocationCounter* Counter = new FAllocationCounter();
+			return *Counter;
+		}
+
+		void Start()
+		{
+			Inner = GMalloc;
+			NumAllocations = 0;
+			CountedThread = FPlatformTLS::GetCurrentThreadId();
+			GMalloc = this;
+		}
+
+		/** Stops counting and returns the allocations made since Start(). */
+		int32 Stop()
+		{
+			GMalloc = Inner;
+			CountedThread = 0;
+			return NumAllocations;
+		}
+
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Malloc(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+		{
+			if (Size > 0)
+			{
+				CountAllocation();
+			}
+			return Inner->Realloc(Original, Size, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override { return Inner->QuantizeSize(Size, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("LearningDecisionTreeAllocationCounter"); }
+
+	private:
+		void CountAllocation()
+		{
+			if (FPlatformTLS::GetCurrentThreadId() == CountedThread)
+			{
+				NumAllocations++;
+			}
+		}
+
+		FMalloc* Inner = nullptr;
+		std::atomic<uint32> CountedThread{ 0 };
+		/** Only written by the counted thread. */
+		int32 NumAllocations = 0;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeSyntheticTest, "LearningDecisionTree.Synthetic.Deterministic", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeSyntheticTest::RunTest(const FString& Parameters)
+{
+	FLearningDecisionTreeSyntheticSpec Spec = LearningDecisionTreeTests::MakeSmallSpec();
+	const int32 Width = Spec.NumFeatures + 1;
+
+	TArray<int32> Rows;
+	TArray<int32> SameRows;
+	FLearningDecisionTreeSyntheticData::Generate(Spec, Rows);
+	FLearningDecisionTreeSyntheticData::Generate(Spec, SameRows);
+	TestEqual(TEXT("Value count"), Rows.Num(), Spec.NumRows * Width);
+	TestTrue(TEXT("Same seed gives the same rows"), Rows == SameRows);
+
+	for (int32 Row = 0; Row < Spec.NumRows; Row++)
+	{
+		TArrayView<const int32> Features(Rows.GetData() + Row * Width, Spec.NumFeatures);
+		if (!TestEqual(TEXT("Noise-free label follows the rule"), Rows[Row * Width + Spec.NumFeatures], FLearningDecisionTreeSyntheticData::Label(Spec, Features)))
+		{
+			break;
+		}
+	}
+
+	FLearningDecisionTreeTable Table;
+	FLearningDecisionTreeSyntheticData::GenerateTable(Spec, Table);
+	TestEqual(TEXT("Table keeps every sample"), Table.TotalRows, Spec.NumRows);
+	TestEqual(TEXT("Table columns"), Table.ColumnNames.Num(), Width);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeRefreshTableTest, "LearningDecisionTree.Table.RefreshKeepsTotalRows", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeRefreshTableTest::RunTest(const FString& Parameters)
+{
+	FLearningDecisionTreeTable Table;
+	Table.AddColumn(TEXT("A"));
+	Table.AddColumn(TEXT("B"));
+	Table.AddColumn(TEXT("Action"));
+	Table.AddRow({ 0, 0, 1 });
+	Table.AddRow({ 0, 1, 1 });
+	Table.AddRow({ 0, 1, 1 });
+	Table.AddRow({ 1, 0, 0 });
+	TestEqual(TEXT("Duplicate added rows are counted"), Table.TotalRows, 4);
+
+	// Without B the first three rows are the same, and RemoveColumn() merges them through RefreshTable()
+	Table.RemoveColumn(TEXT("B"));
+	Table.RefreshTable();
+	TestEqual(TEXT("Rows merged"), Table.GetTableRowCount(), 2);
+	TestEqual(TEXT("Merged row counts"), Table.GetDuplicateCount(0), 3);
+	TestEqual(TEXT("Merged rows still count"), Table.TotalRows, 4);
+	TestEqual(TEXT("State probability over every sample"), Table.IndividualStateProbability(TEXT("A"), 0), 0.75f);
+	TestEqual(TEXT("Action probability over every sample"), Table.IndividualStateProbability(TEXT("Action"), 0), 0.25f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeLearnsRuleTest, "LearningDecisionTree.Training.LearnsNoiseFreeRule", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeLearnsRuleTest::RunTest(const FString& Parameters)
+{
+	FLearningDecisionTreeSyntheticSpec Spec = LearningDecisionTreeTests::MakeSmallSpec();
+	ULearningDecisionTree* Tree = LearningDecisionTreeTests::CreateTrainedTree(Spec);
+	FGCObjectScopeGuard TreeGuard(Tree);
+
+	TArray<int32> Rows;
+	FLearningDecisionTreeSyntheticData::Generate(Spec, Rows);
+
+	const int32 Width = Spec.NumFeatures + 1;
+	FRandomStream RandomStream(Spec.Seed);
+	for (int32 Row = 0; Row < Spec.NumRows; Row++)
+	{
+		TArrayView<const int32> Features(Rows.GetData() + Row * Width, Spec.NumFeatures);
+		if (!TestEqual(TEXT("Prediction"), Tree->EvalRow(Features, RandomStream, true), Rows[Row * Width + Spec.NumFeatures]))
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeTimeSlicedBuildTest, "LearningDecisionTree.Training.TimeSlicedBuild", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeTimeSlicedBuildTest::RunTest(const FString& Parameters)
+{
+	FLearningDecisionTreeSyntheticSpec Spec = LearningDecisionTreeTests::MakeSmallSpec();
+	Spec.LabelNoise = 0.2f;
+	ULearningDecisionTree* Tree = LearningDecisionTreeTests::CreateTrainedTree(Spec);
+	FGCObjectScopeGuard TreeGuard(Tree);
+
+	ULearningDecisionTree* Sliced = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard SlicedGuard(Sliced);
+	Sliced->Table = Tree->Table;
+	Sliced->CreateDecisionTree();
+	const uint32 OldVersion = Sliced->GetTreeVersion();
+
+	Sliced->BeginDecisionTreeBuild();
+	int32 NumTicks = 0;
+	while (!Sliced->TickBuild(0.0f))
+	{
+		NumTicks++;
+		TestEqual(TEXT("The old tree stays live during the build"), Sliced->GetTreeVersion(), OldVersion);
+		TestTrue(TEXT("Nodes are queued"), Sliced->GetBuildProgress().NodesPending > 0);
+	}
+	TestTrue(TEXT("A zero budget explodes one node per tick"), NumTicks > 1);
+	TestEqual(TEXT("One node per tick"), Sliced->GetBuildProgress().NodesExploded, NumTicks + 1);
+	TestFalse(TEXT("Build finished"), Sliced->IsBuildInProgress());
+	TestNotEqual(TEXT("The new tree replaced the old one"), Sliced->GetTreeVersion(), OldVersion);
+
+	TArray<int32> Rows;
+	FLearningDecisionTreeSyntheticData::Generate(Spec, Rows);
+	const int32 Width = Spec.NumFeatures + 1;
+	FRandomStream RandomStream(Spec.Seed);
+	for (int32 Row = 0; Row < Spec.NumRows; Row++)
+	{
+		TArrayView<const int32> Features(Rows.GetData() + Row * Width, Spec.NumFeatures);
+		if (!TestEqual(TEXT("Time-sliced tree predicts the same"), Sliced->EvalRow(Features, RandomStream, true), Tree->EvalRow(Features, RandomStream, true)))
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeReuseSubtreesTest, "LearningDecisionTree.Training.ReuseUnchangedSubtrees", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeReuseSubtreesTest::RunTest(const FString& Parameters)
+{
+	FLearningDecisionTreeSyntheticSpec Spec = LearningDecisionTreeTests::MakeSmallSpec();
+	Spec.LabelNoise = 0.2f;
+	TArray<int32> Rows;
+	FLearningDecisionTreeSyntheticData::Generate(Spec, Rows);
+	const int32 Width = Spec.NumFeatures + 1;
+
+	ULearningDecisionTree* Tree = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard TreeGuard(Tree);
+	Tree->bReuseUnchangedSubtrees = true;
+	FLearningDecisionTreeSyntheticData::GenerateTable(Spec, Tree->Table);
+	Tree->CreateDecisionTree();
+	TestEqual(TEXT("Nothing to reuse on the first build"), Tree->GetReusedSubtreeCount(), 0);
+
+	const int32 NumNodes = Tree->GetMemoryReport().TreeNodes;
+	Tree->CreateDecisionTree();
+	TestEqual(TEXT("An unchanged table reuses the whole tree"), Tree->GetReusedSubtreeCount(), 1);
+	TestEqual(TEXT("Same tree"), Tree->GetMemoryReport().TreeNodes, NumNodes);
+
+	// A few more samples only change the subsets along their paths
+	for (int32 Row = 0; Row < 5; Row++)
+	{
+		Tree->AddRow(TArray<int32>(Rows.GetData() + Row * Width, Width));
+	}
+	Tree->BeginDecisionTreeBuild();
+	while (!Tree->TickBuild(0.0f))
+	{
+	}
+	TestTrue(TEXT("Unchanged subtrees are reused"), Tree->GetReusedSubtreeCount() > 1);
+
+	ULearningDecisionTree* Fresh = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard FreshGuard(Fresh);
+	Fresh->Table = Tree->Table;
+	Fresh->CreateDecisionTree();
+
+	FRandomStream RandomStream(Spec.Seed);
+	for (int32 Row = 0; Row < Spec.NumRows; Row++)
+	{
+		TArrayView<const int32> Features(Rows.GetData() + Row * Width, Spec.NumFeatures);
+		if (!TestEqual(TEXT("Rebuilt tree predicts the same"), Tree->EvalRow(Features, RandomStream, true), Fresh->EvalRow(Features, RandomStream, true)))
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeFeatureSelectionTest, "LearningDecisionTree.Training.FeatureSelection", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeFeatureSelectionTest::RunTest(const FString& Parameters)
+{
+	// The action follows Health; Team is constant, Copy repeats Health, and Weapon tells nothing about the action
+	ULearningDecisionTree* Tree = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard TreeGuard(Tree);
+	Tree->AddColumn(TEXT("Team"));
+	Tree->AddColumn(TEXT("Weapon"));
+	Tree->AddColumn(TEXT("Health"));
+	Tree->AddColumn(TEXT("Copy"));
+	Tree->AddColumn(TEXT("Action"));
+	for (int32 Weapon = 0; Weapon < 3; Weapon++)
+	{
+		for (int32 Health = 0; Health < 3; Health++)
+		{
+			Tree->AddRow({ 0, Weapon, Health, Health, 2 - Health });
+		}
+	}
+
+	Tree->bSelectFeatures = true;
+	Tree->FeatureSelectionSettings.MinMutualInformation = 0.01f;
+	Tree->CreateDecisionTree();
+
+	const FLearningDecisionTreeFeatureSelection Selection = Tree->GetFeatureSelection();
+	TestEqual(TEXT("Kept features"), Selection.KeptFeatures, TArray<int32>({ 2 }));
+	TestEqual(TEXT("Constant"), Selection.NumConstant, 1);
+	TestEqual(TEXT("Duplicate"), Selection.NumDuplicate, 1);
+	TestEqual(TEXT("Low information"), Selection.NumLowInformation, 1);
+
+	const ULearningDecisionTreeDecisionNode* Root = Cast<ULearningDecisionTreeDecisionNode>(Tree->LDTRoot[0]);
+	TestTrue(TEXT("The split is mapped back to the full row"), Root && Root->FeatureIndex == 2);
+
+	FRandomStream RandomStream(0);
+	for (int32 Health = 0; Health < 3; Health++)
+	{
+		const int32 Row[] = { 0, 1, Health, Health };
+		TestEqual(TEXT("Eval takes full rows"), Tree->EvalRow(Row, RandomStream, true), 2 - Health);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeTypedTest, "LearningDecisionTree.Training.Typed", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeTypedTest::RunTest(const FString& Parameters)
+{
+	using namespace LearningDecisionTreeTests;
+	using FTypedTree = TLearningDecisionTree<EWeapon, EHealth, EAction>;
+	static_assert(sizeof(FTypedTree::FRow) == 2, "Rows of small enums are stored as bytes.");
+
+	FTypedTree Tree;
+	FGCObjectScopeGuard ModelGuard(Tree.GetModel());
+	TestEqual(TEXT("Columns"), Tree.GetModel()->GetColumnCount(), 3);
+
+	// Retreat on low health, heal at medium health unless holding a sword
+	auto Rule = [](EWeapon Weapon, EHealth Health)
+	{
+		return Health == EHealth::Low ? EAction::Retreat : (Health == EHealth::Medium && Weapon != EWeapon::Sword ? EAction::Heal : EAction::Attack);
+	};
+	for (int32 Weapon = 0; Weapon < (int32)EWeapon::Count; Weapon++)
+	{
+		for (int32 Health = 0; Health < (int32)EHealth::Count; Health++)
+		{
+			Tree.AddRow(FTypedTree::MakeRow((EWeapon)Weapon, (EHealth)Health), Rule((EWeapon)Weapon, (EHealth)Health));
+		}
+	}
+	Tree.CreateDecisionTree();
+	TestTrue(TEXT("Compiled"), Tree.IsCompiled());
+
+	// A typed tree over a model loaded by untyped code predicts the same
+	const FString Folder = GetTestFolder();
+	TestTrue(TEXT("SaveFlatDecisionTree"), Tree.GetModel()->SaveFlatDecisionTree(Folder, TEXT("Typed")));
+	ULearningDecisionTree* Loaded = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard LoadedGuard(Loaded);
+	TestTrue(TEXT("LoadFlatDecisionTree"), Loaded->LoadFlatDecisionTree(Folder, TEXT("Typed")));
+	FTypedTree Shared(Loaded);
+	TestTrue(TEXT("Flat model compiled"), Shared.IsCompiled());
+
+	FRandomStream RandomStream(0);
+	for (int32 Weapon = 0; Weapon < (int32)EWeapon::Count; Weapon++)
+	{
+		for (int32 Health = 0; Health < (int32)EHealth::Count; Health++)
+		{
+			FTypedTree::FRow Row = FTypedTree::MakeRow((EWeapon)Weapon, (EHealth)Health);
+			const EAction Expected = Rule((EWeapon)Weapon, (EHealth)Health);
+			TestTrue(TEXT("Typed prediction"), Tree.MostLikelyAction(Row) == Expected);
+			TestTrue(TEXT("Typed sample of a pure leaf"), Tree.Eval(Row, RandomStream) == Expected);
+			TestTrue(TEXT("Typed prediction on the loaded model"), Shared.MostLikelyAction(Row) == Expected);
+
+			const int32 UntypedRow[] = { Weapon, Health };
+			TestEqual(TEXT("Untyped prediction"), Tree.GetModel()->EvalRow(UntypedRow, RandomStream, true), (int32)Expected);
+		}
+	}
+
+	// Health splits on every path, so a state past the enum's end is tested and rejected
+	const FTypedTree::FRow BadRow = FTypedTree::MakeRow(EWeapon::Sword, (EHealth)7);
+	TestFalse(TEXT("Out-of-range state has no prediction"), Tree.MostLikelyAction(BadRow).IsSet());
+	TestFalse(TEXT("Out-of-range state has no sample"), Tree.Eval(BadRow, RandomStream).IsSet());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeRoundTripTest, "LearningDecisionTree.Persistence.RoundTrip", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeRoundTripTest::RunTest(const FString& Parameters)
+{
+	FLearningDecisionTreeSyntheticSpec Spec = LearningDecisionTreeTests::MakeSmallSpec();
+	Spec.LabelNoise = 0.2f;
+	ULearningDecisionTree* Tree = LearningDecisionTreeTests::CreateTrainedTree(Spec);
+	FGCObjectScopeGuard TreeGuard(Tree);
+
+	ULearningDecisionTree* Loaded = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard LoadedGuard(Loaded);
+
+	const FString Folder = LearningDecisionTreeTests::GetTestFolder();
+	TestTrue(TEXT("SaveTable"), Tree->SaveTable(Folder, TEXT("RoundTrip"), ELearningDecisionTreeCompression::Zlib));
+	TestTrue(TEXT("LoadTable"), Loaded->LoadTable(Folder, TEXT("RoundTrip")));
+	TestTrue(TEXT("Columns survive"), Loaded->Table.ColumnNames == Tree->Table.ColumnNames);
+	TestTrue(TEXT("Counts survive"), Loaded->Table.DuplicateCounts == Tree->Table.DuplicateCounts);
+	TestEqual(TEXT("Total rows survive"), Loaded->Table.TotalRows, Tree->Table.TotalRows);
+	for (const FName& Column : Tree->Table.ColumnNames)
+	{
+		const TArray<int32>* LoadedColumn = Loaded->Table.TableData.Find(Column);
+		TestTrue(*FString::Printf(TEXT("Column %s survives"), *Column.ToString()), LoadedColumn && *LoadedColumn == Tree->Table.TableData[Column]);
+	}
+
+	TestTrue(TEXT("SaveDecisionTree"), Tree->SaveDecisionTree(Folder, TEXT("RoundTrip")));
+	TestTrue(TEXT("LoadDecisionTree"), Loaded->LoadDecisionTree(Folder, TEXT("RoundTrip")));
+
+	TArray<int32> Rows;
+	FLearningDecisionTreeSyntheticData::Generate(Spec, Rows);
+	const int32 Width = Spec.NumFeatures + 1;
+	FRandomStream RandomStream(Spec.Seed);
+	for (int32 Row = 0; Row < Spec.NumRows; Row++)
+	{
+		TArrayView<const int32> Features(Rows.GetData() + Row * Width, Spec.NumFeatures);
+		if (!TestEqual(TEXT("Loaded tree predicts the same"), Loaded->EvalRow(Features, RandomStream, true), Tree->EvalRow(Features, RandomStream, true)))
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeSharedSubtreesTest, "LearningDecisionTree.Persistence.SharedSubtrees", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeSharedSubtreesTest::RunTest(const FString& Parameters)
+{
+	// Weapons 0 and 2 lead to the same leaf, and so do 1 and 3
+	ULearningDecisionTree* Tree = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard TreeGuard(Tree);
+	Tree->AddColumn(TEXT("Weapon"));
+	Tree->AddColumn(TEXT("Action"));
+	for (int32 Weapon = 0; Weapon < 4; Weapon++)
+	{
+		Tree->AddRow({ Weapon, Weapon % 2 });
+	}
+	Tree->CreateDecisionTree();
+
+	FLearningDecisionTreeShareReport Report = Tree->ShareIdenticalSubtrees();
+	TestEqual(TEXT("Nodes before"), Report.NodesBefore, 5);
+	TestEqual(TEXT("Identical leaves are merged"), Report.NodesAfter, 3);
+	TestTrue(TEXT("Memory shrinks"), Report.TreeBytesAfter < Report.TreeBytesBefore);
+
+	const FString Folder = LearningDecisionTreeTests::GetTestFolder();
+	ULearningDecisionTree* Loaded = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard LoadedGuard(Loaded);
+	TestTrue(TEXT("SaveDecisionTree"), Tree->SaveDecisionTree(Folder, TEXT("SharedSubtrees")));
+	TestTrue(TEXT("LoadDecisionTree"), Loaded->LoadDecisionTree(Folder, TEXT("SharedSubtrees")));
+	TestEqual(TEXT("Sharing survives a round trip"), Loaded->GetMemoryReport().TreeNodes, Report.NodesAfter);
+
+	FRandomStream RandomStream(0);
+	for (int32 Weapon = 0; Weapon < 4; Weapon++)
+	{
+		const int32 Row[] = { Weapon };
+		TestEqual(TEXT("Shared tree predicts the same"), Tree->EvalRow(Row, RandomStream, true), Weapon % 2);
+		TestEqual(TEXT("Loaded shared tree predicts the same"), Loaded->EvalRow(Row, RandomStream, true), Weapon % 2);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeCoreTest, "LearningDecisionTree.Core.SharedFormats", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeCoreTest::RunTest(const FString& Parameters)
+{
+	FLearningDecisionTreeSyntheticSpec Spec = LearningDecisionTreeTests::MakeSmallSpec();
+	Spec.LabelNoise = 0.2f;
+	ULearningDecisionTree* Tree = LearningDecisionTreeTests::CreateTrainedTree(Spec);
+	FGCObjectScopeGuard TreeGuard(Tree);
+
+	// The node builder grows UObject nodes and stays in the plugin; the core builder must write the same flat tree
+	TArray<uint8> EngineBytes;
+	TestTrue(TEXT("Flatten the node tree"), FLearningDecisionTreeFlatView::Build(Tree->LDTRoot[0], EngineBytes));
+	TSharedPtr<FLearningDecisionTreeFlatModel> CoreModel = LearningDecisionTreeCoreAdapter::BuildFlatModel(Tree->Table);
+	if (TestTrue(TEXT("Core builds"), CoreModel.IsValid()))
+	{
+		TArrayView<const uint8> CoreBytes = CoreModel->GetView().GetBytes();
+		TestTrue(TEXT("Same bytes"), CoreBytes.Num() == EngineBytes.Num() && FMemory::Memcmp(CoreBytes.GetData(), EngineBytes.GetData(), EngineBytes.Num()) == 0);
+	}
+	TSharedPtr<FLearningDecisionTreeFlatModel> LevelWiseModel = LearningDecisionTreeCoreAdapter::BuildFlatModel(Tree->Table, LearningDecisionTreeCore::EBuildMode::LevelWise);
+	if (TestTrue(TEXT("Level-wise core builds"), LevelWiseModel.IsValid()))
+	{
+		TArrayView<const uint8> LevelWiseBytes = LevelWiseModel->GetView().GetBytes();
+		TestTrue(TEXT("Same bytes level-wise"), LevelWiseBytes.Num() == EngineBytes.Num() && FMemory::Memcmp(LevelWiseBytes.GetData(), EngineBytes.GetData(), EngineBytes.Num()) == 0);
+	}
+
+	ULearningDecisionTree* FlatTree = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard FlatTreeGuard(FlatTree);
+	FlatTree->Table = Tree->Table;
+	TestTrue(TEXT("CreateFlatDecisionTree"), FlatTree->CreateFlatDecisionTree());
+	TestTrue(TEXT("No node objects"), FlatTree->LDTRoot.Num() == 0 && FlatTree->GetFlatTree().IsValid());
+
+	TArray<int32> Rows;
+	FLearningDecisionTreeSyntheticData::Generate(Spec, Rows);
+	const int32 Width = Spec.NumFeatures + 1;
+	FRandomStream RandomStream(Spec.Seed);
+	for (int32 Row = 0; Row < Spec.NumRows; Row++)
+	{
+		TArrayView<const int32> Features(Rows.GetData() + Row * Width, Spec.NumFeatures);
+		if (!TestEqual(TEXT("Flat tree predicts the same"), FlatTree->EvalRow(Features, RandomStream, true), Tree->EvalRow(Features, RandomStream, true)))
+		{
+			break;
+		}
+	}
+
+	// The plugin reads and writes table files through the core, adding engine compression to its blocks
+	TArray<uint8> EngineFile;
+	FMemoryWriter Writer(EngineFile);
+	FLearningDecisionTreeTableWriter TableWriter(Writer, ELearningDecisionTreeCompression::Oodle);
+	TestTrue(TEXT("Engine writes an Oodle table"), TableWriter.Write(Tree->Table));
+	FMemoryReader Reader(EngineFile);
+	FLearningDecisionTreeTableReader TableReader(Reader);
+	FLearningDecisionTreeTable Loaded;
+	TestTrue(TEXT("Engine reads it back"), TableReader.Read(Loaded));
+	TestTrue(TEXT("Same snapshot"), !TableReader.IsLegacyFormat() && TableReader.GetChecksum() == TableWriter.GetChecksum());
+	TestTrue(TEXT("Columns survive"), Loaded.ColumnNames == Tree->Table.ColumnNames && Loaded.DuplicateCounts == Tree->Table.DuplicateCounts);
+
+	// Uncompressed files need no engine codec, so the offline tools read them
+	TArray<uint8> PlainFile;
+	FMemoryWriter PlainWriter(PlainFile);
+	TestTrue(TEXT("Engine writes a plain table"), FLearningDecisionTreeTableWriter(PlainWriter).Write(Tree->Table));
+	LearningDecisionTreeCore::FTable CoreTable;
+	TestTrue(TEXT("Core reads the engine's table"), LearningDecisionTreeCore::ReadTable(PlainFile.GetData(), PlainFile.Num(), CoreTable));
+
+	FLearningDecisionTreeTable Converted;
+	TestTrue(TEXT("FromCoreTable"), LearningDecisionTreeCoreAdapter::FromCoreTable(CoreTable, Converted));
+	for (const FName& Column : Tree->Table.ColumnNames)
+	{
+		const TArray<int32>* ConvertedColumn = Converted.TableData.Find(Column);
+		TestTrue(*FString::Printf(TEXT("Column %s converts"), *Column.ToString()), ConvertedColumn && *ConvertedColumn == Tree->Table.TableData[Column]);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeEvalAllocationsTest, "LearningDecisionTree.Eval.NoAllocations", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeEvalAllocationsTest::RunTest(const FString& Parameters)
+{
+	auto CheckNoAllocations = [this](const TCHAR* What, ULearningDecisionTree* Tree, const TArray<TArray<int32>>& Rows, int32 Seed)
+	{
+		// The node builder's relative-column Eval agrees with the feature-index traversal, without filtered rows
+		FRandomStream RandomStream(Seed);
+		for (const TArray<int32>& Row : Rows)
+		{
+			if (!TestEqual(FString::Printf(TEXT("%s: Node Eval"), What), Tree->LDTRoot[0]->Eval(Row), Tree->EvalRow(Row, RandomStream, true)))
+			{
+				break;
+			}
+		}
+
+		FLearningDecisionTreeEvalContext Context(Seed);
+		int64 Checksum = 0;
+		auto EvalBatch = [&]()
+		{
+			for (const TArray<int32>& Row : Rows)
+			{
+				Tree->RefreshStates(Row);
+				Checksum += Tree->Eval();
+				ULearningDecisionTree::RefreshContextStates(Context, Row);
+				Checksum += Tree->EvalWithContext(Context);
+				Checksum += Tree->EvalRow(Row, Context);
+				Checksum += Tree->EvalRow(Row, RandomStream, true);
+				if (Tree->LDTRoot.Num() > 0)
+				{
+					Checksum += Tree->LDTRoot[0]->Eval(Row);
+				}
+			}
+		};
+
+		// Buffers grow on the first batch; every batch after that must not touch the heap
+		auto CountAllocations = [&]()
+		{
+			EvalBatch();
+			LearningDecisionTreeTests::FAllocationCounter& Counter = LearningDecisionTreeTests::FAllocationCounter::Get();
+			Counter.Start();
+			for (int32 Batch = 0; Batch < 4; Batch++)
+			{
+				EvalBatch();
+			}
+			return Counter.Stop();
+		};
+
+		TestEqual(FString::Printf(TEXT("%s: Node tree evaluation allocations"), What), CountAllocations(), 0);
+		TestTrue(FString::Printf(TEXT("%s: CreateFlatDecisionTree"), What), Tree->CreateFlatDecisionTree());
+		TestEqual(FString::Printf(TEXT("%s: Flat tree evaluation allocations"), What), CountAllocations(), 0);
+		TestTrue(FString::Printf(TEXT("%s: Evaluations ran"), What), Checksum != 0);
+	};
+
+	FLearningDecisionTreeSyntheticSpec Spec = LearningDecisionTreeTests::MakeSmallSpec();
+	ULearningDecisionTree* Tree = LearningDecisionTreeTests::CreateTrainedTree(Spec);
+	FGCObjectScopeGuard TreeGuard(Tree);
+
+	TArray<int32> Data;
+	FLearningDecisionTreeSyntheticData::Generate(Spec, Data);
+	const int32 Width = Spec.NumFeatures + 1;
+	TArray<TArray<int32>> Rows;
+	for (int32 Row = 0; Row < 500; Row++)
+	{
+		Rows.Emplace(Data.GetData() + Row * Width, Spec.NumFeatures);
+	}
+	CheckNoAllocations(TEXT("Small tree"), Tree, Rows, Spec.Seed);
+
+	// One-hot rows with alternating actions, plus the all-zero row: every split peels off one row,
+	// so the tree is as deep as it has features, deeper than the paths' inline storage
+	constexpr int32 NumDeepFeatures = 24;
+	ULearningDecisionTree* DeepTree = NewObject<ULearningDecisionTree>(GetTransientPackage());
+	FGCObjectScopeGuard DeepTreeGuard(DeepTree);
+	for (int32 Feature = 0; Feature < NumDeepFeatures; Feature++)
+	{
+		DeepTree->Table.AddColumn(*FString::Printf(TEXT("F%d"), Feature));
+	}
+	DeepTree->Table.AddColumn(TEXT("Action"));
+	TArray<TArray<int32>> DeepRows;
+	for (int32 Hot = 0; Hot <= NumDeepFeatures; Hot++)
+	{
+		TArray<int32>& Row = DeepRows.AddZeroed_GetRef();
+		Row.SetNumZeroed(NumDeepFeatures);
+		if (Hot < NumDeepFeatures)
+		{
+			Row[Hot] = 1;
+		}
+		TArray<int32> TableRow = Row;
+		TableRow.Add(Hot < NumDeepFeatures ? Hot % 2 : 1);
+		DeepTree->Table.AddRow(TableRow);
+	}
+	DeepTree->CreateDecisionTree();
+
+	FLearningDecisionTreePath Path;
+	DeepTree->FindLeaf(DeepRows.Last(), &Path);
+	TestTrue(TEXT("Deep tree is deeper than the inline path"), Path.Num() > 16);
+	CheckNoAllocations(TEXT("Deep tree"), DeepTree, DeepRows, Spec.Seed);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeSchedulerPriorityTest, "LearningDecisionTree.Scheduler.MostUrgentFirst", LearningDecisionTreeTests::TestFlags)
+
+bool FLearningDecisionTreeSchedulerPriorityTest::RunTest(const FString& Parameters)
+{
+	FLearningDecisionTreeSyntheticSpec Spec = LearningDecisionTreeTests::MakeSmallSpec();
+	ULearningDecisionTree* ModelA = LearningDecisionTreeTests::CreateTrainedTree(Spec);
+	FGCObjectScopeGuard ModelAGuard(ModelA);
+	ULearningDecisionTree* ModelB = LearningDecisionTreeTests::CreateTrainedTree(Spec);
+	FGCObjectScopeGuard ModelBGuard(ModelB);
+
+	// The most urgent agent uses the higher-addressed model, so grouping by model alone would put it last
+	ULearningDecisionTree* UrgentModel = ModelA < ModelB ? ModelB : ModelA;
+	ULearningDecisionTree* OtherModel = ModelA < ModelB ? ModelA : ModelB;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	ULearningDecisionTreeScheduler* Scheduler = World->GetSubsystem<ULearningDecisionTreeScheduler>();
+	if (TestNotNull(TEXT("Scheduler"), Scheduler))
+	{
+		// Priority only from time waited, and a budget that allows a single evaluation per tick
+		Scheduler->BudgetMicroseconds = 0.0f;
+		Scheduler->StateChangedWeight = 0.0f;
+		Scheduler->WaitWeight = 1000.0f;
+
+		TArray<int32> Decided;
+		auto OnDecision = FOnLearningDecisionTreeDecision::CreateLambda([&Decided](int32 AgentId, int32 Action) { Decided.Add(AgentId); });
+		const int32 Urgent = Scheduler->RegisterAgent(nullptr, UrgentModel, FLearningDecisionTreeStateSource(), OnDecision);
+		FPlatformProcess::Sleep(0.01f);
+		for (int32 Agent = 0; Agent < 8; Agent++)
+		{
+			Scheduler->RegisterAgent(nullptr, OtherModel, FLearningDecisionTreeStateSource(), OnDecision);
+		}
+
+		Scheduler->Tick(0.0f);
+		TestEqual(TEXT("One evaluation fits the budget"), Scheduler->GetSchedulerStats().NumEvaluated, 1);
+		TestEqual(TEXT("The rest are deferred"), Scheduler->GetSchedulerStats().NumDeferred, 8);
+		TestTrue(TEXT("The agent that waited longest is evaluated"), Decided.Num() == 1 && Decided[0] == Urgent);
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLearningDecisionTreeBenchmarkTest, "LearningDecisionTree.Benchmark.Small",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLearningDecisionTreeBenchmarkTest::RunTest(const FString& Parameters)
+{
+	FLearningDecisionTreeBenchmarkSettings Settings;
+	Settings.Spec.NumRows = 5000;
+	Settings.NumEvals = 20000;
+	Settings.WorkingFolder = LearningDecisionTreeTests::GetTestFolder();
+
+	TArray<FLearningDecisionTreeBenchmarkResult> Results = FLearningDecisionTreeBenchmark::Run(Settings);
+	TConstArrayView<const TCHAR*> CaseNames = FLearningDecisionTreeBenchmark::GetCaseNames();
+	if (TestEqual(TEXT("Benchmarks run"), Results.Num(), CaseNames.Num()))
+	{
+		for (int32 Case = 0; Case < CaseNames.Num(); Case++)
+		{
+			TestEqual(TEXT("Benchmark order"), Results[Case].Name, FString(CaseNames[Case]));
+		}
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FLearningDecisionTreeBenchmark::ToJson(Settings, Results));
+	if (TestTrue(TEXT("Results are valid JSON"), FJsonSerializer::Deserialize(Reader, Root) && Root.IsValid()))
+	{
+		TestEqual(TEXT("Every result is written"), Root->GetArrayField(TEXT("Results")).Num(), Results.Num());
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
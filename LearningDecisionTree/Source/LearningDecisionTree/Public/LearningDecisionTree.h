@@ -4,8 +4,78 @@
 #include "UObject/NoExportTypes.h"
 #include "LearningDecisionTreeTable.h"
 #include "LearningDecisionTreeNode.h"
+#include "LearningDecisionTreeEvalContext.h"
+#include "LearningDecisionTreeTableFile.h"
+#include "LearningDecisionTreeFlat.h"
+#include "LearningDecisionTreeTableJournal.h"
+#include "LearningDecisionTreeTableCsv.h"
+#include "LearningDecisionTreeSampling.h"
+#include "LearningDecisionTreeFeatureSelection.h"
+#include "LearningDecisionTreeDiscretizer.h"
+#include "LearningDecisionTreeMemory.h"
+#include "Tasks/Pipe.h"
+#include <atomic>
 #include "LearningDecisionTree.generated.h"
 
+/** Branch hit profiling (ULearningDecisionTree::bProfileBranches) is compiled out of shipping builds unless overridden. */
+#ifndef LEARNINGDECISIONTREE_BRANCH_PROFILING
+#define LEARNINGDECISIONTREE_BRANCH_PROFILING !UE_BUILD_SHIPPING
+#endif
+
+struct FLearningDecisionTreeIORequest;
+class ULearningDecisionTreeModelAsset;
+
+/** Progress of a time-sliced build started with ULearningDecisionTree::BeginDecisionTreeBuild(). */
+USTRUCT(BlueprintType)
+struct FLearningDecisionTreeBuildProgress
+{
+	GENERATED_BODY()
+
+	/** True from BeginDecisionTreeBuild() until the new tree replaces the old one. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	bool bInProgress = false;
+
+	/** Nodes split or turned into leaves so far. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NodesExploded = 0;
+
+	/** Nodes queued for exploding. Grows as nodes split, so it is not a countdown. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NodesPending = 0;
+
+	/** Time spent in TickBuild() on this build. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	float BuildSeconds = 0.0f;
+
+	/** Queued nodes that took a finished subtree from the previous build instead of being split (bReuseUnchangedSubtrees). */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 SubtreesReused = 0;
+};
+
+/**
+ * Identifies the training subset of a node being built: its rows in table order with their duplicate counts,
+ * and its remaining columns. ID3 builds the same subtree from the same subset, so it keys ULearningDecisionTree's subtree cache.
+ */
+USTRUCT()
+struct FLearningDecisionTreeSubsetFingerprint
+{
+	GENERATED_BODY()
+
+	/** Two independent 64-bit hashes of the subset. */
+	UPROPERTY()
+	uint64 HashA = 0;
+
+	UPROPERTY()
+	uint64 HashB = 0;
+
+	bool operator==(const FLearningDecisionTreeSubsetFingerprint& Other) const { return HashA == Other.HashA && HashB == Other.HashB; }
+
+	friend uint32 GetTypeHash(const FLearningDecisionTreeSubsetFingerprint& Fingerprint) { return (uint32)Fingerprint.HashA; }
+};
+
+/** Called on the game thread when an asynchronous save or load has finished. Error is empty on success. */
+DECLARE_DELEGATE_TwoParams(FOnLearningDecisionTreeIOComplete, bool /*bSucceeded*/, const FString& /*Error*/);
+
 /**
  * Main class for Learning Decision Tree.
  * Manages the Table and the Decision Tree structure using the ID3 algorithm.
@@ -20,6 +90,23 @@
  *    Example: RefreshStates({1, 0}); int32 Action = Eval();
  *
  * Note: Duplicate rows are handled automatically - no need to add a duplicates column.
+ *
+ * Agents whose states rarely change can keep an FLearningDecisionTreeEvalContext each and call
+ * EvalWithContext() instead, which skips the traversal while no tested feature has changed.
+ *
+ * Evaluation does not allocate: RefreshStates(), RefreshContextStates() and the Eval functions reuse
+ * their buffers once a row of that length, and for a context a path of that depth, has been seen
+ * (LearningDecisionTree.Eval.NoAllocations). The one exception is a decision node's own Eval(Row),
+ * which allocates on every call for paths more than 64 levels deep.
+ *
+ * Thread safety: Eval() reads the shared RowRealTimeStates and is game-thread only. EvalWithContext(),
+ * EvalRow() and FindLeaf() are const and keep all mutable state in the caller's context, so a single
+ * tree can be shared read-only by every agent and evaluated from ParallelFor or async tasks.
+ * Do not create, load or modify the tree while such evaluations are running.
+ *
+ * The *Async save/load functions run serialization and file IO on a background task, one request after
+ * the other, and apply the result on the game thread (see FOnLearningDecisionTreeIOComplete).
+ * The synchronous versions first wait for all pending requests, so results always apply in call order.
  */
 UCLASS(BlueprintType)
 class LEARNINGDECISIONTREE_API ULearningDecisionTree : public UObject
@@ -45,6 +132,10 @@ public:
 	UPROPERTY()
 	TArray<ULearningDecisionTreeNode*> NodesToExplode;
 
+	/** Bins raw float features into states for the *Floats functions, for training and evaluation alike. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	FLearningDecisionTreeDiscretizer Discretizer;
+
 	/** The current state of the environment, used for evaluation/prediction. */
 	UPROPERTY()
 	TArray<int32> RowRealTimeStates;
@@ -80,28 +171,273 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
 	void CreateDecisionTree();
 
-	/** Updates the current state vector used for evaluation. */
+	/**
+	 * Trains on the Table (or its training sample) with the engine-independent core library, straight into a flat tree.
+	 * The model is the one CreateDecisionTree() would build, but no node UObjects are created: Eval uses the flat tree
+	 * as after LoadFlatDecisionTree(). Returns false, keeping the current tree, if the table has no columns.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool CreateFlatDecisionTree();
+
+	/**
+	 * Makes CreateFlatDecisionTree() grow the tree one depth at a time, counting every node at a depth in one pass
+	 * per column and deriving each node's largest child from its siblings. Same tree, faster on large tables.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	bool bLevelWiseFlatBuild = false;
+
+	/**
+	 * Merges structurally identical subtrees (same split column, states and leaf counts) into shared nodes,
+	 * turning the tree into a DAG that evaluates, saves and loads like the tree it came from.
+	 * Returns the node and memory reduction. Does nothing for flat trees, which are written from a node tree.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	FLearningDecisionTreeShareReport ShareIdenticalSubtrees();
+
+	/** Runs ShareIdenticalSubtrees() after every CreateDecisionTree() and time-sliced build. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	bool bShareIdenticalSubtrees = false;
+
+	/**
+	 * Makes CreateDecisionTree() and the time-sliced build keep the finished subtrees of the tree they build, keyed by the
+	 * fingerprint of their training subset. The next build reuses every subtree whose subset is unchanged and only splits
+	 * the nodes whose rows changed, so retraining after a few AddRow() calls is much cheaper. Same tree as a full build.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	bool bReuseUnchangedSubtrees = false;
+
+	/** Subtrees the last finished CreateDecisionTree() or time-sliced build took from the build before it. */
+	UFUNCTION(BlueprintPure, Category = "LearningDecisionTree")
+	int32 GetReusedSubtreeCount() const { return ReusedSubtreeCount; }
+
+	// Time-sliced build
+	// Spreads CreateDecisionTree() over several frames for platforms without a spare worker thread.
+
+	/**
+	 * Starts building a new tree from the current Table (or its training sample) without replacing the current one.
+	 * Call TickBuild() every frame to advance it; Eval keeps using the current tree until the build finishes.
+	 * Restarts a build already in progress. CreateDecisionTree() and loading a tree cancel it.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Build")
+	void BeginDecisionTreeBuild();
+
+	/**
+	 * Explodes queued nodes of the build until BudgetMs has passed, always at least one.
+	 * Returns true once the new tree has replaced the current one, or if no build is in progress.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Build")
+	bool TickBuild(float BudgetMs = 2.0f);
+
+	/** Drops a build in progress, keeping the current tree. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Build")
+	void CancelDecisionTreeBuild();
+
+	UFUNCTION(BlueprintPure, Category = "LearningDecisionTree|Build")
+	bool IsBuildInProgress() const { return BuildProgress.bInProgress; }
+
+	UFUNCTION(BlueprintPure, Category = "LearningDecisionTree|Build")
+	FLearningDecisionTreeBuildProgress GetBuildProgress() const { return BuildProgress; }
+
+	/**
+	 * Trains CreateDecisionTree() on a sample of the Table instead of all of it, capping rebuild time.
+	 * The sample is kept up to date as rows are added, and only rebuilt from the Table after it was replaced
+	 * or the sampling settings changed.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Sampling")
+	ELearningDecisionTreeSampling TrainingSampling = ELearningDecisionTreeSampling::None;
+
+	/** Samples kept for training; per action when stratified. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Sampling", meta = (ClampMin = "1"))
+	int32 TrainingSampleSize = 100000;
+
+	/** Seed of the sampling, so the same rows give the same sample. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Sampling")
+	int32 TrainingSampleSeed = 0;
+
+	/**
+	 * Builds a tree on the training sample and one on the whole Table, without touching the current tree,
+	 * and reports how their splits and predictions differ. Costs a full build.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Sampling")
+	FLearningDecisionTreeSampleReport CompareSampledBuild();
+
+	/**
+	 * Trains CreateDecisionTree() and the time-sliced build on only the feature columns FeatureSelectionSettings keeps,
+	 * so no node scores constant, duplicate or uninformative columns. The splits are mapped back to the Table's columns:
+	 * evaluation, saving and export see full rows as usual. CreateFlatDecisionTree() still trains on every column.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|FeatureSelection")
+	bool bSelectFeatures = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|FeatureSelection")
+	FLearningDecisionTreeFeatureSelectionSettings FeatureSelectionSettings;
+
+	/** The feature columns the last build started with bSelectFeatures trained on. Empty otherwise. */
+	UFUNCTION(BlueprintPure, Category = "LearningDecisionTree|FeatureSelection")
+	FLearningDecisionTreeFeatureSelection GetFeatureSelection() const { return FeatureSelection; }
+
+	/** Updates the current state vector used for evaluation. Reuses its memory, so it only allocates when the row grows. */
 	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
 	void RefreshStates(const TArray<int32>& Row);
 
+	// Float features
+	// Run raw float features through the Discretizer, so callers do not bin values by hand.
+
+	/**
+	 * Fits the Discretizer's bin edges to quantiles of sample feature rows.
+	 * @param Samples NumRows rows of float features (Action excluded), row after row.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Features")
+	void FitDiscretizer(const TArray<float>& Samples, int32 NumRows, int32 NumBins);
+
+	/** Bins a float feature row and adds it with Action as a training sample. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Features")
+	void AddRowFromFloats(const TArray<float>& Features, int32 Action);
+
+	/** Bins a float feature row into RowRealTimeStates. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Features")
+	void RefreshStatesFromFloats(const TArray<float>& Features);
+
+	/** Bins a float feature row into an evaluation context. The cached leaf survives if no feature on its path changed state. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Features")
+	void RefreshContextStatesFromFloats(UPARAM(ref) FLearningDecisionTreeEvalContext& Context, const TArray<float>& Features) const;
+
+	/**
+	 * Bins the float features of many agents at once.
+	 * @param Features NumRows rows of float features, row after row. OutStates receives the states in the same layout.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Features")
+	void DiscretizeBatch(const TArray<float>& Features, int32 NumRows, TArray<int32>& OutStates) const;
+
 	// Save/Load
 	// Provides custom binary serialization to save the training data and the generated tree model to disk.
 
-	/** Saves the Table data to a binary file. */
+	/**
+	 * Saves the Table data to a binary file (see FLearningDecisionTreeTableFile for the format).
+	 * Columns are dictionary coded and bit-packed; Compression additionally compresses each block.
+	 * Returns false if the file could not be written.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
-	void SaveTable(FString FolderPath, FString FileName);
+	bool SaveTable(FString FolderPath, FString FileName, ELearningDecisionTreeCompression Compression = ELearningDecisionTreeCompression::None);
 
-	/** Loads Table data from a binary file. */
+	/**
+	 * Loads Table data from a binary file. Files in the original unversioned format are still accepted.
+	 * If a journal (FileName.journal) extends this file, its rows are replayed on top.
+	 * Returns false, leaving Table untouched, if there is neither a file nor a journal or the file is invalid.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
-	void LoadTable(FString FolderPath, FString FileName);
+	bool LoadTable(FString FolderPath, FString FileName);
+
+	/**
+	 * SaveTable() on a background task. The Table is copied when this is called; rows added afterwards
+	 * are not part of the file (but stay in the journal, if one is enabled for the same file).
+	 */
+	void SaveTableAsync(FString FolderPath, FString FileName, ELearningDecisionTreeCompression Compression = ELearningDecisionTreeCompression::None,
+		FOnLearningDecisionTreeIOComplete OnComplete = FOnLearningDecisionTreeIOComplete());
 
-	/** Saves the generated Decision Tree structure to a binary file. */
+	/**
+	 * LoadTable() on a background task. Table is replaced on the game thread when the load completes,
+	 * discarding changes made in the meantime, as if LoadTable() had been called at that point.
+	 */
+	void LoadTableAsync(FString FolderPath, FString FileName, FOnLearningDecisionTreeIOComplete OnComplete = FOnLearningDecisionTreeIOComplete());
+
+	/**
+	 * Replaces the Table with the rows of a CSV/TSV file (see FLearningDecisionTreeTableCsv).
+	 * FileName includes the extension. Duplicate rows are merged into the duplicate counts.
+	 * Returns false, leaving Table untouched, if the file is missing or has no valid header.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
-	void SaveDecisionTree(FString FolderPath, FString FileName);
+	bool ImportTableCsv(FString FolderPath, FString FileName, FLearningDecisionTreeCsvStats& OutStats);
 
-	/** Loads a Decision Tree structure from a binary file. */
+	/**
+	 * Writes the Table as CSV, or as TSV if FileName ends in .tsv.
+	 * @param bExpandDuplicates Write a line per sample, so importing the file restores the duplicate counts.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
-	void LoadDecisionTree(FString FolderPath, FString FileName);
+	bool ExportTableCsv(FString FolderPath, FString FileName, FLearningDecisionTreeCsvStats& OutStats, bool bExpandDuplicates = true) const;
+
+	// Journal
+	// Records every AddColumn/AddRow in an append-only log next to the table file, so new training data
+	// is durable at O(new rows) instead of requiring a full SaveTable. LoadTable replays the journal.
+
+	/**
+	 * Starts journaling table changes to FileName.journal, next to the FileName.dat snapshot.
+	 * Call it right after LoadTable() of the same file to keep appending to the existing journal;
+	 * otherwise the current Table is first written out as a fresh snapshot.
+	 * Returns false if the files could not be written.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool EnableTableJournal(FString FolderPath, FString FileName);
+
+	/** Writes out pending journal records and stops journaling. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	void DisableTableJournal();
+
+	/**
+	 * Hands buffered journal records to the background writer.
+	 * @param bWait Block until they have been written.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	void FlushTableJournal(bool bWait = false);
+
+	/** Folds the journal into a new snapshot and starts an empty journal. Costs a full table write. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool CompactTableJournal();
+
+	/** Compacts the journal automatically once it holds this many rows. 0 compacts only on request. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	int32 JournalCompactionRows = 0;
+
+	/**
+	 * Saves the generated Decision Tree structure to a binary file. Subtrees shared by ShareIdenticalSubtrees() are written once.
+	 * Returns false if the file could not be written.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool SaveDecisionTree(FString FolderPath, FString FileName);
+
+	/** Loads a Decision Tree structure from a binary file. Returns false, keeping the current tree, if the file is missing or invalid. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool LoadDecisionTree(FString FolderPath, FString FileName);
+
+	/** SaveDecisionTree() with the file write on a background task. The tree is serialized when this is called. */
+	void SaveDecisionTreeAsync(FString FolderPath, FString FileName, FOnLearningDecisionTreeIOComplete OnComplete = FOnLearningDecisionTreeIOComplete());
+
+	/**
+	 * LoadDecisionTree() with the file read on a background task. The nodes are created on the game thread
+	 * when the read completes. Fails without touching the tree if it was created or loaded again in the meantime.
+	 */
+	void LoadDecisionTreeAsync(FString FolderPath, FString FileName, FOnLearningDecisionTreeIOComplete OnComplete = FOnLearningDecisionTreeIOComplete());
+
+	/** True while asynchronous saves or loads have not been applied yet. */
+	bool HasPendingIO() const { return PendingIO.Num() > 0; }
+
+	/** Blocks until all asynchronous saves and loads have finished, then applies them and calls their delegates. */
+	void WaitForPendingIO();
+
+	/**
+	 * Saves the generated Decision Tree in the flat format (FileName.ftree, see FLearningDecisionTreeFlatView).
+	 * Returns false if there is no tree or the file could not be written.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool SaveFlatDecisionTree(FString FolderPath, FString FileName);
+
+	/**
+	 * Memory-maps a flat Decision Tree (FileName.ftree) and evaluates directly from the mapped pages,
+	 * without creating any node UObjects. Replaces the current tree; all Eval functions use the flat tree
+	 * until CreateDecisionTree() or LoadDecisionTree() is called. Returns false if the file is missing or invalid.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool LoadFlatDecisionTree(FString FolderPath, FString FileName);
+
+	/**
+	 * Evaluates the model of a cooked ULearningDecisionTreeModelAsset from now on, sharing its memory.
+	 * Like LoadFlatDecisionTree(), no node UObjects are created. Returns false if the asset holds no model.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool LoadDecisionTreeFromAsset(const ULearningDecisionTreeModelAsset* Asset);
+
+	/** The flat tree built by CreateFlatDecisionTree() or opened by LoadFlatDecisionTree() or LoadDecisionTreeFromAsset(), if any. */
+	TSharedPtr<const FLearningDecisionTreeFlatModel> GetFlatTree() const { return FlatTree; }
 
 	/**
 	 * Evaluates the current state (RowRealTimeStates) against the decision tree.
@@ -111,7 +447,195 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
 	int32 Eval();
 
+	/**
+	 * Evaluates the context's feature row against the decision tree.
+	 * Reuses the leaf found by the previous evaluation while no feature tested on its path has changed.
+	 * Returns the predicted Action ID, or -1 if no action found or tree is invalid.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "LearningDecisionTree")
+	int32 EvalWithContext(UPARAM(ref) FLearningDecisionTreeEvalContext& Context) const;
+
+	/**
+	 * Evaluates a full feature row (Action column excluded) without touching RowRealTimeStates or the context cache.
+	 * Samples the leaf with the context's random stream. Reentrant; see the class comment on thread safety.
+	 * Returns the predicted Action ID, or -1 if no action found or tree is invalid.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "LearningDecisionTree")
+	int32 EvalRow(const TArray<int32>& Row, UPARAM(ref) FLearningDecisionTreeEvalContext& Context) const;
+
+	/**
+	 * Native form of EvalRow() for callers that keep their rows on the stack.
+	 * @param bMostLikelyAction Return the leaf's most likely action instead of sampling it.
+	 */
+	int32 EvalRow(TArrayView<const int32> Row, FRandomStream& RandomStream, bool bMostLikelyAction = false) const;
+
+	/** Sets one feature of an evaluation context. The cached leaf survives if the feature is not on its path. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	static void SetContextState(UPARAM(ref) FLearningDecisionTreeEvalContext& Context, int32 FeatureIndex, int32 Value);
+
+	/** Replaces the feature row of an evaluation context. The cached leaf survives if no feature on its path changed. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	static void RefreshContextStates(UPARAM(ref) FLearningDecisionTreeEvalContext& Context, const TArray<int32>& Row);
+
+	/**
+	 * Walks the tree with a full feature row (Action column excluded) and returns the leaf reached,
+	 * or nullptr if a state on the way was never seen during training.
+	 * @param OutPath If set, receives the feature index tested at every DecisionNode on the way.
+	 */
+	const ULearningDecisionTreeActionNode* FindLeaf(TArrayView<const int32> Row, FLearningDecisionTreePath* OutPath = nullptr) const;
+
+	// Branch profiling
+	// Counts which branches evaluations take, so OptimizeBranchLayout() can put the hot ones first.
+
+	/** Counts the branches taken by one evaluation in BranchProfileInterval. No effect in shipping builds. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Profiling")
+	bool bProfileBranches = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Profiling", meta = (ClampMin = "1"))
+	int32 BranchProfileInterval = 16;
+
+	/**
+	 * Reorders every decision's branches by the profiled hit counts, most taken first, and re-creates the tree
+	 * depth-first along the hottest branches so hot paths sit together in memory. Works on node trees (built or
+	 * loaded from .tree) and flat trees (.ftree or model assets); save the tree afterwards to keep the layout.
+	 * Resets the counters. Returns false if there is no tree, or if the tree is flat and has no branch profile.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Profiling")
+	bool OptimizeBranchLayout();
+
+	/** Clears the branch hit counters. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Profiling")
+	void ResetBranchProfile();
+
+	/** Identifies the current tree. Changes every time the tree is created or loaded. 0 if there never was one. */
+	uint32 GetTreeVersion() const { return TreeVersion; }
+
 	/** Prints table debug info to log. */
 	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
 	void DebugTable();
+
+	/** Reports the memory held by the Table, the tree and training state, and the peak of the last build. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	FLearningDecisionTreeMemoryReport GetMemoryReport() const;
+
+#if WITH_EDITOR
+	/**
+	 * Exports the generated Decision Tree as a self-contained C++ header (FileName.h).
+	 * Leaf distributions are written as constexpr tables and decision nodes as nested switch
+	 * statements keyed on the original feature indices, so a frozen model can be compiled
+	 * into shipping builds instead of being loaded at startup.
+	 * Returns false if there is no tree or the file could not be written.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool ExportDecisionTreeToCpp(FString FolderPath, FString FileName, FString Namespace);
+#endif
+
+	//~ UObject interface
+	virtual void BeginDestroy() override;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+private:
+	/** Writes Table to FullPath now and marks it as the synced snapshot. */
+	bool SaveTableFile(const FString& FullPath, ELearningDecisionTreeCompression Compression);
+
+	/** Serializes LDTRoot into the .tree format. */
+	void SerializeDecisionTree(TArray<uint8>& OutBytes);
+
+	/** Replaces LDTRoot with a tree in the .tree format. Returns false, keeping the current tree, if Bytes are invalid. */
+	bool DeserializeDecisionTree(const TArray<uint8>& Bytes);
+
+	/** Queues a request on IOPipe. It is applied by FinishPendingIO() once it has run. */
+	void LaunchIORequest(const TSharedRef<FLearningDecisionTreeIORequest>& Request);
+
+	/** Applies the finished requests at the front of PendingIO, in order. */
+	void FinishPendingIO();
+
+	/** Applies the result of a finished request to the tree on the game thread and calls its delegate. */
+	void ApplyIORequest(FLearningDecisionTreeIORequest& Request);
+
+	/** Runs background saves and loads one at a time, in the order they were requested. */
+	UE::Tasks::FPipe IOPipe{ TEXT("LearningDecisionTreeIO") };
+
+	/** Requests launched on IOPipe that have not been applied yet, oldest first. */
+	TArray<TSharedRef<FLearningDecisionTreeIORequest>> PendingIO;
+
+	/** Journal of table changes, when enabled. */
+	TUniquePtr<FLearningDecisionTreeTableJournal> TableJournal;
+
+	/** Snapshot file the journal extends. */
+	FString JournalTablePath;
+
+	/** Last table file Table was loaded from or saved to, and that file's identity. */
+	FString SyncedTablePath;
+	FLearningDecisionTreeSnapshotId SyncedSnapshot;
+
+	/** Counts changes to Table. Table matches SyncedTablePath while SyncedChangeSerial equals it. */
+	uint64 TableChangeSerial = 0;
+	uint64 SyncedChangeSerial = 0;
+
+	/** Returns the table to train on: the Table, or its training sample built into SampledTable. */
+	const FLearningDecisionTreeTable& GetTrainingTable(FLearningDecisionTreeTable& SampledTable);
+
+	/** Runs the feature selection on TrainingTable if bSelectFeatures, returning it or its kept columns built into SelectedTable. */
+	const FLearningDecisionTreeTable& SelectFeatures(const FLearningDecisionTreeTable& TrainingTable, FLearningDecisionTreeTable& SelectedTable);
+
+	/** See GetFeatureSelection(). Also maps the splits of a time-sliced build in progress. */
+	FLearningDecisionTreeFeatureSelection FeatureSelection;
+
+	/** Root of the tree being built by TickBuild(); its queue is NodesToExplode. Moved to LDTRoot when done. */
+	UPROPERTY()
+	TArray<ULearningDecisionTreeNode*> PendingRoot;
+
+	FLearningDecisionTreeBuildProgress BuildProgress;
+
+	/** Memory held by the tables of queued nodes of the time-sliced build, and its peak. */
+	int64 BuildPendingTableBytes = 0;
+	int64 BuildPeakTableBytes = 0;
+
+	/** Finished subtrees of the current tree by training subset, for bReuseUnchangedSubtrees. Also holds those of a build in progress. */
+	UPROPERTY()
+	TMap<FLearningDecisionTreeSubsetFingerprint, ULearningDecisionTreeNode*> SubtreeCache;
+
+	/** See GetReusedSubtreeCount(). */
+	int32 ReusedSubtreeCount = 0;
+
+	/** Returns the subtree cache the next build should use, dropping entries the current tree no longer reaches; null if disabled. */
+	TMap<FLearningDecisionTreeSubsetFingerprint, ULearningDecisionTreeNode*>* PrepareSubtreeCache();
+
+	/** Drops cache entries the tree does not reach, such as merged copies and subtrees of an abandoned build. */
+	void PruneSubtreeCache();
+
+	/** Brings TrainingSampler up to date with the Table and the sampling settings. */
+	void UpdateTrainingSample();
+
+	/** Training sample maintained for TrainingSampling. */
+	FLearningDecisionTreeTableSampler TrainingSampler;
+
+	/** TableChangeSerial TrainingSampler is up to date with. Only valid if bTrainingSampleValid. */
+	uint64 SampledChangeSerial = 0;
+	bool bTrainingSampleValid = false;
+
+	/** Flat tree used for evaluation instead of LDTRoot when set. May be shared with a model asset. */
+	TSharedPtr<const FLearningDecisionTreeFlatModel> FlatTree;
+
+	/** See GetTreeVersion(). Unique across all trees, so contexts cannot mistake one tree for another. */
+	uint32 TreeVersion = 0;
+
+	/** Assigns a new TreeVersion, invalidating every evaluation context cached against the old tree. */
+	void BumpTreeVersion();
+
+	/** Resolves FeatureIndex on every DecisionNode from its filtered-table relative BestInfoGainColumn. */
+	void ResolveFeatureIndices();
+
+	/** See FLearningDecisionTreeMemoryReport::BuildPeakBytes. */
+	int64 BuildPeakBytes = 0;
+
+	/** Counts the branches Row takes on one evaluation in BranchProfileInterval, if bProfileBranches is set. */
+	void ProfileBranches(TArrayView<const int32> Row) const;
+
+	/** Evaluations seen by ProfileBranches(), to pick the sampled ones. */
+	mutable std::atomic<uint32> ProfiledEvals{ 0 };
+
+	/** Branch hit counters of FlatTree, one per branch. Sized when profiling is compiled in. */
+	mutable TArray<int32> FlatBranchHits;
 };
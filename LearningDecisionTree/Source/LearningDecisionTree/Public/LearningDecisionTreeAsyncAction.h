@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "LearningDecisionTreeTableFile.h"
+#include "LearningDecisionTreeAsyncAction.generated.h"
+
+class ULearningDecisionTree;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLearningDecisionTreeAsyncActionPin, const FString&, Error);
+
+/**
+ * Blueprint nodes for the asynchronous save and load functions of ULearningDecisionTree.
+ * The file work runs in the background; OnSucceeded or OnFailed fires on the game thread when it is done.
+ */
+UCLASS()
+class LEARNINGDECISIONTREE_API ULearningDecisionTreeAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FLearningDecisionTreeAsyncActionPin OnSucceeded;
+
+	UPROPERTY(BlueprintAssignable)
+	FLearningDecisionTreeAsyncActionPin OnFailed;
+
+	/** Saves the Table in the background. The Table is copied when the node runs. */
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "LearningDecisionTree")
+	static ULearningDecisionTreeAsyncAction* SaveTableAsync(UObject* WorldContextObject, ULearningDecisionTree* Tree, FString FolderPath, FString FileName,
+		ELearningDecisionTreeCompression Compression = ELearningDecisionTreeCompression::None);
+
+	/** Loads the Table in the background and replaces it when the load completes. */
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "LearningDecisionTree")
+	static ULearningDecisionTreeAsyncAction* LoadTableAsync(UObject* WorldContextObject, ULearningDecisionTree* Tree, FString FolderPath, FString FileName);
+
+	/** Saves the Decision Tree, writing the file in the background. */
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "LearningDecisionTree")
+	static ULearningDecisionTreeAsyncAction* SaveDecisionTreeAsync(UObject* WorldContextObject, ULearningDecisionTree* Tree, FString FolderPath, FString FileName);
+
+	/** Loads the Decision Tree, reading the file in the background. */
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "LearningDecisionTree")
+	static ULearningDecisionTreeAsyncAction* LoadDecisionTreeAsync(UObject* WorldContextObject, ULearningDecisionTree* Tree, FString FolderPath, FString FileName);
+
+	//~ UBlueprintAsyncActionBase interface
+	virtual void Activate() override;
+
+private:
+	enum class EOperation : uint8
+	{
+		SaveTable,
+		LoadTable,
+		SaveTree,
+		LoadTree
+	};
+
+	static ULearningDecisionTreeAsyncAction* Create(UObject* WorldContextObject, ULearningDecisionTree* InTree, EOperation InOperation, const FString& InFolderPath, const FString& InFileName);
+
+	void HandleComplete(bool bSucceeded, const FString& Error);
+
+	UPROPERTY()
+	ULearningDecisionTree* Tree = nullptr;
+
+	EOperation Operation = EOperation::SaveTable;
+	FString FolderPath;
+	FString FileName;
+	ELearningDecisionTreeCompression Compression = ELearningDecisionTreeCompression::None;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeSynthetic.h"
+
+/** Timing of one benchmarked operation. */
+struct FLearningDecisionTreeBenchmarkResult
+{
+	FString Name;
+
+	/** Number of calls timed. */
+	int64 Operations = 0;
+
+	double Milliseconds = 0.0;
+
+	double OpsPerSecond = 0.0;
+
+	/**
+	 * Peak physical memory of the whole process since it started, read after the operation, in MB.
+	 * Not the operation's own peak: it only grows if the operation went past every earlier peak.
+	 */
+	double PeakMemoryMB = 0.0;
+};
+
+/** What FLearningDecisionTreeBenchmark::Run measures. */
+struct FLearningDecisionTreeBenchmarkSettings
+{
+	FLearningDecisionTreeSyntheticSpec Spec;
+
+	/** Evaluations timed per Eval function. */
+	int32 NumEvals = 100000;
+
+	/** Folder receiving the files of the save/load benchmarks. */
+	FString WorkingFolder;
+};
+
+/**
+ * Times the main operations of ULearningDecisionTree on a synthetic table:
+ * AddRow, CreateDecisionTree, Eval/EvalWithContext/EvalRow, SaveTable/LoadTable and SaveDecisionTree/LoadDecisionTree.
+ * Used by ULearningDecisionTreeBenchmarkCommandlet and the automation tests; results are written as JSON
+ * so runs can be compared across versions.
+ */
+struct LEARNINGDECISIONTREE_API FLearningDecisionTreeBenchmark
+{
+	/** Runs every benchmark once, in the order of GetCaseNames(). Must be called on the game thread. */
+	static TArray<FLearningDecisionTreeBenchmarkResult> Run(const FLearningDecisionTreeBenchmarkSettings& Settings);
+
+	/** Names of the benchmarks Run() measures, one result each. */
+	static TConstArrayView<const TCHAR*> GetCaseNames();
+
+	/** Formats results, along with the settings that produced them, as a JSON document. */
+	static FString ToJson(const FLearningDecisionTreeBenchmarkSettings& Settings, const TArray<FLearningDecisionTreeBenchmarkResult>& Results);
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LearningDecisionTreeBenchmarkCommandlet.generated.h"
+
+/**
+ * Runs FLearningDecisionTreeBenchmark headless and writes the results as JSON.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=LearningDecisionTreeBenchmark [-Rows=10000] [-Features=8] [-Cardinality=4]
+ *     [-Actions=4] [-Informative=3] [-Noise=0.05] [-Seed=1] [-Evals=100000] [-Output=<file.json>]
+ *
+ * Output defaults to Saved/LearningDecisionTree/Benchmark.json.
+ */
+UCLASS()
+class LEARNINGDECISIONTREE_API ULearningDecisionTreeBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	ULearningDecisionTreeBenchmarkCommandlet();
+
+	//~ UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeTable.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "LearningDecisionTreeCore/Builder.h"
+#include "LearningDecisionTreeCore/Table.h"
+THIRD_PARTY_INCLUDES_END
+
+class FLearningDecisionTreeFlatModel;
+
+/**
+ * Bridges the plugin and the engine-independent core library (Source/ThirdParty/LearningDecisionTreeCore),
+ * which trains and evaluates the same models in offline tools and data pipelines without the engine.
+ */
+namespace LearningDecisionTreeCoreAdapter
+{
+	/** Copies Table into the core's table type. Column order, duplicate counts and TotalRows are kept. */
+	LEARNINGDECISIONTREE_API void ToCoreTable(const FLearningDecisionTreeTable& Table, LearningDecisionTreeCore::FTable& OutTable);
+
+	/**
+	 * Copies a core table into OutTable. Returns false, leaving OutTable untouched, if the table is
+	 * inconsistent or two column names are the same FName (names are case-insensitive here).
+	 */
+	LEARNINGDECISIONTREE_API bool FromCoreTable(const LearningDecisionTreeCore::FTable& Table, FLearningDecisionTreeTable& OutTable);
+
+	/**
+	 * Trains a flat tree on Table with the core builder, without creating any node UObjects.
+	 * Produces the same blob as CreateDecisionTree() followed by FLearningDecisionTreeFlatView::Build(), in either mode.
+	 * Returns null if the table has no columns or is inconsistent.
+	 */
+	LEARNINGDECISIONTREE_API TSharedPtr<FLearningDecisionTreeFlatModel> BuildFlatModel(const FLearningDecisionTreeTable& Table,
+		LearningDecisionTreeCore::EBuildMode Mode = LearningDecisionTreeCore::EBuildMode::DepthFirst);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeDiscretizer.generated.h"
+
+/** Bin edges of one feature column, ascending. */
+USTRUCT(BlueprintType)
+struct FLearningDecisionTreeBinEdges
+{
+	GENERATED_BODY()
+
+	/**
+	 * A value's state is the number of edges it is greater than or equal to, so N edges give states 0..N.
+	 * Empty: the value is passed through, rounded down.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	TArray<float> Edges;
+};
+
+/**
+ * Turns raw float features (distances, health, cooldowns) into the integer states the tree is trained on.
+ * The same edges are used for AddRow and for evaluation, so training and inference always agree on the encoding.
+ *
+ * Edges are set by hand or fitted to quantiles of sample data. Batches of rows are binned a column at a time
+ * with 4-wide vector compares, without branches.
+ */
+USTRUCT(BlueprintType)
+struct LEARNINGDECISIONTREE_API FLearningDecisionTreeDiscretizer
+{
+	GENERATED_BODY()
+
+public:
+	/** Bin edges per feature column (Action column excluded). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	TArray<FLearningDecisionTreeBinEdges> Columns;
+
+	/** Number of feature columns. */
+	int32 GetNumFeatures() const { return Columns.Num(); }
+
+	/** Sets the edges of a column, growing the column list as needed. Edges are sorted and deduplicated. */
+	void SetEdges(int32 Column, TArray<float> Edges);
+
+	/**
+	 * Fits edges so that every column's samples fall into NumBins bins of about equal size.
+	 * Columns with fewer distinct values get fewer bins.
+	 * @param Samples NumRows rows of features, row after row.
+	 */
+	void FitQuantiles(TArrayView<const float> Samples, int32 NumRows, int32 NumBins);
+
+	/** Returns the state of Value in Column. */
+	int32 Discretize(int32 Column, float Value) const;
+
+	/**
+	 * Bins one row of features. OutStates holds at least as many elements as Values.
+	 * Columns past GetNumFeatures() have no bins and pass through like Discretize() does.
+	 */
+	void DiscretizeRow(TArrayView<const float> Values, TArrayView<int32> OutStates) const;
+
+	/**
+	 * Bins NumRows rows of features at once, e.g. one row per agent, exactly as DiscretizeRow() bins each row.
+	 * @param Values NumRows rows of equal length, row after row. Logs a warning and does nothing otherwise.
+	 * @param OutStates Receives the states in the same layout.
+	 */
+	void DiscretizeBatch(TArrayView<const float> Values, int32 NumRows, TArrayView<int32> OutStates) const;
+};
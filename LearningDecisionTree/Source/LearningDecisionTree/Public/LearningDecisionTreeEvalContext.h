@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeEvalContext.generated.h"
+
+class ULearningDecisionTreeActionNode;
+
+/** Original feature indices tested on the way from the root to a leaf. Paths up to 16 deep are stored inline. */
+typedef TArray<int32, TInlineAllocator<16>> FLearningDecisionTreePath;
+
+/**
+ * Per-agent evaluation state for a Learning Decision Tree.
+ * Remembers the leaf reached by the last evaluation and which features were tested on the way,
+ * so an evaluation after a change to an untested feature can skip the traversal entirely.
+ *
+ * The context also owns the random stream used to sample leaves. All mutable evaluation state
+ * lives here rather than in the tree, so one trained tree can be shared by many agents and
+ * evaluated from several threads at once, as long as each thread uses its own context.
+ *
+ * Usage:
+ *   Context.SetStates(Row);              // or SetState(FeatureIndex, Value) per feature
+ *   int32 Action = Tree->EvalWithContext(Context);
+ */
+USTRUCT(BlueprintType)
+struct LEARNINGDECISIONTREE_API FLearningDecisionTreeEvalContext
+{
+	GENERATED_BODY()
+
+public:
+	FLearningDecisionTreeEvalContext();
+
+	/** Creates a context whose random stream is seeded deterministically. */
+	explicit FLearningDecisionTreeEvalContext(int32 Seed);
+
+	/** The agent's current feature row (Action column excluded), in the original column order. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	TArray<int32> States;
+
+	/** If true, evaluation returns the most likely action of the leaf instead of sampling it. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	bool bUseMostLikelyAction = false;
+
+	/** Random stream used to sample actions from leaves. Seeded randomly unless constructed with a seed. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	FRandomStream RandomStream;
+
+	/** Number of evaluations that reused the cached leaf. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int64 CacheHits = 0;
+
+	/** Number of evaluations that had to traverse the tree. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int64 CacheMisses = 0;
+
+	/** Leaf reached by the last traversal. Null if the traversal hit an unseen state. */
+	const ULearningDecisionTreeActionNode* CachedLeaf = nullptr;
+
+	/** Leaf reached by the last traversal when evaluating a flat tree, or INDEX_NONE. */
+	int32 CachedFlatLeaf = INDEX_NONE;
+
+	/** CachedLeaf's most likely action, used when bUseMostLikelyAction is set. */
+	int32 CachedMostLikelyAction = -1;
+
+	/**
+	 * Feature indices tested on the path to CachedLeaf. Changing any other feature keeps the cache valid.
+	 * Keeps its memory between traversals, so it only allocates for a path deeper than any before.
+	 */
+	FLearningDecisionTreePath PathFeatures;
+
+	/** Version of the tree the cached path belongs to. 0 means nothing is cached. */
+	uint32 CachedTreeVersion = 0;
+
+	/** Sets a single feature, invalidating the cache only if the feature was tested on the cached path. */
+	void SetState(int32 FeatureIndex, int32 Value);
+
+	/** Replaces the whole feature row, invalidating the cache only if a feature on the cached path changed. */
+	void SetStates(TArrayView<const int32> Row);
+
+	/** Forces the next evaluation to traverse the tree. */
+	void Invalidate();
+
+	/** Resets the cache hit and miss counters. */
+	void ResetCounters();
+
+	/** Returns a tree version that no other tree or model in the process has used. Never 0. */
+	static uint32 AllocateTreeVersion();
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeTable.h"
+#include "LearningDecisionTreeFeatureSelection.generated.h"
+
+/** Which feature columns the feature selection pre-pass drops before training (ULearningDecisionTree::bSelectFeatures). */
+USTRUCT(BlueprintType)
+struct FLearningDecisionTreeFeatureSelectionSettings
+{
+	GENERATED_BODY()
+
+	/** Drops features with the same state on every row. They can never split a node. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	bool bDropConstantColumns = true;
+
+	/** Drops features whose states equal those of an earlier feature on every row, keeping the earlier one. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree")
+	bool bDropDuplicateColumns = true;
+
+	/**
+	 * Drops features whose mutual information with the action over the whole table (the information gain of a split
+	 * at the root) is below this, in bits. A feature that only matters together with another one scores low here,
+	 * so keep this small; 0 keeps every informative and uninformative feature alike.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree", meta = (ClampMin = "0"))
+	float MinMutualInformation = 0.0f;
+};
+
+/**
+ * The feature columns a tree trains on, picked from a table by Select().
+ * The narrower table from BuildTable() trains faster and holds less, and ToOriginalColumn() maps the splits of
+ * the tree built on it back to the full row layout, so evaluation takes the same rows as without selection.
+ */
+USTRUCT(BlueprintType)
+struct LEARNINGDECISIONTREE_API FLearningDecisionTreeFeatureSelection
+{
+	GENERATED_BODY()
+
+	/** Columns of the table the selection was made on, Action column last. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	TArray<FName> ColumnNames;
+
+	/** Feature columns kept and dropped, as ascending indices into ColumnNames. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	TArray<int32> KeptFeatures;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	TArray<int32> DroppedFeatures;
+
+	/** Why the dropped features were dropped. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NumConstant = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NumDuplicate = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NumLowInformation = 0;
+
+	/** Picks the feature columns of Table (every column but the last) to keep. */
+	static FLearningDecisionTreeFeatureSelection Select(const FLearningDecisionTreeTable& Table, const FLearningDecisionTreeFeatureSelectionSettings& Settings);
+
+	/** Copies the kept feature columns and the Action column of Table into OutTable, with the same rows and duplicate counts. */
+	void BuildTable(const FLearningDecisionTreeTable& Table, FLearningDecisionTreeTable& OutTable) const;
+
+	/**
+	 * Turns the split column of a node built on the narrower table, relative to that node's RemainingColumns,
+	 * into the split column the node would have with every column of ColumnNames, for ResolveFeatureIndices().
+	 */
+	int32 ToOriginalColumn(int32 RelativeColumn, const TArray<FName>& RemainingColumns) const;
+
+	/** Mutual information between the feature column and the Action column of Table, in bits. */
+	static double MutualInformation(const FLearningDecisionTreeTable& Table, int32 ColumnIndex);
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeEvalContext.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "LearningDecisionTreeCore/Flat.h"
+THIRD_PARTY_INCLUDES_END
+
+class ULearningDecisionTreeNode;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Flat, relocatable decision tree format (.ftree).
+ * The whole model is one contiguous little-endian blob with indices instead of pointers,
+ * so it can be memory-mapped and evaluated in place without creating any UObjects.
+ *
+ * Layout:
+ *   FLearningDecisionTreeFlatHeader
+ *   FLearningDecisionTreeFlatNode      Nodes[NumNodes]
+ *   FLearningDecisionTreeFlatBranch    Branches[NumBranches]
+ *   FLearningDecisionTreeFlatLeafEntry LeafEntries[NumLeafEntries]
+ *
+ * The structs are defined once by the engine-independent core library (LearningDecisionTreeCore/FlatFormat.h),
+ * so models trained by its offline tools load here unchanged, and the other way round.
+ * Leaves have FeatureIndex == INDEX_NONE.
+ */
+using FLearningDecisionTreeFlatHeader = LearningDecisionTreeCore::FFlatHeader;
+using FLearningDecisionTreeFlatNode = LearningDecisionTreeCore::FFlatNode;
+using FLearningDecisionTreeFlatBranch = LearningDecisionTreeCore::FFlatBranch;
+using FLearningDecisionTreeFlatLeafEntry = LearningDecisionTreeCore::FFlatLeafEntry;
+
+static_assert(FLearningDecisionTreeFlatNode::LeafFeature == INDEX_NONE, "Flat tree leaves are marked with INDEX_NONE.");
+static_assert(PLATFORM_LITTLE_ENDIAN, "The flat decision tree format is little-endian and is read in place.");
+
+/**
+ * Read-only view over a flat tree blob. Does not own the memory.
+ * Wraps the core library's LearningDecisionTreeCore::FFlatView, which does the validation and the walk, so the
+ * plugin and the offline tools evaluate with the same code. Evaluation is const and allocation free; every index
+ * read from the blob is bounds checked, so a corrupt file can make predictions wrong but never reads outside the blob.
+ */
+class LEARNINGDECISIONTREE_API FLearningDecisionTreeFlatView
+{
+public:
+	/** Points the view at a blob. Returns false (and stays empty) if the header does not describe Size bytes. */
+	bool Initialize(const uint8* Data, int64 Size);
+
+	bool IsValid() const { return Core.IsValid(); }
+	const FLearningDecisionTreeFlatHeader* GetHeader() const { return Core.GetHeader(); }
+	const FLearningDecisionTreeFlatNode& GetNode(uint32 NodeIndex) const { return Core.GetNode(NodeIndex); }
+	uint32 GetNumNodes() const { return Core.GetNumNodes(); }
+
+	/** The blob the view points at: the header and all sections it describes. */
+	TArrayView<const uint8> GetBytes() const;
+
+	/**
+	 * Walks the tree with a full feature row and returns the index of the leaf reached,
+	 * or INDEX_NONE if a state on the way was never seen during training.
+	 * @param OutPath If set, receives the feature index tested at every decision node on the way.
+	 */
+	int32 FindLeaf(TArrayView<const int32> Row, FLearningDecisionTreePath* OutPath = nullptr) const;
+
+	/** Samples an action from a leaf weighted by its counts. Returns -1 for an empty or invalid leaf. */
+	int32 SampleAction(int32 LeafIndex, FRandomStream& RandomStream) const;
+
+	/** Returns the most likely action of a leaf, or -1. */
+	int32 MostLikelyAction(int32 LeafIndex) const { return Core.MostLikelyAction(LeafIndex); }
+
+	/** Evaluates a full feature row. Returns the Action ID, or -1. */
+	int32 Eval(TArrayView<const int32> Row, FRandomStream& RandomStream, bool bMostLikelyAction = false) const;
+
+	/**
+	 * Evaluates the context's feature row, reusing its cached leaf if it was found in this tree (TreeVersion)
+	 * and no feature on its path has changed since. Returns the Action ID, or -1.
+	 */
+	int32 EvalWithContext(FLearningDecisionTreeEvalContext& Context, uint32 TreeVersion) const;
+
+	/** Serializes a UObject node tree into a flat blob. Nodes reachable through several parents are stored once. */
+	static bool Build(const ULearningDecisionTreeNode* Root, TArray<uint8>& OutBytes);
+
+	uint32 GetNumBranches() const { return Core.GetNumBranches(); }
+	const FLearningDecisionTreeFlatBranch& GetBranch(uint32 BranchIndex) const { return Core.GetBranch(BranchIndex); }
+
+	uint32 GetNumLeafEntries() const { return Core.GetNumLeafEntries(); }
+	const FLearningDecisionTreeFlatLeafEntry& GetLeafEntry(uint32 EntryIndex) const { return Core.GetLeafEntry(EntryIndex); }
+
+	/** Walks the tree with a full feature row, adding one to BranchHits[b] for every branch b taken. Thread safe. */
+	void CountBranchHits(TArrayView<const int32> Row, TArrayView<int32> BranchHits) const;
+
+	/**
+	 * Writes a copy of this tree with each node's branches ordered by BranchHits, most taken first, and the nodes
+	 * laid out depth-first along the most taken branches, so the nodes of hot paths are next to each other.
+	 * Returns false if BranchHits does not have one counter per branch or the tree is malformed.
+	 */
+	bool BuildHotFirst(TArrayView<const int32> BranchHits, TArray<uint8>& OutBytes) const;
+
+private:
+	LearningDecisionTreeCore::FFlatView Core;
+};
+
+/**
+ * Owns the storage behind a flat tree: either a memory-mapped file region or an in-memory copy.
+ */
+class LEARNINGDECISIONTREE_API FLearningDecisionTreeFlatModel
+{
+public:
+	FLearningDecisionTreeFlatModel();
+	~FLearningDecisionTreeFlatModel();
+
+	/** Maps a .ftree file read-only. Falls back to reading it into memory on platforms without mapping support. */
+	static TSharedPtr<FLearningDecisionTreeFlatModel> OpenFile(const FString& FullPath);
+
+	/** Takes ownership of an in-memory blob. */
+	static TSharedPtr<FLearningDecisionTreeFlatModel> FromBytes(TArray<uint8>&& Bytes);
+
+	const FLearningDecisionTreeFlatView& GetView() const { return View; }
+
+	/** True if the blob is evaluated directly from mapped file pages. */
+	bool IsMapped() const { return MappedRegion.IsValid(); }
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> Bytes;
+	FLearningDecisionTreeFlatView View;
+};
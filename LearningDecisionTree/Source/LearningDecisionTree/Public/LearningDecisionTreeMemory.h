@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeMemory.generated.h"
+
+/** Memory held by a ULearningDecisionTree, in bytes. See ULearningDecisionTree::GetMemoryReport(). */
+USTRUCT(BlueprintType)
+struct FLearningDecisionTreeMemoryReport
+{
+	GENERATED_BODY()
+
+	/** The training Table. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int64 TableBytes = 0;
+
+	/** The node UObjects and their arrays, or the flat tree when one is loaded. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int64 TreeBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 TreeNodes = 0;
+
+	/** Memory kept between builds for training: the training sample and journal buffers. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int64 TransientBytes = 0;
+
+	/** Most memory the last CreateDecisionTree() held on top of the Table, in per-node tables and the training sample. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int64 BuildPeakBytes = 0;
+
+	int64 GetTotalBytes() const { return TableBytes + TreeBytes + TransientBytes; }
+};
+
+/** Effect of ULearningDecisionTree::ShareIdenticalSubtrees(). */
+USTRUCT(BlueprintType)
+struct FLearningDecisionTreeShareReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NodesBefore = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NodesAfter = 0;
+
+	/** FLearningDecisionTreeMemoryReport::TreeBytes before and after. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int64 TreeBytesBefore = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int64 TreeBytesAfter = 0;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Serialization/BulkData.h"
+#include "LearningDecisionTreeEvalContext.h"
+#include "LearningDecisionTreeFlat.h"
+#include "LearningDecisionTreeModelAsset.generated.h"
+
+class ULearningDecisionTree;
+
+/**
+ * A trained decision tree stored as a cookable asset.
+ * The tree is kept in the flat format (see FLearningDecisionTreeFlatView) in a bulk data payload,
+ * so it is cooked and streamed in with normal (async) asset loading, and evaluated in place
+ * without constructing any node UObjects.
+ *
+ * Build it in the editor from a trained ULearningDecisionTree with BuildFromDecisionTree(), then either
+ * evaluate the asset directly or hand it to ULearningDecisionTree::LoadDecisionTreeFromAsset().
+ */
+UCLASS(BlueprintType)
+class LEARNINGDECISIONTREE_API ULearningDecisionTreeModelAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Names of the feature columns the model was trained on, in row order. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "LearningDecisionTree")
+	TArray<FName> FeatureNames;
+
+	/** Name of the action column. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "LearningDecisionTree")
+	FName ActionName;
+
+#if WITH_EDITOR
+	/**
+	 * Compiles the tree's current decision tree into this asset and marks it dirty.
+	 * Returns false if the tree has no decision tree.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree")
+	bool BuildFromDecisionTree(ULearningDecisionTree* Tree);
+#endif
+
+	/** True if the asset holds a valid model. */
+	UFUNCTION(BlueprintPure, Category = "LearningDecisionTree")
+	bool HasModel() const { return Model.IsValid(); }
+
+	/** Length of the feature rows the model expects. */
+	UFUNCTION(BlueprintPure, Category = "LearningDecisionTree")
+	int32 GetNumFeatures() const;
+
+	/** See ULearningDecisionTree::EvalWithContext(). */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "LearningDecisionTree")
+	int32 EvalWithContext(UPARAM(ref) FLearningDecisionTreeEvalContext& Context) const;
+
+	/** See ULearningDecisionTree::EvalRow(). */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "LearningDecisionTree")
+	int32 EvalRow(const TArray<int32>& Row, UPARAM(ref) FLearningDecisionTreeEvalContext& Context) const;
+
+	/** The loaded model, shared with any ULearningDecisionTree it was handed to. Null if there is none. */
+	TSharedPtr<const FLearningDecisionTreeFlatModel> GetModel() const { return Model; }
+
+	/** Identifies the loaded model for evaluation context caching. */
+	uint32 GetTreeVersion() const { return TreeVersion; }
+
+	//~ UObject interface
+	virtual void Serialize(FArchive& Ar) override;
+
+private:
+	/** Creates Model from Payload. */
+	void CreateModel();
+
+	/** The flat tree blob. */
+	FByteBulkData Payload;
+
+	TSharedPtr<const FLearningDecisionTreeFlatModel> Model;
+	uint32 TreeVersion = 0;
+};
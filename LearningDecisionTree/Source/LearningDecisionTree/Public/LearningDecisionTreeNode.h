@@ -30,6 +30,12 @@ public:
 	 * @param NodesToExplode The list of nodes pending processing.
 	 */
 	virtual void ExplodeNode(TArray<ULearningDecisionTreeNode*>& NodesToExplode);
+
+	/** Heap memory owned by the node's containers, in bytes, excluding the UObject itself. */
+	virtual SIZE_T GetAllocatedSize() const;
+
+	//~ UObject interface
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
 };
 
 /**
@@ -73,6 +79,8 @@ public:
 	 */
 	virtual void ExplodeNode(TArray<ULearningDecisionTreeNode*>& NodesToExplode) override;
 
+	virtual SIZE_T GetAllocatedSize() const override;
+
 private:
 	/** Temporary list to hold children nodes before they are moved to the resulting DecisionNode. */
 	TArray<ULearningDecisionTreeNode*> NextNodes;
@@ -111,16 +119,46 @@ public:
 	UPROPERTY()
 	int32 BestInfoGainColumn = 0;
 
+	/**
+	 * The index of the split column in the original (unfiltered) feature row.
+	 * BestInfoGainColumn is relative to the filtered table this node was built from;
+	 * FeatureIndex is resolved by ULearningDecisionTree after building or loading the tree.
+	 */
+	UPROPERTY()
+	int32 FeatureIndex = INDEX_NONE;
+
 	/** Initializes the DecisionNode. */
 	void Init(const TArray<ULearningDecisionTreeNode*>& InNodes, const TArray<int32>& InColumnStates, int32 InBestColumn);
 
 	/**
 	 * Traverses the tree by matching the value in the row at BestInfoGainColumn
-	 * with ColumnStates, and recursively evaluating the corresponding child node.
+	 * with ColumnStates, and evaluating the corresponding child node with the row minus that column.
+	 * The filtered rows are never built, and the columns split on are kept inline, so this does not allocate
+	 * for paths up to 64 levels deep. Deeper paths allocate on every call.
 	 */
 	virtual int32 Eval(const TArray<int32>& Row) override;
 
+	/**
+	 * Returns the index of the child matching a full (unfiltered) feature row at FeatureIndex,
+	 * or -1 if the state was never seen during training.
+	 */
+	int32 FindBranch(TArrayView<const int32> Row) const;
+
 	virtual void ExplodeNode(TArray<ULearningDecisionTreeNode*>& NodesToExplode) override;
+
+	virtual SIZE_T GetAllocatedSize() const override;
+
+	/**
+	 * Evaluations that took each branch, parallel to Nodes, gathered while ULearningDecisionTree::bProfileBranches is set.
+	 * Empty unless branch profiling is compiled in. Not saved.
+	 */
+	mutable TArray<int32> BranchHits;
+
+	/** Counts an evaluation that took Branch. Thread safe. */
+	void AddBranchHit(int32 Branch) const;
+
+	/** Reorders the branches by BranchHits, most taken first, so FindBranch() and Eval() test hot states first. */
+	void SortBranchesByHits();
 };
 
 /**
@@ -148,9 +186,23 @@ public:
 	 */
 	virtual int32 Eval(const TArray<int32>& Row) override;
 
+	/** Selects an action probabilistically based on ActionCounts. Returns -1 if the leaf is empty. */
+	int32 SampleAction() const;
+
+	/**
+	 * Same as SampleAction(), but draws from a caller-owned stream instead of the global RNG,
+	 * so several threads can sample the same leaf at once.
+	 */
+	int32 SampleAction(FRandomStream& RandomStream) const;
+
+	/** Returns the action with the highest count. Returns -1 if the leaf is empty. */
+	int32 MostLikelyAction() const;
+
 	virtual void ExplodeNode(TArray<ULearningDecisionTreeNode*>& NodesToExplode) override;
 
+	virtual SIZE_T GetAllocatedSize() const override;
+
 private:
-	/** Selects an index based on weighted probability. */
-	int32 RandAction(const TArray<int32>& Probs);
+	/** Selects an index based on weighted probability. Uses the global RNG if RandomStream is null. */
+	int32 RandAction(const TArray<int32>& Probs, FRandomStream* RandomStream = nullptr) const;
 };
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeTable.h"
+#include "LearningDecisionTreeSampling.generated.h"
+
+/** How CreateDecisionTree() picks the rows it trains on. */
+UENUM(BlueprintType)
+enum class ELearningDecisionTreeSampling : uint8
+{
+	/** Train on the whole table. */
+	None,
+	/** Train on a uniform sample of the table's samples (duplicates included). */
+	Reservoir,
+	/** Train on a uniform sample per action, so rare actions keep their rows. Counts are scaled back to each action's share. */
+	StratifiedByAction
+};
+
+/** Compares a decision tree trained on the training sample with one trained on the whole table. */
+USTRUCT(BlueprintType)
+struct FLearningDecisionTreeSampleReport
+{
+	GENERATED_BODY()
+
+	/** Samples in the whole table and in the training sample. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 FullRows = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 SampledRows = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	float FullBuildSeconds = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	float SampledBuildSeconds = 0.0f;
+
+	/** Feature tested at the root of each tree, or INDEX_NONE if the root is a leaf. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 FullRootFeature = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 SampledRootFeature = INDEX_NONE;
+
+	/** Splits of the sampled tree reached by a path that also ends in a split of the full tree. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 ComparedSplits = 0;
+
+	/** Compared splits that test the same feature as the full tree. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 MatchingSplits = 0;
+
+	/** Splits of the sampled tree where the full tree has a leaf instead. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 ExtraSplits = 0;
+
+	/** Fraction of the table's samples for which both trees predict the same most likely action. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	float ActionAgreement = 0.0f;
+};
+
+/**
+ * Fixed-size uniform sample over a stream of rows (Algorithm L).
+ * The gaps between accepted samples are drawn geometrically, so adding a row with a large count
+ * costs O(1 + replacements) rather than O(count).
+ */
+class LEARNINGDECISIONTREE_API FLearningDecisionTreeReservoir
+{
+public:
+	void Reset(int32 InCapacity, int32 InWidth, int32 Seed);
+
+	/** Feeds Count samples of Row into the stream. */
+	void Add(TArrayView<const int32> Row, int32 Count = 1);
+
+	int32 Num() const { return Width > 0 ? Rows.Num() / Width : 0; }
+	const int32* GetRow(int32 Index) const { return Rows.GetData() + (int64)Index * Width; }
+
+	/** Samples fed so far. */
+	int64 GetNumSeen() const { return NumSeen; }
+
+	SIZE_T GetAllocatedSize() const { return Rows.GetAllocatedSize(); }
+
+private:
+	/** Number of samples to pass over before the next one is accepted. */
+	int64 DrawSkip();
+
+	int32 Capacity = 0;
+	int32 Width = 0;
+	TArray<int32> Rows;
+	int64 NumSeen = 0;
+	int64 NextAccepted = 0;
+	double W = 0.0;
+	FRandomStream RandomStream;
+};
+
+/**
+ * The training sample of a table, kept up to date one AddRow() at a time so a rebuild
+ * trains on a bounded number of rows no matter how large the table grows.
+ */
+class LEARNINGDECISIONTREE_API FLearningDecisionTreeTableSampler
+{
+public:
+	/** Starts an empty sample for rows of Width columns (Action column last). */
+	void Reset(ELearningDecisionTreeSampling InMode, int32 InSampleSize, int32 InWidth, int32 InSeed);
+
+	/** Feeds every row of Table, with its duplicate count. */
+	void AddTable(const FLearningDecisionTreeTable& Table);
+
+	/** Feeds Count samples of Row. */
+	void AddRow(TArrayView<const int32> Row, int32 Count = 1);
+
+	/** Builds the table to train on from the current sample. */
+	void BuildTable(const TArray<FName>& ColumnNames, FLearningDecisionTreeTable& OutTable) const;
+
+	/** True if the sample holds every sample fed so far, i.e. it is the whole table. */
+	bool IsComplete() const;
+
+	/** Heap memory held by the sample, in bytes. */
+	SIZE_T GetAllocatedSize() const;
+
+	bool Matches(ELearningDecisionTreeSampling InMode, int32 InSampleSize, int32 InWidth, int32 InSeed) const
+	{
+		return Mode == InMode && SampleSize == InSampleSize && Width == InWidth && Seed == InSeed;
+	}
+
+private:
+	ELearningDecisionTreeSampling Mode = ELearningDecisionTreeSampling::None;
+	int32 SampleSize = 0;
+	int32 Width = 0;
+	int32 Seed = 0;
+
+	/** One reservoir per action when stratified, otherwise a single one under key 0. */
+	TMap<int32, FLearningDecisionTreeReservoir> Strata;
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LearningDecisionTreeEvalContext.h"
+#include "LearningDecisionTreeScheduler.generated.h"
+
+class ULearningDecisionTree;
+
+/** Fills an agent's feature row (Action column excluded) right before it is evaluated. Must not register or unregister agents. */
+DECLARE_DELEGATE_OneParam(FLearningDecisionTreeStateSource, TArray<int32>& /*InOutStates*/);
+
+/** Receives the action decided for an agent. Called on the game thread. */
+DECLARE_DELEGATE_TwoParams(FOnLearningDecisionTreeDecision, int32 /*AgentId*/, int32 /*Action*/);
+
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FLearningDecisionTreeDecisionEvent, UObject*, Agent, int32, Action);
+
+/** What the scheduler did on its last tick. */
+USTRUCT(BlueprintType)
+struct FLearningDecisionTreeSchedulerStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NumAgents = 0;
+
+	/** Agents that were due for a decision. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NumDue = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NumEvaluated = 0;
+
+	/** Due agents left for a later tick because the budget ran out. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 NumDeferred = 0;
+
+	/** Time from an agent becoming due to its decision, over the agents evaluated. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	float AverageLatencyMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	float MaxLatencyMs = 0.0f;
+
+	/** Time spent evaluating and delivering decisions. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	float TickMicroseconds = 0.0f;
+};
+
+/**
+ * Evaluates many agents' decision trees within a per-frame time budget.
+ *
+ * Each registered agent has a model, a feature row and a callback. An agent is due for a new decision when its
+ * states changed or MaxDecisionInterval has passed since its last one. Every tick the due agents are ordered by
+ * priority (changed states, distance to the local player's view, time waited) and evaluated in that order,
+ * agents of equal priority grouped by model, until BudgetMicroseconds is spent; the rest are deferred to the next tick.
+ *
+ * States are pushed with SetAgentStates()/SetAgentState(), or pulled from the agent's state source just before
+ * it is evaluated; MarkStateChanged() makes a pulling agent due without pushing a row.
+ * Evaluation uses EvalWithContext(), so an agent whose tested features did not change skips the traversal.
+ */
+UCLASS()
+class LEARNINGDECISIONTREE_API ULearningDecisionTreeScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Time the scheduler may spend per tick, checked after every agent. At least one agent is evaluated per tick regardless. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Scheduler", meta = (ClampMin = "0"))
+	float BudgetMicroseconds = 500.0f;
+
+	/** An agent with unchanged states is re-decided after this many seconds, so sampled leaves are drawn again. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Scheduler", meta = (ClampMin = "0"))
+	float MaxDecisionInterval = 1.0f;
+
+	/** Priority of an agent whose states changed. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Scheduler")
+	float StateChangedWeight = 10.0f;
+
+	/** Priority of an agent at the player's view, falling to 0 at MaxPriorityDistance. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Scheduler")
+	float DistanceWeight = 5.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Scheduler", meta = (ClampMin = "1"))
+	float MaxPriorityDistance = 5000.0f;
+
+	/** Priority per second an agent has waited since it became due, so far agents are not starved. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LearningDecisionTree|Scheduler")
+	float WaitWeight = 20.0f;
+
+	/**
+	 * Registers an agent whose states are pushed with SetAgentStates()/SetAgentState().
+	 * @param Agent Optional. An actor or component gives the distance priority; the agent is dropped once it is destroyed.
+	 * Returns the agent id, or INDEX_NONE if Model is null.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Scheduler")
+	int32 RegisterAgent(UObject* Agent, ULearningDecisionTree* Model, FLearningDecisionTreeDecisionEvent OnDecision);
+
+	/** Native form of RegisterAgent(). StateSource, if bound, fills the states before every evaluation of the agent. */
+	int32 RegisterAgent(UObject* Agent, ULearningDecisionTree* Model, FLearningDecisionTreeStateSource StateSource, FOnLearningDecisionTreeDecision OnDecision);
+
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Scheduler")
+	void UnregisterAgent(int32 AgentId);
+
+	/** Replaces the agent's feature row. The agent becomes due if any state changed. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Scheduler")
+	void SetAgentStates(int32 AgentId, const TArray<int32>& States);
+
+	/** Sets one feature of the agent. The agent becomes due if it changed. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Scheduler")
+	void SetAgentState(int32 AgentId, int32 FeatureIndex, int32 Value);
+
+	/** Makes the agent due as if its states had changed, for agents whose state source pulls the row. */
+	UFUNCTION(BlueprintCallable, Category = "LearningDecisionTree|Scheduler")
+	void MarkStateChanged(int32 AgentId);
+
+	/** The last action decided for the agent, or -1. */
+	UFUNCTION(BlueprintPure, Category = "LearningDecisionTree|Scheduler")
+	int32 GetLastAction(int32 AgentId) const;
+
+	UFUNCTION(BlueprintPure, Category = "LearningDecisionTree|Scheduler")
+	FLearningDecisionTreeSchedulerStats GetSchedulerStats() const { return Stats; }
+
+	//~ UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	//~ UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FAgent
+	{
+		int32 Id = INDEX_NONE;
+		TWeakObjectPtr<UObject> Agent;
+		bool bHasAgent = false;
+		TWeakObjectPtr<ULearningDecisionTree> Model;
+		FLearningDecisionTreeEvalContext Context;
+		FLearningDecisionTreeStateSource StateSource;
+		FOnLearningDecisionTreeDecision OnDecision;
+		FLearningDecisionTreeDecisionEvent OnDecisionEvent;
+		int32 LastAction = -1;
+		double LastDecisionTime = 0.0;
+		/** When the states last changed without a decision since. 0 if they did not. */
+		double StateChangedTime = 0.0;
+	};
+
+	int32 AddAgent(UObject* Agent, ULearningDecisionTree* Model);
+	FAgent* FindAgent(int32 AgentId);
+
+	/** Agents in no particular order; AgentIndices maps ids to positions. */
+	TArray<FAgent> Agents;
+	TMap<int32, int32> AgentIndices;
+	int32 NextAgentId = 0;
+
+	FLearningDecisionTreeSchedulerStats Stats;
+};
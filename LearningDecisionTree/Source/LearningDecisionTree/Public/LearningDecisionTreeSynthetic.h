@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeTable.h"
+
+/** Shape of a synthetic training table. */
+struct FLearningDecisionTreeSyntheticSpec
+{
+	int32 NumRows = 10000;
+	int32 NumFeatures = 8;
+
+	/** States per feature column: every feature takes values 0..Cardinality-1. */
+	int32 Cardinality = 4;
+
+	int32 NumActions = 4;
+
+	/** The first features decide the label; the rest are uniform noise the tree has to ignore. */
+	int32 NumInformativeFeatures = 3;
+
+	/** Probability that a row's label is replaced by a random action. */
+	float LabelNoise = 0.05f;
+
+	int32 Seed = 1;
+};
+
+/**
+ * Deterministic synthetic tables for tests and benchmarks.
+ * Labels follow a fixed rule over the informative features (see Label()), so a tree trained on
+ * noise-free data can be checked for exact predictions.
+ */
+struct LEARNINGDECISIONTREE_API FLearningDecisionTreeSyntheticData
+{
+	/** Feature0 .. FeatureN-1, then Action. */
+	static TArray<FName> MakeColumnNames(const FLearningDecisionTreeSyntheticSpec& Spec);
+
+	/** The noise-free label of a feature row. */
+	static int32 Label(const FLearningDecisionTreeSyntheticSpec& Spec, TArrayView<const int32> Features);
+
+	/** Generates Spec.NumRows rows of NumFeatures + 1 values (Action last), row after row. */
+	static void Generate(const FLearningDecisionTreeSyntheticSpec& Spec, TArray<int32>& OutRows);
+
+	/** Generates the rows straight into a table, merging duplicates, without going through AddRow. */
+	static void GenerateTable(const FLearningDecisionTreeSyntheticSpec& Spec, FLearningDecisionTreeTable& OutTable);
+};
@@ -46,6 +46,9 @@ public:
 	/** Returns the total number of rows, including duplicates count. */
 	int32 GetTotalRowCount() const;
 
+	/** Heap memory used by the table's containers, in bytes. */
+	SIZE_T GetAllocatedSize() const;
+
 	/** Gets the count of a specific state (value) in a column, accounting for row duplicates. */
 	int32 GetStateCount(const FName& Column, int32 State);
 	int32 GetStateCount(int32 ColumnIndex, int32 State);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeTable.h"
+#include "LearningDecisionTreeTableCsv.generated.h"
+
+/** Throughput of a CSV import or export. */
+USTRUCT(BlueprintType)
+struct FLearningDecisionTreeCsvStats
+{
+	GENERATED_BODY()
+
+	/** Size of the file read or written. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int64 Bytes = 0;
+
+	/** Data lines read or written, including duplicates. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 Rows = 0;
+
+	/** Distinct rows (physical table rows). */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 UniqueRows = 0;
+
+	/** Import only: lines that were not a full row of integers and were left out. */
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	int32 SkippedLines = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LearningDecisionTree")
+	float Seconds = 0.0f;
+
+	float GetMegabytesPerSecond() const { return Seconds > 0.0f ? (float)(Bytes / (1024.0 * 1024.0)) / Seconds : 0.0f; }
+	float GetRowsPerSecond() const { return Seconds > 0.0f ? Rows / Seconds : 0.0f; }
+};
+
+/**
+ * Bulk CSV/TSV import and export for training tables.
+ *
+ * The first line holds the column names, the Action column LAST. Every other line is one sample
+ * of integer states, separated by the delimiter; fields may be padded with spaces or quoted.
+ * Import memory-maps the file, parses it in line-aligned chunks with ParallelFor and merges
+ * duplicate rows into DuplicateCounts on the way, so millions of rows load without AddRow's linear scan.
+ * Export formats blocks of rows in parallel and streams them to disk in order.
+ */
+struct LEARNINGDECISIONTREE_API FLearningDecisionTreeTableCsv
+{
+	/**
+	 * Reads a table from a CSV/TSV file. OutTable is only replaced if the file has a valid header.
+	 * @param Delimiter Field separator, or 0 to use a tab if the header contains one and a comma otherwise.
+	 */
+	static bool Import(const FString& FullPath, FLearningDecisionTreeTable& OutTable, FLearningDecisionTreeCsvStats* OutStats = nullptr, TCHAR Delimiter = 0);
+
+	/**
+	 * Writes a table as CSV/TSV, streaming it to disk.
+	 * @param bExpandDuplicates Write every duplicate of a row as its own line, so Import() restores the same counts.
+	 *                          Otherwise every distinct row is written once.
+	 */
+	static bool Export(const FString& FullPath, const FLearningDecisionTreeTable& Table, FLearningDecisionTreeCsvStats* OutStats = nullptr,
+		TCHAR Delimiter = TEXT(','), bool bExpandDuplicates = true);
+
+	/** Chunk size that Import() splits the file into for parallel parsing. */
+	static constexpr int64 ImportChunkBytes = 1024 * 1024;
+
+	/** Rows formatted per parallel block by Export(). */
+	static constexpr int32 ExportBlockRows = 16 * 1024;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LearningDecisionTreeTable.h"
+#include "LearningDecisionTreeTableFile.generated.h"
+
+/** Block compression used when saving a table. */
+UENUM(BlueprintType)
+enum class ELearningDecisionTreeCompression : uint8
+{
+	None,
+	Zlib,
+	Oodle
+};
+
+/**
+ * Binary table file format (.dat) written by ULearningDecisionTree::SaveTable.
+ *
+ * The format and its only reader and writer are the engine-independent core library's
+ * (LearningDecisionTreeCore/TableFile.h, which documents the layout), so the offline tools read and write the
+ * same files. The classes below move those bytes through an FArchive and give the core FCompression for its
+ * blocks, which adds Oodle to zlib. Files written before this format existed (no magic) are still read.
+ */
+struct LEARNINGDECISIONTREE_API FLearningDecisionTreeTableFile
+{
+	/** The core library's FTableFile::Magic and Version. */
+	static constexpr uint32 Magic = 0x4254444C; // "LDTB"
+	static constexpr uint16 Version = 1;
+};
+
+/** Writes a table into an archive using the current file format. */
+class LEARNINGDECISIONTREE_API FLearningDecisionTreeTableWriter
+{
+public:
+	FLearningDecisionTreeTableWriter(FArchive& InAr, ELearningDecisionTreeCompression InCompression = ELearningDecisionTreeCompression::None);
+
+	/**
+	 * Writes the whole table. Returns false if a column is missing or has the wrong number of rows,
+	 * or the archive reported an error. The file is encoded in memory first, then written in one go.
+	 */
+	bool Write(const FLearningDecisionTreeTable& Table);
+
+	/** The checksum stored at the end of the file by the last Write(). Identifies the written snapshot. */
+	uint32 GetChecksum() const { return Crc; }
+
+private:
+	FArchive& Ar;
+	ELearningDecisionTreeCompression Compression;
+	uint32 Crc = 0;
+};
+
+/** Reads a table from the rest of an archive. Detects and reads the legacy format too. */
+class LEARNINGDECISIONTREE_API FLearningDecisionTreeTableReader
+{
+public:
+	explicit FLearningDecisionTreeTableReader(FArchive& InAr);
+
+	/**
+	 * Reads a whole table into OutTable.
+	 * OutTable is only modified if the file is complete, consistent and its checksum matches.
+	 */
+	bool Read(FLearningDecisionTreeTable& OutTable);
+
+	/** True if the last Read() found a file written before the versioned format existed. */
+	bool IsLegacyFormat() const { return bLegacyFormat; }
+
+	/** The checksum of the file read by the last successful Read(). Always 0 for legacy files. */
+	uint32 GetChecksum() const { return bLegacyFormat ? 0 : Crc; }
+
+private:
+	FArchive& Ar;
+	uint32 Crc = 0;
+	bool bLegacyFormat = false;
+};
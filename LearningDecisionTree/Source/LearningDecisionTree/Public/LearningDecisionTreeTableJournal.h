@@ -0,0 +1,132 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Pipe.h"
+#include "LearningDecisionTreeTable.h"
+
+/** Identifies the table snapshot (.dat file) a journal extends. */
+struct FLearningDecisionTreeSnapshotId
+{
+	/** Checksum stored in the snapshot file. 0 for legacy files or when there is no snapshot yet. */
+	uint32 Checksum = 0;
+
+	/** Size of the snapshot file in bytes. 0 when there is no snapshot yet. */
+	int64 Size = 0;
+
+	bool operator==(const FLearningDecisionTreeSnapshotId& Other) const { return Checksum == Other.Checksum && Size == Other.Size; }
+	bool operator!=(const FLearningDecisionTreeSnapshotId& Other) const { return !(*this == Other); }
+};
+
+/**
+ * Append-only log of table changes (.journal), written next to a table snapshot (.dat).
+ * Each AddColumn/AddRow is buffered and appended as a compact record, so persisting new training data
+ * costs O(new rows) instead of rewriting the whole table. Loading replays snapshot + journal.
+ *
+ * Layout (little-endian):
+ *   uint32 Magic, uint16 Version, uint16 Reserved, uint32 SnapshotChecksum, int64 SnapshotSize
+ *   Records: uint8 Type, uint32 PayloadSize, uint32 PayloadCrc, payload
+ *     Rows:   varint NumRows, varint RowWidth, then NumRows * RowWidth zigzag varints
+ *     Column: UTF-8 column name
+ *
+ * A journal only applies to the snapshot it was started for. After the snapshot is rewritten
+ * (compaction), the old journal no longer matches and is ignored, so a crash between writing the
+ * snapshot and resetting the journal never replays rows twice. A torn record at the end of the file
+ * (crash during an append) fails its checksum and ends the replay.
+ */
+class LEARNINGDECISIONTREE_API FLearningDecisionTreeTableJournal
+{
+public:
+	static constexpr uint32 Magic = 0x4A54444C; // "LDTJ"
+	static constexpr uint16 Version = 1;
+
+	FLearningDecisionTreeTableJournal();
+	~FLearningDecisionTreeTableJournal();
+
+	/**
+	 * Opens the journal at JournalPath for appending.
+	 * An existing journal for the same snapshot is kept (a torn tail is cut off); otherwise a new, empty one is started.
+	 */
+	bool Open(const FString& InJournalPath, const FLearningDecisionTreeSnapshotId& InSnapshot);
+
+	/** Writes out everything still buffered and closes the file. */
+	void Close();
+
+	bool IsOpen() const { return FileWriter.IsValid(); }
+
+	/** Throws away the journal's contents and starts over for a new snapshot. */
+	bool Reset(const FLearningDecisionTreeSnapshotId& NewSnapshot);
+
+	/**
+	 * Starts the journal over for a new snapshot, keeping the records written at or after KeepFromPosition.
+	 * Used when a snapshot was taken at KeepFromPosition while more rows kept being journaled.
+	 */
+	bool Rebase(const FLearningDecisionTreeSnapshotId& NewSnapshot, int64 KeepFromPosition);
+
+	/**
+	 * Waits for pending writes and returns the position after the last record appended so far.
+	 * Positions keep pointing at the same records across Rebase().
+	 */
+	int64 GetPosition();
+
+	/** Buffers a row for the journal. Rows are written out when the buffer is full or on Flush(). */
+	void AppendRow(TArrayView<const int32> Row);
+
+	/** Buffers a new column for the journal. */
+	void AppendColumn(const FName& ColumnName);
+
+	/**
+	 * Hands buffered records to the writer.
+	 * @param bWait Block until everything handed over so far has reached the file.
+	 */
+	void Flush(bool bWait = false);
+
+	/** Number of rows appended since the journal was started for its snapshot. */
+	int32 GetNumRows() const { return NumRows; }
+
+	/** Memory held by records not handed to the writer yet, in bytes. */
+	SIZE_T GetAllocatedSize() const { return PendingRecords.GetAllocatedSize() + BatchValues.GetAllocatedSize(); }
+
+	/**
+	 * Applies the records of the journal at JournalPath to Table, if the journal extends Snapshot.
+	 * @param OutNumRows Receives the number of rows replayed.
+	 * @param OutValidSize Receives the size of the readable prefix of the file.
+	 * @return False if there is no journal or it belongs to another snapshot.
+	 */
+	static bool Replay(const FString& JournalPath, const FLearningDecisionTreeSnapshotId& Snapshot, FLearningDecisionTreeTable& Table, int32& OutNumRows, int64& OutValidSize);
+
+	/** Buffered bytes that trigger a write. */
+	int32 FlushThresholdBytes = 64 * 1024;
+
+	/** If true, records are written on a background task; otherwise Flush() writes on the calling thread. */
+	bool bAsyncWrites = true;
+
+private:
+	/** Turns the pending row batch into a complete record. */
+	void CloseRowBatch();
+
+	/** Appends a framed record to PendingRecords. */
+	void AddRecord(uint8 Type, const TArray<uint8>& Payload);
+
+	/** Creates the journal file holding only a header. */
+	bool CreateEmpty();
+
+	FString JournalPath;
+	FLearningDecisionTreeSnapshotId Snapshot;
+	TUniquePtr<FArchive> FileWriter;
+
+	/** Complete records waiting to be written. */
+	TArray<uint8> PendingRecords;
+
+	/** Rows of the record being built: zigzag varints, BatchRowWidth values per row. */
+	TArray<uint8> BatchValues;
+	int32 BatchRowCount = 0;
+	int32 BatchRowWidth = 0;
+
+	int32 NumRows = 0;
+
+	/** Bytes removed from the front of the file by Rebase() since the journal was started. */
+	int64 RebasedBytes = 0;
+
+	/** Serializes background writes so records reach the file in order. */
+	UE::Tasks::FPipe WritePipe;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LearningDecisionTreeTrainCommandlet.generated.h"
+
+class ULearningDecisionTree;
+
+/**
+ * Builds decision trees offline from saved tables, one model per table file, in parallel across cores.
+ * Each table (Name.dat, or Name.csv / Name.tsv) is trained with CreateDecisionTree() and written as Name.tree.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=LearningDecisionTreeTrain -nullrhi
+ *     (-Tables=<a.dat>+<b.dat> | -Dir=<folder>) [-Output=<folder>] [-Flat] [-SingleThread]
+ *
+ * -Output defaults to the folder of each table. -Flat also writes Name.ftree.
+ * Returns 0 if every model was built and written.
+ */
+UCLASS()
+class LEARNINGDECISIONTREE_API ULearningDecisionTreeTrainCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	ULearningDecisionTreeTrainCommandlet();
+
+	//~ UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/** One tree per table being trained, kept referenced while building. */
+	UPROPERTY()
+	TArray<ULearningDecisionTree*> Trees;
+};
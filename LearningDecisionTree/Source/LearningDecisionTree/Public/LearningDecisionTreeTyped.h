@@ -0,0 +1,363 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
+#include "LearningDecisionTree.h"
+#include <tuple>
+#include <type_traits>
+
+/**
+ * Number of states of an enum used as a TLearningDecisionTree column.
+ * Defaults to the enum's Count enumerator; specialize it for enums that end differently.
+ */
+template <typename EnumType>
+struct TLearningDecisionTreeCardinality
+{
+	static constexpr int32 Value = (int32)EnumType::Count;
+};
+
+/**
+ * Typed front end for ULearningDecisionTree with a fixed, enum-based schema known at compile time.
+ * The template arguments are the column enums in column order, the action enum LAST, like the Table:
+ *
+ *   enum class EEnemyNearby : uint8 { No, Yes, Count };
+ *   enum class ELowHealth : uint8 { No, Yes, Count };
+ *   enum class EAction : uint8 { Attack, Retreat, Patrol, Count };
+ *
+ *   TLearningDecisionTree<EEnemyNearby, ELowHealth, EAction> Tree;
+ *   Tree.AddRow(Tree.MakeRow(EEnemyNearby::Yes, ELowHealth::No), EAction::Attack);
+ *   Tree.CreateDecisionTree();
+ *   TOptional<EAction> Action = Tree.Eval(Tree.MakeRow(EEnemyNearby::Yes, ELowHealth::Yes), RandomStream);
+ *
+ * Rows are fixed-size stack arrays stored in the narrowest integer that holds every feature's states.
+ * Training, saving and loading go through the wrapped ULearningDecisionTree (GetModel()), so a typed tree can
+ * share a model with untyped code. Evaluation runs on a compiled copy of the model in which every decision indexes
+ * its children directly by state, instead of searching the states seen in training.
+ * Call Compile() after the model is created or loaded through GetModel().
+ */
+template <typename... ColumnEnums>
+class TLearningDecisionTree
+{
+	static_assert(sizeof...(ColumnEnums) >= 2, "TLearningDecisionTree needs at least one feature and the action column.");
+	static_assert(((TLearningDecisionTreeCardinality<ColumnEnums>::Value > 0) && ...), "Every column enum needs at least one state.");
+
+public:
+	static constexpr int32 NumColumns = sizeof...(ColumnEnums);
+	static constexpr int32 NumFeatures = NumColumns - 1;
+
+	/** Enum of column Index. The last one is the action. */
+	template <int32 Index>
+	using TColumn = std::tuple_element_t<Index, std::tuple<ColumnEnums...>>;
+
+	using FAction = TColumn<NumFeatures>;
+
+	static constexpr int32 NumActions = TLearningDecisionTreeCardinality<FAction>::Value;
+
+	/** States of every column, in column order. */
+	static constexpr int32 Cardinalities[NumColumns] = { TLearningDecisionTreeCardinality<ColumnEnums>::Value... };
+
+	static constexpr int32 GetMaxFeatureCardinality()
+	{
+		int32 Max = 0;
+		for (int32 Feature = 0; Feature < NumFeatures; Feature++)
+		{
+			Max = Cardinalities[Feature] > Max ? Cardinalities[Feature] : Max;
+		}
+		return Max;
+	}
+
+	/** Narrowest type that holds a state of every feature. */
+	using FState = std::conditional_t<GetMaxFeatureCardinality() <= 256, uint8, std::conditional_t<GetMaxFeatureCardinality() <= 65536, uint16, int32>>;
+
+	/** A feature row (Action excluded). */
+	using FRow = TStaticArray<FState, NumFeatures>;
+
+	/** Wraps Model, or a new transient model with one column per enum if it is null. */
+	explicit TLearningDecisionTree(ULearningDecisionTree* InModel = nullptr)
+		: Model(InModel ? InModel : NewObject<ULearningDecisionTree>(GetTransientPackage()))
+	{
+		if (Model->GetColumnCount() == 0)
+		{
+			AddColumns(std::make_integer_sequence<int32, NumColumns>());
+		}
+		Compile();
+	}
+
+	ULearningDecisionTree* GetModel() const { return Model.Get(); }
+
+	/** Builds a row from one value per feature, in column order. */
+	template <typename... FeatureValues>
+	static FRow MakeRow(FeatureValues... Values)
+	{
+		static_assert(sizeof...(FeatureValues) == NumFeatures, "MakeRow takes one value per feature.");
+		FRow Row;
+		SetFeatures(Row, std::make_integer_sequence<int32, NumFeatures>(), Values...);
+		return Row;
+	}
+
+	/** Sets feature Index of Row. */
+	template <int32 Index>
+	static void SetFeature(FRow& Row, TColumn<Index> Value)
+	{
+		static_assert(Index >= 0 && Index < NumFeatures, "Feature index out of range.");
+		Row[Index] = (FState)Value;
+	}
+
+	/** Adds a training sample to the model. */
+	void AddRow(const FRow& Row, FAction Action)
+	{
+		// Reuses one buffer, so adding rows does not allocate once it has grown to the row width
+		ScratchRow.Reset(NumColumns);
+		for (int32 Feature = 0; Feature < NumFeatures; Feature++)
+		{
+			ScratchRow.Add((int32)Row[Feature]);
+		}
+		ScratchRow.Add((int32)Action);
+		Model->AddRow(ScratchRow);
+	}
+
+	/** Trains the model on its Table and compiles the result. */
+	void CreateDecisionTree()
+	{
+		Model->CreateDecisionTree();
+		Compile();
+	}
+
+	/**
+	 * Compiles the model's current tree (node or flat) for typed evaluation.
+	 * Returns false, leaving nothing compiled, if there is no tree or it tests a feature or predicts an action
+	 * outside the schema.
+	 */
+	bool Compile()
+	{
+		Nodes.Reset();
+		Children.Reset();
+		LeafCounts.Reset();
+		MostLikely.Reset();
+
+		TArray<uint8> Bytes;
+		TSharedPtr<const FLearningDecisionTreeFlatModel> FlatTree = Model->GetFlatTree();
+		FLearningDecisionTreeFlatView View;
+		if (FlatTree.IsValid())
+		{
+			View = FlatTree->GetView();
+		}
+		else if (Model->LDTRoot.Num() == 0 || !FLearningDecisionTreeFlatView::Build(Model->LDTRoot[0], Bytes) || !View.Initialize(Bytes.GetData(), Bytes.Num()))
+		{
+			return false;
+		}
+
+		if (!CompileView(View))
+		{
+			Nodes.Reset();
+			Children.Reset();
+			LeafCounts.Reset();
+			MostLikely.Reset();
+			return false;
+		}
+		return true;
+	}
+
+	bool IsCompiled() const { return Nodes.Num() > 0; }
+
+	/** Samples an action for Row weighted by the leaf's counts. Unset if Row reaches a state never seen in training. */
+	TOptional<FAction> Eval(const FRow& Row, FRandomStream& RandomStream) const
+	{
+		const int32 Leaf = FindLeaf(Row);
+		if (Leaf == INDEX_NONE)
+		{
+			return TOptional<FAction>();
+		}
+
+		const uint32* Counts = &LeafCounts[Leaf * NumActions];
+		const uint32 Total = Counts[NumActions - 1];
+		if (Total == 0)
+		{
+			return TOptional<FAction>();
+		}
+		const uint32 Pick = (uint32)RandomStream.RandRange(0, (int32)FMath::Min<uint32>(Total - 1, MAX_int32));
+		for (int32 Action = 0; Action < NumActions; Action++)
+		{
+			if (Pick < Counts[Action])
+			{
+				return (FAction)Action;
+			}
+		}
+		return (FAction)(NumActions - 1);
+	}
+
+	/** The most likely action for Row. Unset if Row reaches a state never seen in training. */
+	TOptional<FAction> MostLikelyAction(const FRow& Row) const
+	{
+		const int32 Leaf = FindLeaf(Row);
+		if (Leaf == INDEX_NONE || MostLikely[Leaf] == INDEX_NONE)
+		{
+			return TOptional<FAction>();
+		}
+		return (FAction)MostLikely[Leaf];
+	}
+
+private:
+	/** A decision tests Feature and continues at Children[First + State]; a leaf has Feature INDEX_NONE and owns leaf First. */
+	struct FNode
+	{
+		int32 Feature;
+		int32 First;
+	};
+
+	template <int32... Indices>
+	void AddColumns(std::integer_sequence<int32, Indices...>)
+	{
+		const FString Names[] = { GetColumnName<TColumn<Indices>>(Indices)... };
+		for (int32 Index = 0; Index < NumColumns; Index++)
+		{
+			// An enum used for several columns names only the first of them
+			FName Name(*Names[Index]);
+			if (Model->Table.ColumnNames.Contains(Name))
+			{
+				Name = FName(*FString::Printf(TEXT("%s%d"), *Names[Index], Index));
+			}
+			Model->AddColumn(Name);
+		}
+	}
+
+	/** The name of a UENUM, otherwise FeatureN or Action. */
+	template <typename EnumType>
+	static FString GetColumnName(int32 Index)
+	{
+		if constexpr (TIsUEnumClass<EnumType>::Value)
+		{
+			return StaticEnum<EnumType>()->GetName();
+		}
+		else
+		{
+			return Index == NumFeatures ? FString(TEXT("Action")) : FString::Printf(TEXT("Feature%d"), Index);
+		}
+	}
+
+	template <int32... Indices, typename... FeatureValues>
+	static void SetFeatures(FRow& Row, std::integer_sequence<int32, Indices...>, FeatureValues... Values)
+	{
+		(SetFeature<Indices>(Row, Values), ...);
+	}
+
+	int32 FindLeaf(const FRow& Row) const
+	{
+		if (Nodes.Num() == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		// A well-formed tree never visits more nodes than it has; a branch back to an ancestor in a damaged file would loop
+		const FNode* Node = &Nodes[0];
+		for (int32 Step = 0; Step < Nodes.Num(); Step++)
+		{
+			if (Node->Feature == INDEX_NONE)
+			{
+				return Node->First;
+			}
+
+			// FRow only holds enum values, but a cast can still produce one past the end
+			const int32 State = (int32)Row[Node->Feature];
+			if (State < 0 || State >= Cardinalities[Node->Feature])
+			{
+				return INDEX_NONE;
+			}
+			const int32 Child = Children[Node->First + State];
+			if (Child == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			Node = &Nodes[Child];
+		}
+		return INDEX_NONE;
+	}
+
+	bool CompileView(const FLearningDecisionTreeFlatView& View)
+	{
+		const FLearningDecisionTreeFlatHeader* Header = View.GetHeader();
+
+		// Compiled nodes keep the flat indices, with the root moved to 0
+		const uint32 NumNodes = Header->NumNodes;
+		TArray<int32> Remap;
+		Remap.SetNumUninitialized(NumNodes);
+		for (uint32 Index = 0; Index < NumNodes; Index++)
+		{
+			Remap[Index] = Index == Header->RootNode ? 0 : (Index < Header->RootNode ? Index + 1 : Index);
+		}
+
+		Nodes.SetNumUninitialized(NumNodes);
+		for (uint32 Index = 0; Index < NumNodes; Index++)
+		{
+			const FLearningDecisionTreeFlatNode& FlatNode = View.GetNode(Index);
+			FNode& Node = Nodes[Remap[Index]];
+			Node.Feature = FlatNode.FeatureIndex;
+
+			if (FlatNode.FeatureIndex == INDEX_NONE)
+			{
+				// Per-action cumulative counts, so sampling needs no search over leaf entries
+				if (FlatNode.First > Header->NumLeafEntries || FlatNode.Num > Header->NumLeafEntries - FlatNode.First)
+				{
+					return false;
+				}
+				Node.First = MostLikely.Num();
+				const int32 CountsStart = LeafCounts.AddZeroed(NumActions);
+				uint32 Previous = 0;
+				for (uint32 Entry = 0; Entry < FlatNode.Num; Entry++)
+				{
+					const FLearningDecisionTreeFlatLeafEntry& LeafEntry = View.GetLeafEntry(FlatNode.First + Entry);
+					if (LeafEntry.Action < 0 || LeafEntry.Action >= NumActions)
+					{
+						return false;
+					}
+					LeafCounts[CountsStart + LeafEntry.Action] += LeafEntry.CumulativeCount - Previous;
+					Previous = LeafEntry.CumulativeCount;
+				}
+				for (int32 Action = 1; Action < NumActions; Action++)
+				{
+					LeafCounts[CountsStart + Action] += LeafCounts[CountsStart + Action - 1];
+				}
+				MostLikely.Add(FlatNode.MostLikelyAction >= 0 && FlatNode.MostLikelyAction < NumActions ? FlatNode.MostLikelyAction : INDEX_NONE);
+				continue;
+			}
+
+			if (FlatNode.FeatureIndex < 0 || FlatNode.FeatureIndex >= NumFeatures
+				|| FlatNode.First > Header->NumBranches || FlatNode.Num > Header->NumBranches - FlatNode.First)
+			{
+				return false;
+			}
+
+			// One slot per state of the feature; states never seen in training stay INDEX_NONE
+			Node.First = Children.AddUninitialized(Cardinalities[FlatNode.FeatureIndex]);
+			for (int32 State = 0; State < Cardinalities[FlatNode.FeatureIndex]; State++)
+			{
+				Children[Node.First + State] = INDEX_NONE;
+			}
+			for (uint32 Branch = 0; Branch < FlatNode.Num; Branch++)
+			{
+				const FLearningDecisionTreeFlatBranch& FlatBranch = View.GetBranch(FlatNode.First + Branch);
+				if (FlatBranch.Child >= NumNodes)
+				{
+					return false;
+				}
+				if (FlatBranch.State >= 0 && FlatBranch.State < Cardinalities[FlatNode.FeatureIndex])
+				{
+					Children[Node.First + FlatBranch.State] = Remap[FlatBranch.Child];
+				}
+			}
+		}
+		return true;
+	}
+
+	TStrongObjectPtr<ULearningDecisionTree> Model;
+
+	TArray<FNode> Nodes;
+	TArray<int32> Children;
+	/** NumActions cumulative counts per leaf. */
+	TArray<uint32> LeafCounts;
+	TArray<int32> MostLikely;
+
+	TArray<int32> ScratchRow;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "LearningDecisionTreeCore/Table.h"
+
+namespace LearningDecisionTreeCore
+{
+	/** What BuildFlatTree() produced. */
+	struct FBuildStats
+	{
+		int32_t NumNodes = 0;
+		int32_t NumLeaves = 0;
+		/** Decision levels on the longest path; 0 if the root is a leaf. */
+		int32_t MaxDepth = 0;
+		/** Rows added into split histograms, once per candidate feature: the counting work of the build. */
+		int64_t HistogramRows = 0;
+	};
+
+	/** How BuildFlatTree() grows the tree. Both modes pick the same splits and write the same bytes. */
+	enum class EBuildMode : uint8_t
+	{
+		/** Node by node, rescanning each node's rows for every candidate feature. */
+		DepthFirst,
+		/**
+		 * One depth at a time: a single pass per feature over the rows of every node at that depth fills all
+		 * their state x action histograms, and each node's largest child takes its parent's histograms minus its
+		 * siblings' instead of being counted. Faster on tables with many rows, uses more memory per depth.
+		 */
+		LevelWise,
+	};
+
+	/**
+	 * Trains an ID3 decision tree on Table and writes it as a flat tree blob (see FlatFormat.h).
+	 *
+	 * Follows the engine's node builder exactly: a node splits on the feature with the highest information gain
+	 * (the later column on ties) while its actions are mixed and features are left; branches and leaf actions are
+	 * in order of first appearance in the table. The blob is laid out depth-first like
+	 * FLearningDecisionTreeFlatView::Build(), so both sides write the same bytes for the same table.
+	 *
+	 * Both modes add up a node's entropy and gain terms in the same order and precision as the engine's InfoGain(),
+	 * states and actions in order of first appearance in the node's rows, so they pick the same splits.
+	 *
+	 * Returns false, leaving OutBytes empty, if the table has no columns or is not consistent.
+	 */
+	bool BuildFlatTree(const FTable& Table, std::vector<uint8_t>& OutBytes, FBuildStats* OutStats = nullptr,
+		EBuildMode Mode = EBuildMode::DepthFirst);
+}
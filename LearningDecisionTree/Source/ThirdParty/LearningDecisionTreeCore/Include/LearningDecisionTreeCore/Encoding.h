@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/** Byte-level encoding helpers of the file formats, also used by the engine module's table journal. */
+namespace LearningDecisionTreeCore
+{
+	namespace Encoding
+	{
+		/** Longest varint EncodeVarUInt() writes. */
+		static constexpr size_t MaxVarUIntSize = 5;
+
+		/** Writes Value as a little-endian base-128 varint to Out, which has room for MaxVarUIntSize bytes. Returns the bytes written. */
+		inline size_t EncodeVarUInt(uint32_t Value, uint8_t* Out)
+		{
+			size_t Size = 0;
+			while (Value >= 0x80)
+			{
+				Out[Size++] = (uint8_t)(Value | 0x80);
+				Value >>= 7;
+			}
+			Out[Size++] = (uint8_t)Value;
+			return Size;
+		}
+
+		/** Appends Value as a little-endian base-128 varint. */
+		inline void WriteVarUInt(std::vector<uint8_t>& Out, uint32_t Value)
+		{
+			uint8_t Bytes[MaxVarUIntSize];
+			Out.insert(Out.end(), Bytes, Bytes + EncodeVarUInt(Value, Bytes));
+		}
+
+		/** Reads a varint at Offset, advancing it. Returns false if the data ends or the varint is malformed. */
+		inline bool ReadVarUInt(const uint8_t* In, size_t Size, size_t& Offset, uint32_t& OutValue)
+		{
+			OutValue = 0;
+			for (int32_t Shift = 0; Shift < 35; Shift += 7)
+			{
+				if (Offset >= Size)
+				{
+					return false;
+				}
+				uint8_t Byte = In[Offset++];
+				OutValue |= (uint32_t)(Byte & 0x7F) << Shift;
+				if ((Byte & 0x80) == 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		inline bool ReadVarUInt(const std::vector<uint8_t>& In, size_t& Offset, uint32_t& OutValue)
+		{
+			return ReadVarUInt(In.data(), In.size(), Offset, OutValue);
+		}
+
+		/** Maps signed values to unsigned so small negative numbers stay small as varints. */
+		inline uint32_t ZigZagEncode(int32_t Value)
+		{
+			return ((uint32_t)Value << 1) ^ (uint32_t)(Value >> 31);
+		}
+
+		inline int32_t ZigZagDecode(uint32_t Value)
+		{
+			return (int32_t)((Value >> 1) ^ (0u - (Value & 1)));
+		}
+
+		/** Appends fixed-size little-endian values, as an engine FArchive writes them. */
+		class FWriter
+		{
+		public:
+			explicit FWriter(std::vector<uint8_t>& InOut) : Out(InOut) {}
+
+			template <typename T>
+			void Write(T Value)
+			{
+				uint8_t Bytes[sizeof(T)];
+				std::memcpy(Bytes, &Value, sizeof(T));
+				Out.insert(Out.end(), Bytes, Bytes + sizeof(T));
+			}
+
+			void WriteBytes(const uint8_t* Data, size_t Size)
+			{
+				Out.insert(Out.end(), Data, Data + Size);
+			}
+
+		private:
+			std::vector<uint8_t>& Out;
+		};
+
+		/** Reads fixed-size little-endian values. Reading past the end sets the error flag and yields zeros. */
+		class FReader
+		{
+		public:
+			FReader(const uint8_t* InData, size_t InSize) : Data(InData), Size(InSize) {}
+
+			template <typename T>
+			T Read()
+			{
+				T Value = T();
+				if (!bError && Size - Offset >= sizeof(T))
+				{
+					std::memcpy(&Value, Data + Offset, sizeof(T));
+					Offset += sizeof(T);
+				}
+				else
+				{
+					bError = true;
+				}
+				return Value;
+			}
+
+			const uint8_t* ReadBytes(size_t Num)
+			{
+				if (bError || Size - Offset < Num)
+				{
+					bError = true;
+					return nullptr;
+				}
+				const uint8_t* Bytes = Data + Offset;
+				Offset += Num;
+				return Bytes;
+			}
+
+			size_t GetRemaining() const { return Size - Offset; }
+			bool IsError() const { return bError; }
+
+		private:
+			const uint8_t* Data;
+			size_t Size;
+			size_t Offset = 0;
+			bool bError = false;
+		};
+	}
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "LearningDecisionTreeCore/FlatFormat.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace LearningDecisionTreeCore
+{
+	/**
+	 * Read-only view over a flat tree blob. Does not own the memory.
+	 * Evaluation is const and allocation free; every index read from the blob is bounds checked,
+	 * so a corrupt file can make predictions wrong but never reads outside the blob.
+	 */
+	class FFlatView
+	{
+	public:
+		/** Points the view at a blob. Returns false (and stays empty) if the header does not describe Size bytes. */
+		bool Initialize(const uint8_t* Data, size_t Size);
+
+		bool IsValid() const { return Header != nullptr; }
+		const FFlatHeader* GetHeader() const { return Header; }
+
+		/** Index of the leaf reached by Row (one state per feature), or -1 if the row leaves the tree. */
+		int32_t FindLeaf(const int32_t* Row, size_t NumStates) const;
+
+		/**
+		 * FindLeaf() that calls OnDecision(Node, Branch) at every decision node it tests, with the index of the branch
+		 * taken, or NoBranch if the row's state has no branch there.
+		 */
+		template <typename FOnDecision>
+		int32_t FindLeaf(const int32_t* Row, size_t NumStates, FOnDecision&& OnDecision) const;
+
+		static constexpr uint32_t NoBranch = ~0u;
+
+		/** The leaf's most frequent training action, or -1. */
+		int32_t MostLikelyAction(int32_t LeafIndex) const;
+
+		/**
+		 * Draws an action from the leaf, weighted by the training counts, or returns -1.
+		 * @param Random A uniformly distributed 32-bit value.
+		 */
+		int32_t SampleAction(int32_t LeafIndex, uint32_t Random) const;
+
+		/** SampleAction() that picks with Draw(Total), which returns a uniformly distributed value in [0, Total). */
+		template <typename FDraw>
+		int32_t SampleActionWith(int32_t LeafIndex, FDraw&& Draw) const;
+
+		/** MostLikelyAction() of the leaf Row reaches. */
+		int32_t Eval(const int32_t* Row, size_t NumStates) const { return MostLikelyAction(FindLeaf(Row, NumStates)); }
+		int32_t Eval(const std::vector<int32_t>& Row) const { return Eval(Row.data(), Row.size()); }
+
+		uint32_t GetNumNodes() const { return Header ? Header->NumNodes : 0; }
+		uint32_t GetNumBranches() const { return Header ? Header->NumBranches : 0; }
+		uint32_t GetNumLeafEntries() const { return Header ? Header->NumLeafEntries : 0; }
+
+		const FFlatNode& GetNode(uint32_t Index) const { return Nodes[Index]; }
+		const FFlatBranch& GetBranch(uint32_t Index) const { return Branches[Index]; }
+		const FFlatLeafEntry& GetLeafEntry(uint32_t Index) const { return LeafEntries[Index]; }
+
+		/** Size of the blob the view covers, in bytes. */
+		size_t GetSize() const;
+
+	private:
+		const FFlatHeader* Header = nullptr;
+		const FFlatNode* Nodes = nullptr;
+		const FFlatBranch* Branches = nullptr;
+		const FFlatLeafEntry* LeafEntries = nullptr;
+	};
+
+	/**
+	 * Writes a flat tree blob: the header, then the three sections as given, with RootNode as the root.
+	 * Every builder of the format writes through this, so the header is filled in one place.
+	 */
+	void WriteFlatTree(const FFlatNode* Nodes, size_t NumNodes, const FFlatBranch* Branches, size_t NumBranches,
+		const FFlatLeafEntry* LeafEntries, size_t NumLeafEntries, uint32_t NumFeatures, uint32_t RootNode, std::vector<uint8_t>& OutBytes);
+
+	/** A flat tree that owns its blob. */
+	class FFlatModel
+	{
+	public:
+		FFlatModel() = default;
+
+		/** The view points into Bytes, so models are moved, never copied. */
+		FFlatModel(FFlatModel&& Other) noexcept;
+		FFlatModel& operator=(FFlatModel&& Other) noexcept;
+		FFlatModel(const FFlatModel&) = delete;
+		FFlatModel& operator=(const FFlatModel&) = delete;
+
+		/** Takes the blob over. Returns false, leaving the model empty, if it is not a valid flat tree. */
+		bool SetBytes(std::vector<uint8_t>&& InBytes);
+
+		/** Reads a .ftree file. Returns false if it is missing or invalid. */
+		bool LoadFile(const std::string& Path);
+
+		/** Writes the blob as a .ftree file. */
+		bool SaveFile(const std::string& Path) const;
+
+		const FFlatView& GetView() const { return View; }
+		const std::vector<uint8_t>& GetBytes() const { return Bytes; }
+
+	private:
+		std::vector<uint8_t> Bytes;
+		FFlatView View;
+	};
+
+	template <typename FOnDecision>
+	int32_t FFlatView::FindLeaf(const int32_t* Row, size_t NumStates, FOnDecision&& OnDecision) const
+	{
+		if (!Header || Header->NumNodes == 0)
+		{
+			return -1;
+		}
+
+		uint32_t NodeIndex = Header->RootNode;
+
+		// A well-formed tree never visits more nodes than it has; this also stops cycles in corrupt files
+		for (uint32_t Step = 0; Step < Header->NumNodes; Step++)
+		{
+			const FFlatNode& Node = Nodes[NodeIndex];
+			if (Node.FeatureIndex == FFlatNode::LeafFeature)
+			{
+				return (int32_t)NodeIndex;
+			}
+
+			if (Node.FeatureIndex < 0 || (size_t)Node.FeatureIndex >= NumStates
+				|| Node.First > Header->NumBranches || Node.Num > Header->NumBranches - Node.First)
+			{
+				return -1;
+			}
+
+			const int32_t State = Row[Node.FeatureIndex];
+			const FFlatBranch* Branch = Branches + Node.First;
+			const FFlatBranch* BranchEnd = Branch + Node.Num;
+			while (Branch != BranchEnd && Branch->State != State)
+			{
+				++Branch;
+			}
+
+			if (Branch == BranchEnd || Branch->Child >= Header->NumNodes)
+			{
+				OnDecision(Node, NoBranch);
+				return -1;
+			}
+			OnDecision(Node, (uint32_t)(Branch - Branches));
+			NodeIndex = Branch->Child;
+		}
+
+		return -1;
+	}
+
+	template <typename FDraw>
+	int32_t FFlatView::SampleActionWith(int32_t LeafIndex, FDraw&& Draw) const
+	{
+		if (!Header || LeafIndex < 0 || (uint32_t)LeafIndex >= Header->NumNodes)
+		{
+			return -1;
+		}
+
+		const FFlatNode& Leaf = Nodes[LeafIndex];
+		if (Leaf.FeatureIndex != FFlatNode::LeafFeature || Leaf.Num == 0
+			|| Leaf.First > Header->NumLeafEntries || Leaf.Num > Header->NumLeafEntries - Leaf.First)
+		{
+			return -1;
+		}
+
+		const FFlatLeafEntry* Entries = LeafEntries + Leaf.First;
+		const uint32_t Total = Entries[Leaf.Num - 1].CumulativeCount;
+		const uint32_t Pick = Total > 0 ? (uint32_t)Draw(Total) : 0;
+
+		for (uint32_t i = 0; i + 1 < Leaf.Num; i++)
+		{
+			if (Pick < Entries[i].CumulativeCount)
+			{
+				return Entries[i].Action;
+			}
+		}
+		return Entries[Leaf.Num - 1].Action;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The flat decision tree format is little-endian and is read in place."
+#endif
+
+/**
+ * Flat, relocatable decision tree format (.ftree), shared by the core library and the Unreal module.
+ * The whole model is one contiguous little-endian blob with indices instead of pointers,
+ * so it can be memory-mapped and evaluated in place.
+ *
+ * Layout:
+ *   FFlatHeader
+ *   FFlatNode      Nodes[NumNodes]
+ *   FFlatBranch    Branches[NumBranches]
+ *   FFlatLeafEntry LeafEntries[NumLeafEntries]
+ *
+ * Only plain structs live here, so engine headers can include it without pulling in the standard library.
+ */
+namespace LearningDecisionTreeCore
+{
+	struct FFlatHeader
+	{
+		static constexpr uint32_t ExpectedMagic = 0x4654444C; // "LDTF"
+		static constexpr uint32_t CurrentVersion = 1;
+
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t NumNodes;
+		uint32_t NumBranches;
+		uint32_t NumLeafEntries;
+		/** Length of the feature rows the model expects (highest FeatureIndex + 1). */
+		uint32_t NumFeatures;
+		uint32_t RootNode;
+		uint32_t Reserved;
+	};
+
+	/**
+	 * A node of the flat tree.
+	 * Decision nodes own Branches[First, First + Num); leaves (FeatureIndex == LeafFeature)
+	 * own LeafEntries[First, First + Num). A leaf with no entries predicts nothing.
+	 */
+	struct FFlatNode
+	{
+		static constexpr int32_t LeafFeature = -1;
+
+		int32_t FeatureIndex;
+		uint32_t First;
+		uint32_t Num;
+		/** Leaves only: the action with the highest count, or -1. */
+		int32_t MostLikelyAction;
+	};
+
+	struct FFlatBranch
+	{
+		int32_t State;
+		uint32_t Child;
+	};
+
+	struct FFlatLeafEntry
+	{
+		int32_t Action;
+		/** Sum of the counts of this entry and all previous entries of the same leaf. */
+		uint32_t CumulativeCount;
+	};
+
+	static_assert(sizeof(FFlatHeader) == 32, "Flat tree header layout changed.");
+	static_assert(sizeof(FFlatNode) == 16, "Flat tree node layout changed.");
+	static_assert(sizeof(FFlatBranch) == 8, "Flat tree branch layout changed.");
+	static_assert(sizeof(FFlatLeafEntry) == 8, "Flat tree leaf layout changed.");
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LearningDecisionTreeCore
+{
+	/**
+	 * Training table: one column per feature plus the action column, which is always the LAST column.
+	 * Identical rows are stored once, with their number of occurrences in DuplicateCounts.
+	 * Holds the same data as the engine's FLearningDecisionTreeTable, with columns in ColumnNames order.
+	 */
+	struct FTable
+	{
+		std::vector<std::string> ColumnNames;
+
+		/** One array of states per column, parallel to ColumnNames. */
+		std::vector<std::vector<int32_t>> Columns;
+
+		/** Occurrences of each physical row. */
+		std::vector<int32_t> DuplicateCounts;
+
+		/** Number of logical rows (the sum of DuplicateCounts). */
+		int32_t TotalRows = 0;
+
+		/** Number of physical rows. */
+		int32_t GetNumRows() const { return (int32_t)DuplicateCounts.size(); }
+
+		int32_t GetNumColumns() const { return (int32_t)ColumnNames.size(); }
+
+		/** Index of the column called Name, or -1. */
+		int32_t FindColumn(const std::string& Name) const;
+
+		/** Adds an empty column. Only allowed while the table has no rows. Returns false if it exists already. */
+		bool AddColumn(const std::string& Name);
+
+		/**
+		 * Adds a row with one state per column. A row equal to an existing one increments that row's count.
+		 * Returns false if the row length does not match the column count.
+		 */
+		bool AddRow(const int32_t* Row, size_t NumStates, int32_t Count = 1);
+		bool AddRow(const std::vector<int32_t>& Row, int32_t Count = 1) { return AddRow(Row.data(), Row.size(), Count); }
+
+		/** True if every column has one state per physical row and no count is negative. TotalRows is not checked. */
+		bool IsConsistent() const;
+
+		/** Heap memory used by the table, in bytes. */
+		size_t GetAllocatedSize() const;
+
+		void Reset();
+
+	private:
+		uint64_t HashRow(const int32_t* Row) const;
+		bool RowEquals(int32_t PhysicalRow, const int32_t* Row) const;
+
+		/** Rows by hash, for duplicate detection in AddRow(). Rebuilt when rows were added without AddRow(). */
+		std::unordered_multimap<uint64_t, int32_t> RowIndex;
+		int32_t NumIndexedRows = 0;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "LearningDecisionTreeCore/Table.h"
+
+namespace LearningDecisionTreeCore
+{
+	/** Block compression of a table file. Values match ELearningDecisionTreeCompression. */
+	enum class ECompression : uint8_t
+	{
+		None,
+		/** Only written and read when the library is built with zlib (LEARNINGDECISIONTREECORE_WITH_ZLIB). */
+		Zlib,
+		/** Only written and read through a codec that provides it, such as the engine module's. */
+		Oodle
+	};
+
+	/**
+	 * Compresses and decompresses table file blocks. Without one the library handles zlib itself when built with it;
+	 * the engine module passes one backed by FCompression, which adds Oodle.
+	 */
+	class ICompressionCodec
+	{
+	public:
+		virtual ~ICompressionCodec() = default;
+
+		/** Replaces Out with In compressed. Returns false if Compression is not supported or fails. */
+		virtual bool Compress(ECompression Compression, const uint8_t* In, size_t InSize, std::vector<uint8_t>& Out) const = 0;
+
+		/** Decompresses In into exactly OutSize bytes at Out. */
+		virtual bool Uncompress(ECompression Compression, const uint8_t* In, size_t InSize, uint8_t* Out, size_t OutSize) const = 0;
+	};
+
+	/**
+	 * Binary table file format (.dat), the same files the engine's ULearningDecisionTree::SaveTable writes.
+	 *
+	 * Layout (little-endian):
+	 *   uint32 Magic, uint16 Version, uint8 Compression, uint8 Reserved
+	 *   Schema block:          int32 TotalRows, int32 physical row count, int32 column count,
+	 *                          column names as engine FStrings (int32 length with terminator, negative for UTF-16)
+	 *   DuplicateCounts block: one varint per physical row
+	 *   One block per column:  sorted dictionary of distinct states (delta varints),
+	 *                          followed by the rows' dictionary codes bit-packed at the minimal width
+	 *   uint32 CRC32 of all uncompressed block payloads
+	 *
+	 * Every block is stored as: uint8 bCompressed, int32 UncompressedSize, int32 StoredSize, payload.
+	 * Files written before this format existed (no magic) are still read.
+	 */
+	struct FTableFile
+	{
+		static constexpr uint32_t Magic = 0x4254444C; // "LDTB"
+		static constexpr uint16_t Version = 1;
+	};
+
+	/**
+	 * Appends Table to OutBytes in the current file format.
+	 * Blocks that Codec cannot compress, or that do not get smaller, are stored raw.
+	 * @param OutChecksum If set, receives the checksum stored at the end of the file.
+	 * @param Codec Compresses the blocks; null uses the library's own zlib support.
+	 */
+	bool WriteTable(const FTable& Table, std::vector<uint8_t>& OutBytes, ECompression Compression = ECompression::None, uint32_t* OutChecksum = nullptr,
+		const ICompressionCodec* Codec = nullptr);
+
+	/**
+	 * Reads a table file, either format. OutTable is only modified if the file is complete, consistent
+	 * and its checksum matches. OutChecksum receives the stored checksum, 0 for legacy files.
+	 * Compressed blocks are decompressed by Codec, or by the library's own zlib support if it is null.
+	 */
+	bool ReadTable(const uint8_t* Data, size_t Size, FTable& OutTable, uint32_t* OutChecksum = nullptr, const ICompressionCodec* Codec = nullptr);
+
+	bool SaveTableFile(const std::string& Path, const FTable& Table, ECompression Compression = ECompression::None);
+	bool LoadTableFile(const std::string& Path, FTable& OutTable);
+
+	/** The CRC-32 used by the table file checksum (zlib's, as FCrc::MemCrc32), continued from Crc. */
+	uint32_t MemCrc32(const void* Data, size_t Size, uint32_t Crc = 0);
+}
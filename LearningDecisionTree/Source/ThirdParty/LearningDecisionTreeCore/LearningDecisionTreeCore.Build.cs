@@ -0,0 +1,15 @@
+using System.IO;
+using UnrealBuildTool;
+
+// Engine-independent core library (table, ID3 builder, flat evaluator, file formats).
+// Header-only from the engine's point of view: the LearningDecisionTree module compiles its sources
+// (see LearningDecisionTreeCoreSources.cpp), and CMakeLists.txt builds them as a standalone library.
+public class LearningDecisionTreeCore : ModuleRules
+{
+	public LearningDecisionTreeCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		Type = ModuleType.External;
+
+		PublicSystemIncludePaths.Add(Path.Combine(ModuleDirectory, "Include"));
+	}
+}
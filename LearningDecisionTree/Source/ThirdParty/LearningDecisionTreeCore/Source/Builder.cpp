@@ -0,0 +1,673 @@
+#include "LearningDecisionTreeCore/Builder.h"
+#include "LearningDecisionTreeCore/Flat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace LearningDecisionTreeCore
+{
+	namespace BuilderPrivate
+	{
+		/** Same as FMath::Log2, so entropies round like the engine builder's. */
+		static float Log2(float Value)
+		{
+			return std::log(Value) * 1.44269504088896f;
+		}
+
+		/** Entropy of a distribution given as counts over Total, accumulated like the engine's ArrayEntropy. */
+		static float CountsEntropy(const int64_t* Counts, size_t NumCounts, int64_t Total)
+		{
+			double Entropy = 0;
+			for (size_t i = 0; i < NumCounts; i++)
+			{
+				float Probability = (float)Counts[i] / (float)Total;
+				if (Probability != 0 && Total != 0)
+				{
+					Entropy -= Probability * Log2(Probability);
+				}
+			}
+			return (float)Entropy;
+		}
+
+		/** A column with its states replaced by dense codes, so per-node histograms are arrays. */
+		struct FEncodedColumn
+		{
+			std::vector<uint32_t> Codes;
+			std::vector<int32_t> States;
+		};
+
+		/** A node of the level-wise build, laid out depth-first once the whole tree is known. */
+		struct FLevelNode
+		{
+			int32_t Parent = -1;
+			/** Code of this node's state in its parent's split feature. */
+			uint32_t StateCode = 0;
+			std::vector<int32_t> Features;
+
+			/** Actions in order of first appearance, with their counts. */
+			std::vector<int32_t> ActionCodes;
+			std::vector<int64_t> ActionCounts;
+			int64_t Total = 0;
+			int32_t NumRows = 0;
+			float ActionEntropy = 0;
+
+			/** Split feature, or -1 for a leaf. Children are in order of first appearance. */
+			int32_t Feature = -1;
+			std::vector<int32_t> Children;
+			/** Child of each state code of Feature while the rows are being split, -1 if not seen yet. */
+			std::vector<int32_t> ChildByCode;
+
+			/**
+			 * State x action histogram of every candidate feature, kept until the children have been split
+			 * because the largest child is derived from it. HistogramOffsets has -1 for used features.
+			 */
+			std::vector<int64_t> Histograms;
+			std::vector<int64_t> HistogramOffsets;
+			/** The histograms are the parent's minus the siblings' rather than counted. */
+			bool bDerived = false;
+
+			bool IsSplit() const { return ActionEntropy != 0 && !Features.empty(); }
+		};
+
+		/** A node's rows in the level-wise build, Rows[Begin, End), to be added to (or subtracted from) its histograms. */
+		struct FSegment
+		{
+			int32_t Node = -1;
+			size_t Begin = 0;
+			size_t End = 0;
+			bool bSubtract = false;
+		};
+
+		class FBuilder
+		{
+		public:
+			std::vector<FFlatNode> Nodes;
+			std::vector<FFlatBranch> Branches;
+			std::vector<FFlatLeafEntry> LeafEntries;
+			int32_t NumFeatures = 0;
+			FBuildStats Stats;
+
+			explicit FBuilder(const FTable& Table)
+				: DuplicateCounts(Table.DuplicateCounts)
+			{
+				size_t MaxStates = 0;
+				Columns.resize(Table.Columns.size());
+				for (size_t Column = 0; Column < Table.Columns.size(); Column++)
+				{
+					std::unordered_map<int32_t, uint32_t> CodeByState;
+					FEncodedColumn& Encoded = Columns[Column];
+					Encoded.Codes.reserve(Table.Columns[Column].size());
+					for (int32_t State : Table.Columns[Column])
+					{
+						auto Inserted = CodeByState.emplace(State, (uint32_t)Encoded.States.size());
+						if (Inserted.second)
+						{
+							Encoded.States.push_back(State);
+						}
+						Encoded.Codes.push_back(Inserted.first->second);
+					}
+					MaxStates = std::max(MaxStates, Encoded.States.size());
+				}
+				Slots.assign(MaxStates, -1);
+			}
+
+			/** Builds the subtree of Rows, whose remaining features are Features, depth-first. Returns its node index. */
+			uint32_t AddNode(std::vector<int32_t> Rows, const std::vector<int32_t>& Features, int32_t Depth)
+			{
+				const uint32_t NodeIndex = (uint32_t)Nodes.size();
+				Nodes.push_back({ FFlatNode::LeafFeature, 0, 0, -1 });
+				Stats.NumNodes++;
+				Stats.MaxDepth = std::max(Stats.MaxDepth, Depth);
+
+				// Actions in order of first appearance, and the slot of each row's action
+				const FEncodedColumn& Actions = Columns.back();
+				std::vector<int32_t> ActionCodes;
+				std::vector<int64_t> ActionCounts;
+				std::vector<int32_t> RowActions(Rows.size());
+				int64_t Total = 0;
+				for (size_t i = 0; i < Rows.size(); i++)
+				{
+					RowActions[i] = Slot(Actions.Codes[Rows[i]], ActionCodes);
+					if ((size_t)RowActions[i] == ActionCounts.size())
+					{
+						ActionCounts.push_back(0);
+					}
+					ActionCounts[RowActions[i]] += DuplicateCounts[Rows[i]];
+					Total += DuplicateCounts[Rows[i]];
+				}
+				ReleaseSlots(ActionCodes);
+
+				const float ActionEntropy = CountsEntropy(ActionCounts.data(), ActionCounts.size(), Total);
+				if (ActionEntropy == 0 || Features.empty())
+				{
+					AddLeaf(NodeIndex, Actions, ActionCodes, ActionCounts);
+					return NodeIndex;
+				}
+
+				// Split on the best feature, the later one on ties, the first one if none gains anything
+				float BestGain = 0;
+				int32_t BestFeature = -1;
+				for (size_t i = 0; i < Features.size(); i++)
+				{
+					float Gain = InfoGain(Columns[Features[i]], Rows, RowActions, ActionCounts.size(), ActionEntropy, Total);
+					if (BestGain <= Gain)
+					{
+						BestGain = Gain;
+						BestFeature = (int32_t)i;
+					}
+				}
+				BestFeature = std::max(BestFeature, 0);
+
+				const FEncodedColumn& Split = Columns[Features[BestFeature]];
+				std::vector<int32_t> StateCodes;
+				std::vector<std::vector<int32_t>> ChildRows;
+				for (int32_t Row : Rows)
+				{
+					int32_t Child = Slot(Split.Codes[Row], StateCodes);
+					if ((size_t)Child == ChildRows.size())
+					{
+						ChildRows.emplace_back();
+					}
+					ChildRows[Child].push_back(Row);
+				}
+				ReleaseSlots(StateCodes);
+				Rows = std::vector<int32_t>();
+
+				std::vector<int32_t> ChildFeatures = Features;
+				ChildFeatures.erase(ChildFeatures.begin() + BestFeature);
+
+				const uint32_t First = (uint32_t)Branches.size();
+				Branches.resize(Branches.size() + ChildRows.size());
+				Nodes[NodeIndex] = { Features[BestFeature], First, (uint32_t)ChildRows.size(), -1 };
+				NumFeatures = std::max(NumFeatures, Features[BestFeature] + 1);
+
+				for (size_t i = 0; i < ChildRows.size(); i++)
+				{
+					// Children grow the arrays, so never hold references across this call
+					uint32_t Child = AddNode(std::move(ChildRows[i]), ChildFeatures, Depth + 1);
+					Branches[First + i] = { Split.States[StateCodes[i]], Child };
+				}
+				return NodeIndex;
+			}
+
+			/** Builds the whole tree one depth at a time from per-depth histograms, then lays it out. Returns the root. */
+			uint32_t BuildLevelWise(const std::vector<int32_t>& Features)
+			{
+				const size_t NumActions = Columns.back().States.size();
+				const uint32_t* ActionCodes = Columns.back().Codes.data();
+
+				// The rows of every node still being split, grouped by node and in table order within each node,
+				// so the counting passes fill one histogram at a time
+				std::vector<int32_t> Rows(DuplicateCounts.size());
+				for (size_t i = 0; i < Rows.size(); i++)
+				{
+					Rows[i] = (int32_t)i;
+				}
+				std::vector<int32_t> RowNodes(Rows.size(), 0);
+				std::vector<FSegment> Segments(1, { 0, 0, Rows.size() });
+
+				Tree.assign(1, FLevelNode());
+				Tree[0].Features = Features;
+				CountActions(Rows, RowNodes, 0);
+
+				std::vector<int32_t> Parents;
+				std::vector<int32_t> Splitting;
+				std::vector<FSegment> Counted;
+				while (!Segments.empty())
+				{
+					// Derive the largest splitting child of each parent when its leaf siblings have fewer rows
+					// than it: those are the rows that still need counting, as subtractions.
+					std::vector<int32_t> DerivedChild(Tree.size(), -1);
+					for (int32_t Parent : Parents)
+					{
+						int32_t Largest = -1;
+						int32_t LeafRows = 0;
+						for (int32_t Child : Tree[Parent].Children)
+						{
+							if (!Tree[Child].IsSplit())
+							{
+								LeafRows += Tree[Child].NumRows;
+							}
+							else if (Largest == -1 || Tree[Child].NumRows > Tree[Largest].NumRows)
+							{
+								Largest = Child;
+							}
+						}
+						if (Largest != -1 && Tree[Largest].NumRows > LeafRows)
+						{
+							Tree[Largest].bDerived = true;
+							DerivedChild[Parent] = Largest;
+						}
+					}
+
+					// The row ranges to count, each into the histograms of its own node or, negated, of its derived sibling
+					Splitting.clear();
+					Counted.clear();
+					for (const FSegment& Segment : Segments)
+					{
+						FLevelNode& Node = Tree[Segment.Node];
+						if (Node.IsSplit())
+						{
+							Splitting.push_back(Segment.Node);
+							AllocateHistograms(Node);
+							if (!Node.bDerived)
+							{
+								Counted.push_back(Segment);
+							}
+						}
+						else if (Node.Parent != -1 && DerivedChild[Node.Parent] != -1)
+						{
+							Counted.push_back({ DerivedChild[Node.Parent], Segment.Begin, Segment.End, true });
+						}
+					}
+
+					// One pass per feature fills the histograms of every node at this depth
+					for (size_t Column = 0; Column + 1 < Columns.size(); Column++)
+					{
+						const uint32_t* Codes = Columns[Column].Codes.data();
+						for (const FSegment& Segment : Counted)
+						{
+							FLevelNode& Node = Tree[Segment.Node];
+							if (Node.HistogramOffsets[Column] == -1)
+							{
+								continue;
+							}
+							int64_t* Base = Node.Histograms.data() + Node.HistogramOffsets[Column];
+							for (size_t i = Segment.Begin; i < Segment.End; i++)
+							{
+								const int32_t Row = Rows[i];
+								const int64_t Count = DuplicateCounts[Row];
+								Base[Codes[Row] * NumActions + ActionCodes[Row]] += Segment.bSubtract ? -Count : Count;
+							}
+							Stats.HistogramRows += (int64_t)(Segment.End - Segment.Begin);
+						}
+					}
+
+					for (int32_t Parent : Parents)
+					{
+						if (DerivedChild[Parent] != -1)
+						{
+							DeriveHistograms(Tree[DerivedChild[Parent]], Tree[Parent]);
+						}
+						FreeHistograms(Tree[Parent]);
+					}
+
+					for (const FSegment& Segment : Segments)
+					{
+						if (Tree[Segment.Node].IsSplit())
+						{
+							ChooseFeature(Tree[Segment.Node], Rows, Segment);
+						}
+					}
+
+					// Create the children in order of first appearance, then regroup the rows by child
+					const int32_t FirstChild = (int32_t)Tree.size();
+					std::vector<size_t> ChildStarts(1, 0);
+					for (const FSegment& Segment : Segments)
+					{
+						const int32_t Node = Segment.Node;
+						if (Tree[Node].Feature == -1)
+						{
+							continue;
+						}
+						const uint32_t* Codes = Columns[Tree[Node].Feature].Codes.data();
+						for (size_t i = Segment.Begin; i < Segment.End; i++)
+						{
+							int32_t Child = Tree[Node].ChildByCode[Codes[Rows[i]]];
+							if (Child == -1)
+							{
+								Child = (int32_t)Tree.size();
+								Tree[Node].ChildByCode[Codes[Rows[i]]] = Child;
+								Tree[Node].Children.push_back(Child);
+								ChildStarts.push_back(0);
+
+								FLevelNode NewNode;
+								NewNode.Parent = Node;
+								NewNode.StateCode = Codes[Rows[i]];
+								NewNode.Features = Tree[Node].Features;
+								NewNode.Features.erase(std::find(NewNode.Features.begin(), NewNode.Features.end(), Tree[Node].Feature));
+								Tree.push_back(std::move(NewNode));
+							}
+							RowNodes[Rows[i]] = Child;
+							ChildStarts[Child - FirstChild + 1]++;
+						}
+						Tree[Node].ChildByCode = std::vector<int32_t>();
+					}
+					for (size_t i = 1; i < ChildStarts.size(); i++)
+					{
+						ChildStarts[i] += ChildStarts[i - 1];
+					}
+
+					std::vector<int32_t> ChildRows(ChildStarts.back());
+					Segments.clear();
+					for (size_t Local = 0; Local + 1 < ChildStarts.size(); Local++)
+					{
+						Segments.push_back({ FirstChild + (int32_t)Local, ChildStarts[Local], ChildStarts[Local + 1] });
+					}
+					for (int32_t Row : Rows)
+					{
+						if (RowNodes[Row] >= FirstChild)
+						{
+							ChildRows[ChildStarts[RowNodes[Row] - FirstChild]++] = Row;
+						}
+					}
+
+					Rows = std::move(ChildRows);
+					CountActions(Rows, RowNodes, FirstChild);
+					Parents = Splitting;
+				}
+
+				const uint32_t Root = AddLevelNode(0, 0);
+				Tree = std::vector<FLevelNode>();
+				return Root;
+			}
+
+		private:
+			/** Sums the actions of the nodes from FirstNode on, whose rows are Rows, and their entropy. */
+			void CountActions(const std::vector<int32_t>& Rows, const std::vector<int32_t>& RowNodes, int32_t FirstNode)
+			{
+				const FEncodedColumn& Actions = Columns.back();
+				const size_t NumActions = Actions.States.size();
+				const size_t NumNodes = Tree.size() - (size_t)FirstNode;
+				LevelActionCounts.assign(NumNodes * NumActions, 0);
+				LevelActionFirstRows.assign(NumNodes * NumActions, -1);
+				for (int32_t Row : Rows)
+				{
+					FLevelNode& Node = Tree[RowNodes[Row]];
+					const size_t Index = (size_t)(RowNodes[Row] - FirstNode) * NumActions + Actions.Codes[Row];
+					if (LevelActionFirstRows[Index] == -1)
+					{
+						LevelActionFirstRows[Index] = Row;
+					}
+					LevelActionCounts[Index] += DuplicateCounts[Row];
+					Node.Total += DuplicateCounts[Row];
+					Node.NumRows++;
+				}
+
+				std::vector<std::pair<int32_t, int32_t>> FirstRows;
+				for (size_t Local = 0; Local < NumNodes; Local++)
+				{
+					FirstRows.clear();
+					for (size_t Action = 0; Action < NumActions; Action++)
+					{
+						if (LevelActionFirstRows[Local * NumActions + Action] != -1)
+						{
+							FirstRows.emplace_back(LevelActionFirstRows[Local * NumActions + Action], (int32_t)Action);
+						}
+					}
+					std::sort(FirstRows.begin(), FirstRows.end());
+
+					FLevelNode& Node = Tree[FirstNode + Local];
+					for (const std::pair<int32_t, int32_t>& First : FirstRows)
+					{
+						Node.ActionCodes.push_back(First.second);
+						Node.ActionCounts.push_back(LevelActionCounts[Local * NumActions + First.second]);
+					}
+					Node.ActionEntropy = CountsEntropy(Node.ActionCounts.data(), Node.ActionCounts.size(), Node.Total);
+				}
+			}
+
+			void AllocateHistograms(FLevelNode& Node)
+			{
+				const size_t NumActions = Columns.back().States.size();
+				Node.HistogramOffsets.assign(Columns.size() - 1, -1);
+				int64_t Size = 0;
+				for (int32_t Feature : Node.Features)
+				{
+					Node.HistogramOffsets[Feature] = Size;
+					Size += (int64_t)(Columns[Feature].States.size() * NumActions);
+				}
+				Node.Histograms.assign((size_t)Size, 0);
+			}
+
+			void FreeHistograms(FLevelNode& Node)
+			{
+				Node.Histograms = std::vector<int64_t>();
+				Node.HistogramOffsets = std::vector<int64_t>();
+			}
+
+			/** Adds Parent's histograms minus those of Node's counted siblings to Node's, which hold minus its leaf siblings'. */
+			void DeriveHistograms(FLevelNode& Node, const FLevelNode& Parent)
+			{
+				const size_t NumActions = Columns.back().States.size();
+				for (int32_t Feature : Node.Features)
+				{
+					const size_t Size = Columns[Feature].States.size() * NumActions;
+					int64_t* NodeHistogram = Node.Histograms.data() + Node.HistogramOffsets[Feature];
+					const int64_t* ParentHistogram = Parent.Histograms.data() + Parent.HistogramOffsets[Feature];
+					for (size_t i = 0; i < Size; i++)
+					{
+						NodeHistogram[i] += ParentHistogram[i];
+					}
+					for (int32_t Sibling : Parent.Children)
+					{
+						const FLevelNode& SiblingNode = Tree[Sibling];
+						if (&SiblingNode == &Node || !SiblingNode.IsSplit())
+						{
+							continue;
+						}
+						const int64_t* SiblingHistogram = SiblingNode.Histograms.data() + SiblingNode.HistogramOffsets[Feature];
+						for (size_t i = 0; i < Size; i++)
+						{
+							NodeHistogram[i] -= SiblingHistogram[i];
+						}
+					}
+				}
+			}
+
+			/**
+			 * Picks the split like AddNode() does, from Node's histograms. The histograms are indexed by code, so each
+			 * feature's states are put in the order Node's rows, Rows[Segment.Begin, Segment.End), first show them.
+			 */
+			void ChooseFeature(FLevelNode& Node, const std::vector<int32_t>& Rows, const FSegment& Segment)
+			{
+				const size_t NumActions = Columns.back().States.size();
+				float BestGain = 0;
+				int32_t BestFeature = -1;
+				LevelStateActions.resize(Node.ActionCodes.size());
+				for (int32_t Feature : Node.Features)
+				{
+					const FEncodedColumn& Column = Columns[Feature];
+					const int64_t* NodeHistogram = Node.Histograms.data() + Node.HistogramOffsets[Feature];
+					size_t NumStates = 0;
+					LevelStateCounts.assign(Column.States.size(), 0);
+					for (size_t State = 0; State < Column.States.size(); State++)
+					{
+						for (size_t Action = 0; Action < NumActions; Action++)
+						{
+							LevelStateCounts[State] += NodeHistogram[State * NumActions + Action];
+						}
+						NumStates += LevelStateCounts[State] != 0 ? 1 : 0;
+					}
+
+					// States without counts add nothing to the gain, so the scan stops once the others have shown up
+					std::vector<int32_t> StateCodes;
+					for (size_t i = Segment.Begin; i < Segment.End && StateCodes.size() < NumStates; i++)
+					{
+						const uint32_t Code = Column.Codes[Rows[i]];
+						if (LevelStateCounts[Code] != 0)
+						{
+							Slot(Code, StateCodes);
+						}
+					}
+					ReleaseSlots(StateCodes);
+
+					float Gain = Node.ActionEntropy;
+					for (int32_t State : StateCodes)
+					{
+						for (size_t i = 0; i < Node.ActionCodes.size(); i++)
+						{
+							LevelStateActions[i] = NodeHistogram[State * NumActions + Node.ActionCodes[i]];
+						}
+						float StateProbability = (float)LevelStateCounts[State] / (float)Node.Total;
+						Gain -= StateProbability * CountsEntropy(LevelStateActions.data(), LevelStateActions.size(), LevelStateCounts[State]);
+					}
+					if (BestGain <= Gain)
+					{
+						BestGain = Gain;
+						BestFeature = Feature;
+					}
+				}
+				Node.Feature = BestFeature == -1 ? Node.Features[0] : BestFeature;
+				Node.ChildByCode.assign(Columns[Node.Feature].States.size(), -1);
+			}
+
+			/** Lays out the level-wise node Id and its subtree like AddNode() does. Returns its node index. */
+			uint32_t AddLevelNode(int32_t Id, int32_t Depth)
+			{
+				const uint32_t NodeIndex = (uint32_t)Nodes.size();
+				Nodes.push_back({ FFlatNode::LeafFeature, 0, 0, -1 });
+				Stats.NumNodes++;
+				Stats.MaxDepth = std::max(Stats.MaxDepth, Depth);
+
+				const FLevelNode& Node = Tree[Id];
+				if (Node.Feature == -1)
+				{
+					AddLeaf(NodeIndex, Columns.back(), Node.ActionCodes, Node.ActionCounts);
+					return NodeIndex;
+				}
+
+				const uint32_t First = (uint32_t)Branches.size();
+				Branches.resize(Branches.size() + Node.Children.size());
+				Nodes[NodeIndex] = { Node.Feature, First, (uint32_t)Node.Children.size(), -1 };
+				NumFeatures = std::max(NumFeatures, Node.Feature + 1);
+
+				for (size_t i = 0; i < Node.Children.size(); i++)
+				{
+					uint32_t Child = AddLevelNode(Node.Children[i], Depth + 1);
+					Branches[First + i] = { Columns[Node.Feature].States[Tree[Node.Children[i]].StateCode], Child };
+				}
+				return NodeIndex;
+			}
+
+			/** Information gain of splitting on Column, the same as the engine's InfoGain(). */
+			float InfoGain(const FEncodedColumn& Column, const std::vector<int32_t>& Rows, const std::vector<int32_t>& RowActions,
+				size_t NumActions, float ActionEntropy, int64_t Total)
+			{
+				std::vector<int32_t> StateCodes;
+				Histogram.clear();
+				StateCounts.clear();
+				for (size_t i = 0; i < Rows.size(); i++)
+				{
+					int32_t State = Slot(Column.Codes[Rows[i]], StateCodes);
+					if ((size_t)State == StateCounts.size())
+					{
+						StateCounts.push_back(0);
+						Histogram.resize(Histogram.size() + NumActions, 0);
+					}
+					Histogram[State * NumActions + RowActions[i]] += DuplicateCounts[Rows[i]];
+					StateCounts[State] += DuplicateCounts[Rows[i]];
+				}
+				ReleaseSlots(StateCodes);
+				Stats.HistogramRows += (int64_t)Rows.size();
+
+				// Subtract the conditional entropy of each state, in order of first appearance
+				float Gain = ActionEntropy;
+				for (size_t State = 0; State < StateCounts.size(); State++)
+				{
+					float StateProbability = (float)StateCounts[State] / (float)Total;
+					Gain -= StateProbability * CountsEntropy(&Histogram[State * NumActions], NumActions, StateCounts[State]);
+				}
+				return Gain;
+			}
+
+			void AddLeaf(uint32_t NodeIndex, const FEncodedColumn& Actions, const std::vector<int32_t>& ActionCodes, const std::vector<int64_t>& ActionCounts)
+			{
+				const uint32_t First = (uint32_t)LeafEntries.size();
+				uint32_t Cumulative = 0;
+				int32_t MostLikely = -1;
+				int64_t MostLikelyCount = 0;
+				for (size_t i = 0; i < ActionCodes.size(); i++)
+				{
+					const int32_t Action = Actions.States[ActionCodes[i]];
+					Cumulative += (uint32_t)std::max<int64_t>(ActionCounts[i], 0);
+					LeafEntries.push_back({ Action, Cumulative });
+					if (MostLikely == -1 || ActionCounts[i] > MostLikelyCount)
+					{
+						MostLikely = Action;
+						MostLikelyCount = ActionCounts[i];
+					}
+				}
+				Nodes[NodeIndex] = { FFlatNode::LeafFeature, First, (uint32_t)ActionCodes.size(), MostLikely };
+				Stats.NumLeaves++;
+			}
+
+			/** Slot of Code among the codes seen so far, appending it to SeenCodes when new. */
+			int32_t Slot(uint32_t Code, std::vector<int32_t>& SeenCodes)
+			{
+				if (Slots[Code] == -1)
+				{
+					Slots[Code] = (int32_t)SeenCodes.size();
+					SeenCodes.push_back((int32_t)Code);
+				}
+				return Slots[Code];
+			}
+
+			void ReleaseSlots(const std::vector<int32_t>& SeenCodes)
+			{
+				for (int32_t Code : SeenCodes)
+				{
+					Slots[Code] = -1;
+				}
+			}
+
+			const std::vector<int32_t>& DuplicateCounts;
+			std::vector<FEncodedColumn> Columns;
+
+			/** Scratch reused by every node: code -> slot (-1 when unseen), and the histogram being scored. */
+			std::vector<int32_t> Slots;
+			std::vector<int64_t> Histogram;
+			std::vector<int64_t> StateCounts;
+
+			/** The level-wise build's nodes, and its per-depth action counts by node and action code. */
+			std::vector<FLevelNode> Tree;
+			std::vector<int64_t> LevelActionCounts;
+			std::vector<int32_t> LevelActionFirstRows;
+			/** Scratch for scoring a level-wise node: state counts by code, and one state's action counts in the node's order. */
+			std::vector<int64_t> LevelStateCounts;
+			std::vector<int64_t> LevelStateActions;
+		};
+	}
+
+	bool BuildFlatTree(const FTable& Table, std::vector<uint8_t>& OutBytes, FBuildStats* OutStats, EBuildMode Mode)
+	{
+		using namespace BuilderPrivate;
+
+		OutBytes.clear();
+		if (Table.Columns.empty() || !Table.IsConsistent())
+		{
+			return false;
+		}
+
+		FBuilder Builder(Table);
+		std::vector<int32_t> Features;
+		for (int32_t Column = 0; Column + 1 < Table.GetNumColumns(); Column++)
+		{
+			Features.push_back(Column);
+		}
+
+		uint32_t RootNode = 0;
+		if (Mode == EBuildMode::LevelWise)
+		{
+			RootNode = Builder.BuildLevelWise(Features);
+		}
+		else
+		{
+			std::vector<int32_t> Rows(Table.DuplicateCounts.size());
+			for (size_t i = 0; i < Rows.size(); i++)
+			{
+				Rows[i] = (int32_t)i;
+			}
+			RootNode = Builder.AddNode(std::move(Rows), Features, 0);
+		}
+
+		WriteFlatTree(Builder.Nodes.data(), Builder.Nodes.size(), Builder.Branches.data(), Builder.Branches.size(),
+			Builder.LeafEntries.data(), Builder.LeafEntries.size(), (uint32_t)Builder.NumFeatures, RootNode, OutBytes);
+
+		if (OutStats)
+		{
+			*OutStats = Builder.Stats;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,173 @@
+#include "LearningDecisionTreeCore/Flat.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace LearningDecisionTreeCore
+{
+	// ============================================================================
+	// FFlatView
+	// ============================================================================
+
+	bool FFlatView::Initialize(const uint8_t* Data, size_t Size)
+	{
+		Header = nullptr;
+		Nodes = nullptr;
+		Branches = nullptr;
+		LeafEntries = nullptr;
+
+		if (!Data || Size < sizeof(FFlatHeader) || reinterpret_cast<uintptr_t>(Data) % alignof(FFlatHeader) != 0)
+		{
+			return false;
+		}
+
+		const FFlatHeader* InHeader = reinterpret_cast<const FFlatHeader*>(Data);
+		if (InHeader->Magic != FFlatHeader::ExpectedMagic || InHeader->Version != FFlatHeader::CurrentVersion)
+		{
+			return false;
+		}
+
+		uint64_t RequiredSize = sizeof(FFlatHeader)
+			+ (uint64_t)InHeader->NumNodes * sizeof(FFlatNode)
+			+ (uint64_t)InHeader->NumBranches * sizeof(FFlatBranch)
+			+ (uint64_t)InHeader->NumLeafEntries * sizeof(FFlatLeafEntry);
+		if (RequiredSize > (uint64_t)Size || (InHeader->NumNodes > 0 && InHeader->RootNode >= InHeader->NumNodes))
+		{
+			return false;
+		}
+
+		const uint8_t* Cursor = Data + sizeof(FFlatHeader);
+		Nodes = reinterpret_cast<const FFlatNode*>(Cursor);
+		Cursor += InHeader->NumNodes * sizeof(FFlatNode);
+		Branches = reinterpret_cast<const FFlatBranch*>(Cursor);
+		Cursor += InHeader->NumBranches * sizeof(FFlatBranch);
+		LeafEntries = reinterpret_cast<const FFlatLeafEntry*>(Cursor);
+		Header = InHeader;
+		return true;
+	}
+
+	int32_t FFlatView::FindLeaf(const int32_t* Row, size_t NumStates) const
+	{
+		return FindLeaf(Row, NumStates, [](const FFlatNode&, uint32_t) {});
+	}
+
+	int32_t FFlatView::MostLikelyAction(int32_t LeafIndex) const
+	{
+		if (!Header || LeafIndex < 0 || (uint32_t)LeafIndex >= Header->NumNodes || Nodes[LeafIndex].FeatureIndex != FFlatNode::LeafFeature)
+		{
+			return -1;
+		}
+		return Nodes[LeafIndex].MostLikelyAction;
+	}
+
+	int32_t FFlatView::SampleAction(int32_t LeafIndex, uint32_t Random) const
+	{
+		return SampleActionWith(LeafIndex, [Random](uint32_t Total) { return Random % Total; });
+	}
+
+	size_t FFlatView::GetSize() const
+	{
+		if (!Header)
+		{
+			return 0;
+		}
+		return sizeof(FFlatHeader)
+			+ (size_t)Header->NumNodes * sizeof(FFlatNode)
+			+ (size_t)Header->NumBranches * sizeof(FFlatBranch)
+			+ (size_t)Header->NumLeafEntries * sizeof(FFlatLeafEntry);
+	}
+
+	void WriteFlatTree(const FFlatNode* Nodes, size_t NumNodes, const FFlatBranch* Branches, size_t NumBranches,
+		const FFlatLeafEntry* LeafEntries, size_t NumLeafEntries, uint32_t NumFeatures, uint32_t RootNode, std::vector<uint8_t>& OutBytes)
+	{
+		FFlatHeader Header;
+		Header.Magic = FFlatHeader::ExpectedMagic;
+		Header.Version = FFlatHeader::CurrentVersion;
+		Header.NumNodes = (uint32_t)NumNodes;
+		Header.NumBranches = (uint32_t)NumBranches;
+		Header.NumLeafEntries = (uint32_t)NumLeafEntries;
+		Header.NumFeatures = NumFeatures;
+		Header.RootNode = RootNode;
+		Header.Reserved = 0;
+
+		const size_t NodesSize = NumNodes * sizeof(FFlatNode);
+		const size_t BranchesSize = NumBranches * sizeof(FFlatBranch);
+		const size_t LeafEntriesSize = NumLeafEntries * sizeof(FFlatLeafEntry);
+		OutBytes.resize(sizeof(Header) + NodesSize + BranchesSize + LeafEntriesSize);
+
+		// Empty sections may come with null pointers, which memcpy must not see
+		uint8_t* Cursor = OutBytes.data();
+		std::memcpy(Cursor, &Header, sizeof(Header));
+		Cursor += sizeof(Header);
+		if (NodesSize > 0)
+		{
+			std::memcpy(Cursor, Nodes, NodesSize);
+			Cursor += NodesSize;
+		}
+		if (BranchesSize > 0)
+		{
+			std::memcpy(Cursor, Branches, BranchesSize);
+			Cursor += BranchesSize;
+		}
+		if (LeafEntriesSize > 0)
+		{
+			std::memcpy(Cursor, LeafEntries, LeafEntriesSize);
+		}
+	}
+
+	// ============================================================================
+	// FFlatModel
+	// ============================================================================
+
+	FFlatModel::FFlatModel(FFlatModel&& Other) noexcept
+		: Bytes(std::move(Other.Bytes))
+		, View(Other.View)
+	{
+		Other.View = FFlatView();
+	}
+
+	FFlatModel& FFlatModel::operator=(FFlatModel&& Other) noexcept
+	{
+		if (this != &Other)
+		{
+			// Moving a vector keeps its buffer, so the view stays valid
+			Bytes = std::move(Other.Bytes);
+			View = Other.View;
+			Other.View = FFlatView();
+		}
+		return *this;
+	}
+
+	bool FFlatModel::SetBytes(std::vector<uint8_t>&& InBytes)
+	{
+		Bytes = std::move(InBytes);
+		if (!View.Initialize(Bytes.data(), Bytes.size()))
+		{
+			Bytes.clear();
+			return false;
+		}
+		return true;
+	}
+
+	bool FFlatModel::LoadFile(const std::string& Path)
+	{
+		std::ifstream File(Path, std::ios::binary);
+		if (!File)
+		{
+			return false;
+		}
+		std::vector<uint8_t> FileBytes((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+		return SetBytes(std::move(FileBytes));
+	}
+
+	bool FFlatModel::SaveFile(const std::string& Path) const
+	{
+		if (!View.IsValid())
+		{
+			return false;
+		}
+		std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+		File.write(reinterpret_cast<const char*>(Bytes.data()), (std::streamsize)View.GetSize());
+		return (bool)File;
+	}
+}
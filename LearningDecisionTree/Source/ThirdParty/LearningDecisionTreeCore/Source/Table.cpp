@@ -0,0 +1,146 @@
+#include "LearningDecisionTreeCore/Table.h"
+
+namespace LearningDecisionTreeCore
+{
+	int32_t FTable::FindColumn(const std::string& Name) const
+	{
+		for (size_t i = 0; i < ColumnNames.size(); i++)
+		{
+			if (ColumnNames[i] == Name)
+			{
+				return (int32_t)i;
+			}
+		}
+		return -1;
+	}
+
+	bool FTable::AddColumn(const std::string& Name)
+	{
+		if (GetNumRows() > 0 || FindColumn(Name) != -1)
+		{
+			return false;
+		}
+
+		ColumnNames.push_back(Name);
+		Columns.emplace_back();
+		return true;
+	}
+
+	uint64_t FTable::HashRow(const int32_t* Row) const
+	{
+		// FNV-1a over the states
+		uint64_t Hash = 14695981039346656037ull;
+		for (size_t Column = 0; Column < Columns.size(); Column++)
+		{
+			Hash ^= (uint32_t)Row[Column];
+			Hash *= 1099511628211ull;
+		}
+		return Hash;
+	}
+
+	bool FTable::RowEquals(int32_t PhysicalRow, const int32_t* Row) const
+	{
+		for (size_t Column = 0; Column < Columns.size(); Column++)
+		{
+			if (Columns[Column][PhysicalRow] != Row[Column])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool FTable::AddRow(const int32_t* Row, size_t NumStates, int32_t Count)
+	{
+		if (NumStates != Columns.size() || Columns.empty() || Count <= 0)
+		{
+			return false;
+		}
+
+		// Index any rows added without AddRow(), e.g. by a table reader
+		if (NumIndexedRows != GetNumRows())
+		{
+			RowIndex.clear();
+			RowIndex.reserve(DuplicateCounts.size());
+			std::vector<int32_t> Existing(Columns.size());
+			for (int32_t i = 0; i < GetNumRows(); i++)
+			{
+				for (size_t Column = 0; Column < Columns.size(); Column++)
+				{
+					Existing[Column] = Columns[Column][i];
+				}
+				RowIndex.emplace(HashRow(Existing.data()), i);
+			}
+			NumIndexedRows = GetNumRows();
+		}
+
+		const uint64_t Hash = HashRow(Row);
+		auto Range = RowIndex.equal_range(Hash);
+		for (auto It = Range.first; It != Range.second; ++It)
+		{
+			if (RowEquals(It->second, Row))
+			{
+				DuplicateCounts[It->second] += Count;
+				TotalRows += Count;
+				return true;
+			}
+		}
+
+		for (size_t Column = 0; Column < Columns.size(); Column++)
+		{
+			Columns[Column].push_back(Row[Column]);
+		}
+		DuplicateCounts.push_back(Count);
+		TotalRows += Count;
+		RowIndex.emplace(Hash, NumIndexedRows++);
+		return true;
+	}
+
+	bool FTable::IsConsistent() const
+	{
+		if (Columns.size() != ColumnNames.size())
+		{
+			return false;
+		}
+
+		for (int32_t Count : DuplicateCounts)
+		{
+			if (Count < 0)
+			{
+				return false;
+			}
+		}
+
+		for (const std::vector<int32_t>& Column : Columns)
+		{
+			if (Column.size() != DuplicateCounts.size())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	size_t FTable::GetAllocatedSize() const
+	{
+		size_t Size = ColumnNames.capacity() * sizeof(std::string) + Columns.capacity() * sizeof(std::vector<int32_t>)
+			+ DuplicateCounts.capacity() * sizeof(int32_t);
+		for (const std::vector<int32_t>& Column : Columns)
+		{
+			Size += Column.capacity() * sizeof(int32_t);
+		}
+		// Buckets plus one node per indexed row
+		Size += RowIndex.bucket_count() * sizeof(void*) + RowIndex.size() * (sizeof(void*) * 2 + sizeof(uint64_t) + sizeof(int32_t));
+		return Size;
+	}
+
+	void FTable::Reset()
+	{
+		ColumnNames.clear();
+		Columns.clear();
+		DuplicateCounts.clear();
+		TotalRows = 0;
+		RowIndex.clear();
+		NumIndexedRows = 0;
+	}
+}
@@ -0,0 +1,675 @@
+#include "LearningDecisionTreeCore/TableFile.h"
+#include "LearningDecisionTreeCore/Encoding.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#ifndef LEARNINGDECISIONTREECORE_WITH_ZLIB
+#define LEARNINGDECISIONTREECORE_WITH_ZLIB 0
+#endif
+
+#if LEARNINGDECISIONTREECORE_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace LearningDecisionTreeCore
+{
+	namespace TableFilePrivate
+	{
+		using namespace Encoding;
+
+		/** Number of bits needed to store codes in [0, NumCodes). */
+		static uint8_t BitWidthFor(size_t NumCodes)
+		{
+			uint8_t Bits = 0;
+			while (NumCodes > 1 && ((size_t)1 << Bits) < NumCodes)
+			{
+				Bits++;
+			}
+			return Bits;
+		}
+
+		static void PackCodes(std::vector<uint8_t>& Out, const std::vector<uint32_t>& Codes, uint8_t BitWidth)
+		{
+			if (BitWidth == 0)
+			{
+				return;
+			}
+
+			Out.reserve(Out.size() + (size_t)(((uint64_t)Codes.size() * BitWidth + 7) / 8));
+			uint64_t Accumulator = 0;
+			int32_t Bits = 0;
+			for (uint32_t Code : Codes)
+			{
+				Accumulator |= (uint64_t)Code << Bits;
+				Bits += BitWidth;
+				while (Bits >= 8)
+				{
+					Out.push_back((uint8_t)Accumulator);
+					Accumulator >>= 8;
+					Bits -= 8;
+				}
+			}
+			if (Bits > 0)
+			{
+				Out.push_back((uint8_t)Accumulator);
+			}
+		}
+
+		static bool UnpackCodes(const std::vector<uint8_t>& In, size_t Offset, int32_t NumCodes, uint8_t BitWidth, std::vector<uint32_t>& OutCodes)
+		{
+			OutCodes.assign((size_t)NumCodes, 0);
+			if (BitWidth == 0)
+			{
+				return true;
+			}
+
+			if (BitWidth > 32 || In.size() - Offset < ((uint64_t)NumCodes * BitWidth + 7) / 8)
+			{
+				return false;
+			}
+
+			const uint64_t Mask = (1ull << BitWidth) - 1;
+			uint64_t Accumulator = 0;
+			int32_t Bits = 0;
+			for (int32_t i = 0; i < NumCodes; i++)
+			{
+				while (Bits < BitWidth)
+				{
+					Accumulator |= (uint64_t)In[Offset++] << Bits;
+					Bits += 8;
+				}
+				OutCodes[i] = (uint32_t)(Accumulator & Mask);
+				Accumulator >>= BitWidth;
+				Bits -= BitWidth;
+			}
+			return true;
+		}
+
+		/** Encodes a column as a sorted dictionary of its distinct states plus bit-packed codes. */
+		static void EncodeColumn(const std::vector<int32_t>& Column, std::vector<uint8_t>& Out)
+		{
+			std::vector<int32_t> Dictionary = Column;
+			std::sort(Dictionary.begin(), Dictionary.end());
+			Dictionary.erase(std::unique(Dictionary.begin(), Dictionary.end()), Dictionary.end());
+
+			WriteVarUInt(Out, (uint32_t)Dictionary.size());
+			int64_t Previous = 0;
+			for (size_t i = 0; i < Dictionary.size(); i++)
+			{
+				// The first value may be negative, later ones are strictly increasing deltas
+				uint32_t Delta = (i == 0) ? ZigZagEncode(Dictionary[0]) : (uint32_t)(Dictionary[i] - Previous);
+				WriteVarUInt(Out, Delta);
+				Previous = Dictionary[i];
+			}
+
+			std::vector<uint32_t> Codes;
+			Codes.reserve(Column.size());
+			for (int32_t State : Column)
+			{
+				Codes.push_back((uint32_t)(std::lower_bound(Dictionary.begin(), Dictionary.end(), State) - Dictionary.begin()));
+			}
+
+			uint8_t BitWidth = BitWidthFor(Dictionary.size());
+			Out.push_back(BitWidth);
+			PackCodes(Out, Codes, BitWidth);
+		}
+
+		static bool DecodeColumn(const std::vector<uint8_t>& In, int32_t NumRows, std::vector<int32_t>& OutColumn)
+		{
+			size_t Offset = 0;
+			uint32_t NumStates = 0;
+			if (!ReadVarUInt(In, Offset, NumStates) || (NumRows > 0 && NumStates == 0) || NumStates > In.size())
+			{
+				return false;
+			}
+
+			std::vector<int32_t> Dictionary;
+			Dictionary.reserve(NumStates);
+			int64_t Previous = 0;
+			for (uint32_t i = 0; i < NumStates; i++)
+			{
+				uint32_t Encoded = 0;
+				if (!ReadVarUInt(In, Offset, Encoded))
+				{
+					return false;
+				}
+				int64_t State = (i == 0) ? (int64_t)ZigZagDecode(Encoded) : Previous + Encoded;
+				Dictionary.push_back((int32_t)State);
+				Previous = State;
+			}
+
+			if (Offset >= In.size() && NumRows > 0)
+			{
+				return false;
+			}
+			uint8_t BitWidth = NumRows > 0 ? In[Offset++] : 0;
+
+			std::vector<uint32_t> Codes;
+			if (!UnpackCodes(In, Offset, NumRows, BitWidth, Codes))
+			{
+				return false;
+			}
+
+			OutColumn.resize((size_t)NumRows);
+			for (int32_t Row = 0; Row < NumRows; Row++)
+			{
+				if (Codes[Row] >= Dictionary.size())
+				{
+					return false;
+				}
+				OutColumn[Row] = Dictionary[Codes[Row]];
+			}
+			return true;
+		}
+
+		/** Appends Code as UTF-8. */
+		static void AppendUtf8(std::string& Out, uint32_t Code)
+		{
+			if (Code < 0x80)
+			{
+				Out += (char)Code;
+			}
+			else if (Code < 0x800)
+			{
+				Out += (char)(0xC0 | (Code >> 6));
+				Out += (char)(0x80 | (Code & 0x3F));
+			}
+			else if (Code < 0x10000)
+			{
+				Out += (char)(0xE0 | (Code >> 12));
+				Out += (char)(0x80 | ((Code >> 6) & 0x3F));
+				Out += (char)(0x80 | (Code & 0x3F));
+			}
+			else
+			{
+				Out += (char)(0xF0 | (Code >> 18));
+				Out += (char)(0x80 | ((Code >> 12) & 0x3F));
+				Out += (char)(0x80 | ((Code >> 6) & 0x3F));
+				Out += (char)(0x80 | (Code & 0x3F));
+			}
+		}
+
+		/** Decodes UTF-8 to UTF-16 code units. Malformed sequences become U+FFFD. */
+		static std::vector<uint16_t> Utf8ToUtf16(const std::string& In)
+		{
+			std::vector<uint16_t> Out;
+			for (size_t i = 0; i < In.size();)
+			{
+				const uint8_t Lead = (uint8_t)In[i];
+				const int32_t Length = Lead < 0x80 ? 1 : (Lead >> 5) == 0x6 ? 2 : (Lead >> 4) == 0xE ? 3 : (Lead >> 3) == 0x1E ? 4 : 0;
+				uint32_t Code = Length == 1 ? Lead : Length == 2 ? (Lead & 0x1F) : Length == 3 ? (Lead & 0x0F) : (Lead & 0x07);
+				bool bValid = Length > 0 && i + Length <= In.size();
+				for (int32_t k = 1; bValid && k < Length; k++)
+				{
+					const uint8_t Continuation = (uint8_t)In[i + k];
+					bValid = (Continuation & 0xC0) == 0x80;
+					Code = (Code << 6) | (Continuation & 0x3F);
+				}
+
+				if (!bValid)
+				{
+					Out.push_back(0xFFFD);
+					i++;
+				}
+				else if (Code >= 0x10000)
+				{
+					Code -= 0x10000;
+					Out.push_back((uint16_t)(0xD800 | (Code >> 10)));
+					Out.push_back((uint16_t)(0xDC00 | (Code & 0x3FF)));
+					i += Length;
+				}
+				else
+				{
+					Out.push_back((uint16_t)Code);
+					i += Length;
+				}
+			}
+			return Out;
+		}
+
+		/** Writes Value like an engine FString: ANSI if it is pure ASCII, UTF-16 (negative length) otherwise. */
+		static void WriteString(FWriter& Writer, const std::string& Value)
+		{
+			if (Value.empty())
+			{
+				Writer.Write<int32_t>(0);
+				return;
+			}
+
+			const bool bAscii = std::all_of(Value.begin(), Value.end(), [](char Char) { return (uint8_t)Char < 0x80; });
+			if (bAscii)
+			{
+				Writer.Write<int32_t>((int32_t)Value.size() + 1);
+				Writer.WriteBytes(reinterpret_cast<const uint8_t*>(Value.data()), Value.size());
+				Writer.Write<uint8_t>(0);
+				return;
+			}
+
+			std::vector<uint16_t> Utf16 = Utf8ToUtf16(Value);
+			Writer.Write<int32_t>(-((int32_t)Utf16.size() + 1));
+			for (uint16_t Unit : Utf16)
+			{
+				Writer.Write<uint16_t>(Unit);
+			}
+			Writer.Write<uint16_t>(0);
+		}
+
+		/** Reads an engine FString as UTF-8. */
+		static bool ReadString(FReader& Reader, std::string& OutValue)
+		{
+			OutValue.clear();
+			const int32_t SaveNum = Reader.Read<int32_t>();
+			if (Reader.IsError() || SaveNum == INT32_MIN)
+			{
+				return false;
+			}
+			if (SaveNum == 0)
+			{
+				return true;
+			}
+
+			if (SaveNum > 0)
+			{
+				const uint8_t* Chars = Reader.ReadBytes((size_t)SaveNum);
+				if (!Chars)
+				{
+					return false;
+				}
+				// ANSI strings are Latin-1; the last char is the terminator
+				for (int32_t i = 0; i < SaveNum - 1 && Chars[i] != 0; i++)
+				{
+					AppendUtf8(OutValue, Chars[i]);
+				}
+				return true;
+			}
+
+			const int32_t NumUnits = -SaveNum;
+			if (Reader.GetRemaining() / 2 < (size_t)NumUnits)
+			{
+				return false;
+			}
+			for (int32_t i = 0; i < NumUnits; i++)
+			{
+				uint32_t Unit = Reader.Read<uint16_t>();
+				if (i == NumUnits - 1 || Unit == 0)
+				{
+					continue;
+				}
+				if (Unit >= 0xD800 && Unit < 0xDC00 && i + 2 < NumUnits)
+				{
+					const uint32_t Low = Reader.Read<uint16_t>();
+					i++;
+					Unit = (Low >= 0xDC00 && Low < 0xE000) ? 0x10000 + ((Unit - 0xD800) << 10) + (Low - 0xDC00) : 0xFFFD;
+				}
+				AppendUtf8(OutValue, Unit);
+			}
+			return !Reader.IsError();
+		}
+
+#if LEARNINGDECISIONTREECORE_WITH_ZLIB
+		/** The library's own codec: zlib only. */
+		class FZlibCodec final : public ICompressionCodec
+		{
+		public:
+			bool Compress(ECompression Compression, const uint8_t* In, size_t InSize, std::vector<uint8_t>& Out) const override
+			{
+				if (Compression != ECompression::Zlib)
+				{
+					return false;
+				}
+				uLongf CompressedSize = compressBound((uLong)InSize);
+				Out.resize(CompressedSize);
+				if (compress(Out.data(), &CompressedSize, In, (uLong)InSize) != Z_OK)
+				{
+					return false;
+				}
+				Out.resize(CompressedSize);
+				return true;
+			}
+
+			bool Uncompress(ECompression Compression, const uint8_t* In, size_t InSize, uint8_t* Out, size_t OutSize) const override
+			{
+				uLongf DestSize = (uLongf)OutSize;
+				return Compression == ECompression::Zlib && uncompress(Out, &DestSize, In, (uLong)InSize) == Z_OK && DestSize == (uLongf)OutSize;
+			}
+		};
+#endif
+
+		static const ICompressionCodec* GetDefaultCodec()
+		{
+#if LEARNINGDECISIONTREECORE_WITH_ZLIB
+			static const FZlibCodec ZlibCodec;
+			return &ZlibCodec;
+#else
+			return nullptr;
+#endif
+		}
+
+		static void WriteBlock(FWriter& Writer, const std::vector<uint8_t>& Payload, ECompression Compression, const ICompressionCodec* Codec,
+			std::vector<uint8_t>& Compressed, uint32_t& Crc)
+		{
+			Crc = MemCrc32(Payload.data(), Payload.size(), Crc);
+
+			const int32_t UncompressedSize = (int32_t)Payload.size();
+			if (Codec && Compression != ECompression::None && UncompressedSize > 0
+				&& Codec->Compress(Compression, Payload.data(), Payload.size(), Compressed) && Compressed.size() < Payload.size())
+			{
+				Writer.Write<uint8_t>(1);
+				Writer.Write<int32_t>(UncompressedSize);
+				Writer.Write<int32_t>((int32_t)Compressed.size());
+				Writer.WriteBytes(Compressed.data(), Compressed.size());
+				return;
+			}
+
+			// Stored raw when compression is off, unavailable or does not pay for itself
+			Writer.Write<uint8_t>(0);
+			Writer.Write<int32_t>(UncompressedSize);
+			Writer.Write<int32_t>(UncompressedSize);
+			Writer.WriteBytes(Payload.data(), Payload.size());
+		}
+
+		static bool ReadBlock(FReader& Reader, ECompression Compression, const ICompressionCodec* Codec, std::vector<uint8_t>& OutPayload, uint32_t& Crc)
+		{
+			const uint8_t bCompressed = Reader.Read<uint8_t>();
+			const int32_t UncompressedSize = Reader.Read<int32_t>();
+			const int32_t StoredSize = Reader.Read<int32_t>();
+			if (Reader.IsError() || UncompressedSize < 0 || StoredSize < 0 || (size_t)StoredSize > Reader.GetRemaining())
+			{
+				return false;
+			}
+
+			const uint8_t* Stored = Reader.ReadBytes((size_t)StoredSize);
+			if (bCompressed)
+			{
+				OutPayload.resize((size_t)UncompressedSize);
+				if (!Codec || !Codec->Uncompress(Compression, Stored, (size_t)StoredSize, OutPayload.data(), OutPayload.size()))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				if (StoredSize != UncompressedSize)
+				{
+					return false;
+				}
+				OutPayload.assign(Stored, Stored + StoredSize);
+			}
+
+			Crc = MemCrc32(OutPayload.data(), OutPayload.size(), Crc);
+			return true;
+		}
+
+		/** Reads the original unversioned format: raw int32 arrays keyed by column name strings. */
+		static bool ReadLegacy(FReader& Reader, FTable& OutTable)
+		{
+			FTable NewTable;
+			NewTable.TotalRows = Reader.Read<int32_t>();
+
+			const int32_t NumColumnNames = Reader.Read<int32_t>();
+			for (int32_t i = 0; i < NumColumnNames && !Reader.IsError(); i++)
+			{
+				std::string Name;
+				if (!ReadString(Reader, Name))
+				{
+					return false;
+				}
+				NewTable.ColumnNames.push_back(Name);
+			}
+			NewTable.Columns.resize(NewTable.ColumnNames.size());
+
+			const int32_t NumColumns = Reader.Read<int32_t>();
+			for (int32_t i = 0; i < NumColumns && !Reader.IsError(); i++)
+			{
+				std::string Name;
+				const int32_t NumValues = ReadString(Reader, Name) ? Reader.Read<int32_t>() : -1;
+				if (NumValues < 0 || Reader.GetRemaining() / sizeof(int32_t) < (size_t)NumValues)
+				{
+					return false;
+				}
+
+				std::vector<int32_t> Values((size_t)NumValues);
+				for (int32_t& Value : Values)
+				{
+					Value = Reader.Read<int32_t>();
+				}
+
+				const int32_t Column = NewTable.FindColumn(Name);
+				if (Column != -1)
+				{
+					NewTable.Columns[Column] = std::move(Values);
+				}
+			}
+
+			const int32_t NumRows = Reader.Read<int32_t>();
+			if (NumRows < 0 || Reader.GetRemaining() / sizeof(int32_t) < (size_t)NumRows)
+			{
+				return false;
+			}
+			NewTable.DuplicateCounts.resize((size_t)NumRows);
+			for (int32_t& Count : NewTable.DuplicateCounts)
+			{
+				Count = Reader.Read<int32_t>();
+			}
+
+			if (Reader.IsError() || !NewTable.IsConsistent())
+			{
+				return false;
+			}
+
+			OutTable = std::move(NewTable);
+			return true;
+		}
+	}
+
+	uint32_t MemCrc32(const void* Data, size_t Size, uint32_t Crc)
+	{
+		static const std::vector<uint32_t> Table = []()
+		{
+			std::vector<uint32_t> Entries(256);
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t Value = i;
+				for (int32_t Bit = 0; Bit < 8; Bit++)
+				{
+					Value = (Value & 1) ? (Value >> 1) ^ 0xEDB88320u : Value >> 1;
+				}
+				Entries[i] = Value;
+			}
+			return Entries;
+		}();
+
+		const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+		Crc = ~Crc;
+		for (size_t i = 0; i < Size; i++)
+		{
+			Crc = (Crc >> 8) ^ Table[(Crc ^ Bytes[i]) & 0xFF];
+		}
+		return ~Crc;
+	}
+
+	bool WriteTable(const FTable& Table, std::vector<uint8_t>& OutBytes, ECompression Compression, uint32_t* OutChecksum, const ICompressionCodec* Codec)
+	{
+		using namespace TableFilePrivate;
+
+		if (!Table.IsConsistent())
+		{
+			return false;
+		}
+
+		if (!Codec)
+		{
+			Codec = GetDefaultCodec();
+		}
+
+		FWriter Writer(OutBytes);
+		uint32_t Crc = 0;
+		Writer.Write<uint32_t>(FTableFile::Magic);
+		Writer.Write<uint16_t>(FTableFile::Version);
+		Writer.Write<uint8_t>((uint8_t)Compression);
+		Writer.Write<uint8_t>(0);
+
+		// Schema
+		std::vector<uint8_t> Block;
+		std::vector<uint8_t> Compressed;
+		{
+			FWriter SchemaWriter(Block);
+			SchemaWriter.Write<int32_t>(Table.TotalRows);
+			SchemaWriter.Write<int32_t>(Table.GetNumRows());
+			SchemaWriter.Write<int32_t>(Table.GetNumColumns());
+			for (const std::string& Name : Table.ColumnNames)
+			{
+				WriteString(SchemaWriter, Name);
+			}
+			WriteBlock(Writer, Block, Compression, Codec, Compressed, Crc);
+		}
+
+		// DuplicateCounts
+		Block.clear();
+		for (int32_t Count : Table.DuplicateCounts)
+		{
+			WriteVarUInt(Block, (uint32_t)Count);
+		}
+		WriteBlock(Writer, Block, Compression, Codec, Compressed, Crc);
+
+		// Columns, in ColumnNames order
+		for (const std::vector<int32_t>& Column : Table.Columns)
+		{
+			Block.clear();
+			EncodeColumn(Column, Block);
+			WriteBlock(Writer, Block, Compression, Codec, Compressed, Crc);
+		}
+
+		Writer.Write<uint32_t>(Crc);
+		if (OutChecksum)
+		{
+			*OutChecksum = Crc;
+		}
+		return true;
+	}
+
+	bool ReadTable(const uint8_t* Data, size_t Size, FTable& OutTable, uint32_t* OutChecksum, const ICompressionCodec* Codec)
+	{
+		using namespace TableFilePrivate;
+
+		if (!Codec)
+		{
+			Codec = GetDefaultCodec();
+		}
+
+		FReader Reader(Data, Size);
+		if (Reader.Read<uint32_t>() != FTableFile::Magic)
+		{
+			if (OutChecksum)
+			{
+				*OutChecksum = 0;
+			}
+			FReader LegacyReader(Data, Size);
+			return Data && ReadLegacy(LegacyReader, OutTable);
+		}
+
+		const uint16_t FileVersion = Reader.Read<uint16_t>();
+		const ECompression Compression = (ECompression)Reader.Read<uint8_t>();
+		Reader.Read<uint8_t>();
+		if (Reader.IsError() || FileVersion == 0 || FileVersion > FTableFile::Version)
+		{
+			return false;
+		}
+
+		FTable NewTable;
+		uint32_t Crc = 0;
+
+		// Schema
+		std::vector<uint8_t> Block;
+		int32_t NumRows = 0;
+		{
+			if (!ReadBlock(Reader, Compression, Codec, Block, Crc))
+			{
+				return false;
+			}
+			FReader SchemaReader(Block.data(), Block.size());
+			NewTable.TotalRows = SchemaReader.Read<int32_t>();
+			NumRows = SchemaReader.Read<int32_t>();
+			const int32_t NumColumns = SchemaReader.Read<int32_t>();
+			if (SchemaReader.IsError() || NumRows < 0 || NumColumns < 0 || (size_t)NumColumns > Block.size())
+			{
+				return false;
+			}
+			for (int32_t i = 0; i < NumColumns; i++)
+			{
+				std::string Name;
+				if (!ReadString(SchemaReader, Name))
+				{
+					return false;
+				}
+				NewTable.ColumnNames.push_back(Name);
+			}
+		}
+
+		// DuplicateCounts
+		{
+			if (!ReadBlock(Reader, Compression, Codec, Block, Crc) || (size_t)NumRows > Block.size())
+			{
+				return false;
+			}
+			NewTable.DuplicateCounts.reserve((size_t)NumRows);
+			size_t Offset = 0;
+			for (int32_t Row = 0; Row < NumRows; Row++)
+			{
+				uint32_t Count = 0;
+				if (!ReadVarUInt(Block, Offset, Count))
+				{
+					return false;
+				}
+				NewTable.DuplicateCounts.push_back((int32_t)Count);
+			}
+		}
+
+		// Columns
+		NewTable.Columns.resize(NewTable.ColumnNames.size());
+		for (std::vector<int32_t>& Column : NewTable.Columns)
+		{
+			if (!ReadBlock(Reader, Compression, Codec, Block, Crc) || !DecodeColumn(Block, NumRows, Column))
+			{
+				return false;
+			}
+		}
+
+		const uint32_t StoredCrc = Reader.Read<uint32_t>();
+		if (Reader.IsError() || StoredCrc != Crc)
+		{
+			return false;
+		}
+
+		if (OutChecksum)
+		{
+			*OutChecksum = Crc;
+		}
+		OutTable = std::move(NewTable);
+		return true;
+	}
+
+	bool SaveTableFile(const std::string& Path, const FTable& Table, ECompression Compression)
+	{
+		std::vector<uint8_t> Bytes;
+		if (!WriteTable(Table, Bytes, Compression))
+		{
+			return false;
+		}
+		std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+		File.write(reinterpret_cast<const char*>(Bytes.data()), (std::streamsize)Bytes.size());
+		return (bool)File;
+	}
+
+	bool LoadTableFile(const std::string& Path, FTable& OutTable)
+	{
+		std::ifstream File(Path, std::ios::binary);
+		if (!File)
+		{
+			return false;
+		}
+		std::vector<uint8_t> Bytes((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+		return ReadTable(Bytes.data(), Bytes.size(), OutTable);
+	}
+}
@@ -0,0 +1,171 @@
+#include "LearningDecisionTreeCore/Builder.h"
+#include "LearningDecisionTreeCore/Flat.h"
+#include "LearningDecisionTreeCore/TableFile.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace LearningDecisionTreeCore;
+
+namespace
+{
+	/** Like FLearningDecisionTreeSyntheticSpec: the action depends on the informative features, plus label noise. */
+	struct FBenchmarkSpec
+	{
+		int32_t NumRows = 200000;
+		int32_t NumFeatures = 12;
+		int32_t Cardinality = 4;
+		int32_t NumActions = 4;
+		int32_t NumInformativeFeatures = 3;
+		float LabelNoise = 0.05f;
+		uint32_t Seed = 1;
+	};
+
+	class FRandom
+	{
+	public:
+		explicit FRandom(uint32_t InSeed) : State(InSeed ? InSeed : 1) {}
+
+		uint32_t Next()
+		{
+			// xorshift32
+			State ^= State << 13;
+			State ^= State >> 17;
+			State ^= State << 5;
+			return State;
+		}
+
+		float NextFloat() { return (Next() >> 8) * (1.0f / 16777216.0f); }
+
+	private:
+		uint32_t State;
+	};
+
+	double SecondsSince(std::chrono::steady_clock::time_point Start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	}
+
+	bool ParseArgs(int Argc, char** Argv, FBenchmarkSpec& Spec)
+	{
+		for (int i = 1; i + 1 < Argc; i += 2)
+		{
+			const int32_t Value = std::atoi(Argv[i + 1]);
+			if (std::strcmp(Argv[i], "--rows") == 0) { Spec.NumRows = Value; }
+			else if (std::strcmp(Argv[i], "--features") == 0) { Spec.NumFeatures = Value; }
+			else if (std::strcmp(Argv[i], "--cardinality") == 0) { Spec.Cardinality = Value; }
+			else if (std::strcmp(Argv[i], "--actions") == 0) { Spec.NumActions = Value; }
+			else if (std::strcmp(Argv[i], "--seed") == 0) { Spec.Seed = (uint32_t)Value; }
+			else { return false; }
+		}
+		return Spec.NumRows > 0 && Spec.NumFeatures > 0 && Spec.Cardinality > 0 && Spec.NumActions > 0;
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	FBenchmarkSpec Spec;
+	if (!ParseArgs(Argc, Argv, Spec))
+	{
+		std::fprintf(stderr, "Usage: %s [--rows N] [--features N] [--cardinality N] [--actions N] [--seed N]\n", Argv[0]);
+		return 2;
+	}
+	Spec.NumInformativeFeatures = Spec.NumInformativeFeatures < Spec.NumFeatures ? Spec.NumInformativeFeatures : Spec.NumFeatures;
+
+	// Generate
+	FRandom Random(Spec.Seed);
+	std::vector<int32_t> Rows((size_t)Spec.NumRows * (Spec.NumFeatures + 1));
+	for (int32_t Row = 0; Row < Spec.NumRows; Row++)
+	{
+		int32_t* States = &Rows[(size_t)Row * (Spec.NumFeatures + 1)];
+		uint32_t Label = 0;
+		for (int32_t Feature = 0; Feature < Spec.NumFeatures; Feature++)
+		{
+			States[Feature] = (int32_t)(Random.Next() % (uint32_t)Spec.Cardinality);
+			if (Feature < Spec.NumInformativeFeatures)
+			{
+				Label = Label * 31 + (uint32_t)States[Feature];
+			}
+		}
+		States[Spec.NumFeatures] = Random.NextFloat() < Spec.LabelNoise
+			? (int32_t)(Random.Next() % (uint32_t)Spec.NumActions) : (int32_t)(Label % (uint32_t)Spec.NumActions);
+	}
+
+	// AddRow
+	auto Start = std::chrono::steady_clock::now();
+	FTable Table;
+	for (int32_t Feature = 0; Feature < Spec.NumFeatures; Feature++)
+	{
+		Table.AddColumn("Feature" + std::to_string(Feature));
+	}
+	Table.AddColumn("Action");
+	for (int32_t Row = 0; Row < Spec.NumRows; Row++)
+	{
+		Table.AddRow(&Rows[(size_t)Row * (Spec.NumFeatures + 1)], (size_t)Spec.NumFeatures + 1);
+	}
+	const double AddRowSeconds = SecondsSince(Start);
+
+	// Build, both ways
+	Start = std::chrono::steady_clock::now();
+	std::vector<uint8_t> Bytes;
+	FBuildStats Stats;
+	if (!BuildFlatTree(Table, Bytes, &Stats))
+	{
+		std::fprintf(stderr, "BuildFlatTree failed\n");
+		return 1;
+	}
+	const double BuildSeconds = SecondsSince(Start);
+
+	Start = std::chrono::steady_clock::now();
+	std::vector<uint8_t> LevelWiseBytes;
+	FBuildStats LevelWiseStats;
+	BuildFlatTree(Table, LevelWiseBytes, &LevelWiseStats, EBuildMode::LevelWise);
+	const double LevelWiseSeconds = SecondsSince(Start);
+	if (LevelWiseBytes != Bytes)
+	{
+		std::fprintf(stderr, "The level-wise build wrote a different tree\n");
+		return 1;
+	}
+
+	FFlatModel Model;
+	if (!Model.SetBytes(std::move(Bytes)))
+	{
+		std::fprintf(stderr, "The built tree is not a valid flat tree\n");
+		return 1;
+	}
+
+	// Eval every generated row
+	Start = std::chrono::steady_clock::now();
+	int32_t NumCorrect = 0;
+	for (int32_t Row = 0; Row < Spec.NumRows; Row++)
+	{
+		const int32_t* States = &Rows[(size_t)Row * (Spec.NumFeatures + 1)];
+		NumCorrect += Model.GetView().Eval(States, (size_t)Spec.NumFeatures) == States[Spec.NumFeatures] ? 1 : 0;
+	}
+	const double EvalSeconds = SecondsSince(Start);
+
+	// Table file
+	Start = std::chrono::steady_clock::now();
+	std::vector<uint8_t> TableBytes;
+	WriteTable(Table, TableBytes);
+	const double WriteSeconds = SecondsSince(Start);
+
+	Start = std::chrono::steady_clock::now();
+	FTable Loaded;
+	const bool bRead = ReadTable(TableBytes.data(), TableBytes.size(), Loaded);
+	const double ReadSeconds = SecondsSince(Start);
+
+	std::printf("Rows %d (%d unique), features %d, cardinality %d, actions %d\n",
+		Spec.NumRows, Table.GetNumRows(), Spec.NumFeatures, Spec.Cardinality, Spec.NumActions);
+	std::printf("AddRow      %10.3f ms\n", AddRowSeconds * 1000.0);
+	std::printf("Build       %10.3f ms  (%d nodes, %d leaves, depth %d, %zu bytes, %lld histogram rows)\n",
+		BuildSeconds * 1000.0, Stats.NumNodes, Stats.NumLeaves, Stats.MaxDepth, Model.GetBytes().size(), (long long)Stats.HistogramRows);
+	std::printf("LevelWise   %10.3f ms  (%lld histogram rows)\n", LevelWiseSeconds * 1000.0, (long long)LevelWiseStats.HistogramRows);
+	std::printf("Eval        %10.1f ns/row  (training accuracy %.1f%%)\n",
+		EvalSeconds * 1e9 / Spec.NumRows, 100.0 * NumCorrect / Spec.NumRows);
+	std::printf("WriteTable  %10.3f ms  (%zu bytes)\n", WriteSeconds * 1000.0, TableBytes.size());
+	std::printf("ReadTable   %10.3f ms\n", ReadSeconds * 1000.0);
+
+	return bRead && Loaded.Columns == Table.Columns ? 0 : 1;
+}
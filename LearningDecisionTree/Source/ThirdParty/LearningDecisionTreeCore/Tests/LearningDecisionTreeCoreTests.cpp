@@ -0,0 +1,505 @@
+#include "LearningDecisionTreeCore/Builder.h"
+#include "LearningDecisionTreeCore/Flat.h"
+#include "LearningDecisionTreeCore/TableFile.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace LearningDecisionTreeCore;
+
+namespace
+{
+	int32_t GNumFailures = 0;
+
+#define LDT_CHECK(Expr) \
+	do \
+	{ \
+		if (!(Expr)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #Expr); \
+			GNumFailures++; \
+		} \
+	} while (0)
+
+	/** The classic play-tennis table: Outlook, Temperature, Humidity, Wind, Play. */
+	FTable MakeTennisTable()
+	{
+		enum { Sunny, Overcast, Rain };
+		enum { Hot, Mild, Cool };
+		enum { High, Normal };
+		enum { Weak, Strong };
+		enum { No, Yes };
+		const int32_t Rows[14][5] = {
+			{ Sunny, Hot, High, Weak, No }, { Sunny, Hot, High, Strong, No }, { Overcast, Hot, High, Weak, Yes },
+			{ Rain, Mild, High, Weak, Yes }, { Rain, Cool, Normal, Weak, Yes }, { Rain, Cool, Normal, Strong, No },
+			{ Overcast, Cool, Normal, Strong, Yes }, { Sunny, Mild, High, Weak, No }, { Sunny, Cool, Normal, Weak, Yes },
+			{ Rain, Mild, Normal, Weak, Yes }, { Sunny, Mild, Normal, Strong, Yes }, { Overcast, Mild, High, Strong, Yes },
+			{ Overcast, Hot, Normal, Weak, Yes }, { Rain, Mild, High, Strong, No },
+		};
+
+		FTable Table;
+		for (const char* Name : { "Outlook", "Temperature", "Humidity", "Wind", "Play" })
+		{
+			Table.AddColumn(Name);
+		}
+		for (const auto& Row : Rows)
+		{
+			Table.AddRow(Row, 5);
+		}
+		return Table;
+	}
+
+	void TestTableMergesDuplicates()
+	{
+		FTable Table;
+		LDT_CHECK(Table.AddColumn("Feature"));
+		LDT_CHECK(Table.AddColumn("Action"));
+		LDT_CHECK(!Table.AddColumn("Action"));
+
+		LDT_CHECK(Table.AddRow({ 1, 0 }));
+		LDT_CHECK(Table.AddRow({ 2, 1 }));
+		LDT_CHECK(Table.AddRow({ 1, 0 }, 3));
+		LDT_CHECK(!Table.AddRow({ 1 }));
+
+		LDT_CHECK(Table.GetNumRows() == 2);
+		LDT_CHECK(Table.TotalRows == 5);
+		LDT_CHECK(Table.DuplicateCounts[0] == 4);
+		LDT_CHECK(!Table.AddColumn("Late"));
+	}
+
+	void TestLearnsTennis()
+	{
+		FTable Table = MakeTennisTable();
+		std::vector<uint8_t> Bytes;
+		FBuildStats Stats;
+		LDT_CHECK(BuildFlatTree(Table, Bytes, &Stats));
+
+		FFlatModel Model;
+		LDT_CHECK(Model.SetBytes(std::move(Bytes)));
+		const FFlatView& View = Model.GetView();
+
+		// Outlook at the root, then Humidity under Sunny and Wind under Rain
+		LDT_CHECK(View.GetHeader()->RootNode == 0);
+		LDT_CHECK(View.GetNode(0).FeatureIndex == 0);
+		LDT_CHECK(View.GetHeader()->NumNodes == 8);
+		LDT_CHECK(View.GetHeader()->NumFeatures == 4);
+		LDT_CHECK(Stats.NumNodes == 8 && Stats.NumLeaves == 5 && Stats.MaxDepth == 2);
+
+		// Branches in order of first appearance, children laid out depth-first
+		LDT_CHECK(View.GetNode(0).Num == 3);
+		LDT_CHECK(View.GetBranch(0).State == 0 && View.GetBranch(0).Child == 1);
+		LDT_CHECK(View.GetNode(1).FeatureIndex == 2);
+
+		for (int32_t Row = 0; Row < Table.GetNumRows(); Row++)
+		{
+			int32_t Features[4];
+			for (int32_t Column = 0; Column < 4; Column++)
+			{
+				Features[Column] = Table.Columns[Column][Row];
+			}
+			LDT_CHECK(View.Eval(Features, 4) == Table.Columns[4][Row]);
+		}
+
+		// Rows too short for the tested feature, or with unseen states, leave the tree
+		const int32_t Short[1] = { 0 };
+		LDT_CHECK(View.Eval(Short, 1) == -1);
+		const int32_t Unseen[4] = { 7, 0, 0, 0 };
+		LDT_CHECK(View.Eval(Unseen, 4) == -1);
+	}
+
+	void TestTieGoesToLaterColumn()
+	{
+		FTable Table;
+		Table.AddColumn("A");
+		Table.AddColumn("B");
+		Table.AddColumn("Action");
+		for (int32_t i = 0; i < 4; i++)
+		{
+			Table.AddRow({ i % 2, i % 2, i % 2 });
+		}
+
+		std::vector<uint8_t> Bytes;
+		FFlatModel Model;
+		LDT_CHECK(BuildFlatTree(Table, Bytes) && Model.SetBytes(std::move(Bytes)));
+		LDT_CHECK(Model.GetView().GetNode(0).FeatureIndex == 1);
+	}
+
+	void TestLevelWiseMatchesDepthFirst()
+	{
+		// Counting only gets cheaper below the root, by subtracting the largest child
+		auto CheckSameTree = [](const FTable& Table, bool bExpectLessCounting)
+		{
+			std::vector<uint8_t> DepthFirst, LevelWise;
+			FBuildStats DepthFirstStats, LevelWiseStats;
+			LDT_CHECK(BuildFlatTree(Table, DepthFirst, &DepthFirstStats, EBuildMode::DepthFirst));
+			LDT_CHECK(BuildFlatTree(Table, LevelWise, &LevelWiseStats, EBuildMode::LevelWise));
+			LDT_CHECK(DepthFirst == LevelWise);
+			LDT_CHECK(LevelWiseStats.NumNodes == DepthFirstStats.NumNodes && LevelWiseStats.MaxDepth == DepthFirstStats.MaxDepth);
+			LDT_CHECK(bExpectLessCounting ? LevelWiseStats.HistogramRows < DepthFirstStats.HistogramRows
+				: LevelWiseStats.HistogramRows <= DepthFirstStats.HistogramRows);
+		};
+
+		CheckSameTree(MakeTennisTable(), true);
+
+		FTable ActionOnly;
+		ActionOnly.AddColumn("Action");
+		ActionOnly.AddRow({ 3 });
+		CheckSameTree(ActionOnly, false);
+
+		// Noisy tables with mixed cardinalities, duplicates and a row that counts for nothing
+		uint32_t Random = 12345;
+		auto Next = [&Random](uint32_t Range)
+		{
+			Random = Random * 1664525u + 1013904223u;
+			return (int32_t)((Random >> 8) % Range);
+		};
+		for (int32_t Seed = 0; Seed < 20; Seed++)
+		{
+			const int32_t NumFeatures = 1 + Seed % 6;
+			FTable Table;
+			for (int32_t Feature = 0; Feature <= NumFeatures; Feature++)
+			{
+				Table.AddColumn("Column" + std::to_string(Feature));
+			}
+			std::vector<int32_t> Row(NumFeatures + 1);
+			for (int32_t i = 0; i < 300 + Seed * 50; i++)
+			{
+				for (int32_t Feature = 0; Feature < NumFeatures; Feature++)
+				{
+					Row[Feature] = Next(2 + (Feature + Seed) % 5) * 10 - 7;
+				}
+				Row[NumFeatures] = Next(10) < 7 ? (Row[0] + (NumFeatures > 1 ? Row[1] : 0)) % 4 : Next(4);
+				Table.AddRow(Row, 1 + Next(3));
+			}
+			Table.AddRow(Row, 0);
+			CheckSameTree(Table, NumFeatures > 1);
+		}
+	}
+
+	void TestEmptyTable()
+	{
+		FTable Table;
+		std::vector<uint8_t> Bytes;
+		LDT_CHECK(!BuildFlatTree(Table, Bytes));
+
+		Table.AddColumn("Action");
+		FFlatModel Model;
+		LDT_CHECK(BuildFlatTree(Table, Bytes) && Model.SetBytes(std::move(Bytes)));
+		LDT_CHECK(Model.GetView().GetHeader()->NumNodes == 1);
+		LDT_CHECK(Model.GetView().Eval(nullptr, 0) == -1);
+		LDT_CHECK(Model.GetView().SampleAction(0, 0) == -1);
+	}
+
+	void TestSampleAction()
+	{
+		FTable Table;
+		Table.AddColumn("Action");
+		Table.AddRow({ 5 }, 3);
+		Table.AddRow({ 9 }, 1);
+
+		std::vector<uint8_t> Bytes;
+		FFlatModel Model;
+		LDT_CHECK(BuildFlatTree(Table, Bytes) && Model.SetBytes(std::move(Bytes)));
+		const FFlatView& View = Model.GetView();
+		LDT_CHECK(View.MostLikelyAction(0) == 5);
+
+		int32_t NumFive = 0;
+		for (uint32_t Random = 0; Random < 400; Random++)
+		{
+			NumFive += View.SampleAction(0, Random) == 5 ? 1 : 0;
+		}
+		LDT_CHECK(NumFive == 300);
+	}
+
+	void TestFindLeafReportsDecisions()
+	{
+		std::vector<uint8_t> Bytes;
+		FFlatModel Model;
+		LDT_CHECK(BuildFlatTree(MakeTennisTable(), Bytes) && Model.SetBytes(std::move(Bytes)));
+		const FFlatView& View = Model.GetView();
+
+		// Sunny and high humidity: Outlook, then Humidity
+		const int32_t Row[] = { 0, 0, 0, 0 };
+		std::vector<int32_t> Features;
+		std::vector<uint32_t> Branches;
+		const int32_t Leaf = View.FindLeaf(Row, 4, [&](const FFlatNode& Node, uint32_t Branch)
+		{
+			Features.push_back(Node.FeatureIndex);
+			Branches.push_back(Branch);
+		});
+		LDT_CHECK(Leaf == View.FindLeaf(Row, 4) && View.MostLikelyAction(Leaf) == 0);
+		LDT_CHECK(Features == std::vector<int32_t>({ 0, 2 }));
+		for (size_t i = 0; i < Branches.size(); i++)
+		{
+			LDT_CHECK(Branches[i] < View.GetNumBranches() && View.GetNode(View.GetBranch(Branches[i]).Child).FeatureIndex == (i + 1 < Features.size() ? Features[i + 1] : FFlatNode::LeafFeature));
+		}
+
+		// A state never seen in training still reports the decision that tested it
+		const int32_t Unseen[] = { 7, 0, 0, 0 };
+		Features.clear();
+		Branches.clear();
+		LDT_CHECK(View.FindLeaf(Unseen, 4, [&](const FFlatNode& Node, uint32_t Branch)
+		{
+			Features.push_back(Node.FeatureIndex);
+			Branches.push_back(Branch);
+		}) == -1);
+		LDT_CHECK(Features == std::vector<int32_t>({ 0 }) && Branches == std::vector<uint32_t>({ FFlatView::NoBranch }));
+
+		// Rewriting the sections gives the same blob
+		std::vector<uint8_t> Rewritten;
+		const FFlatHeader& Header = *View.GetHeader();
+		WriteFlatTree(&View.GetNode(0), Header.NumNodes, &View.GetBranch(0), Header.NumBranches, &View.GetLeafEntry(0), Header.NumLeafEntries,
+			Header.NumFeatures, Header.RootNode, Rewritten);
+		LDT_CHECK(Rewritten == Model.GetBytes());
+	}
+
+	void TestRejectsCorruptBlobs()
+	{
+		std::vector<uint8_t> Bytes;
+		LDT_CHECK(BuildFlatTree(MakeTennisTable(), Bytes));
+
+		FFlatView View;
+		LDT_CHECK(View.Initialize(Bytes.data(), Bytes.size()));
+		LDT_CHECK(View.GetSize() == Bytes.size());
+		LDT_CHECK(!View.Initialize(Bytes.data(), Bytes.size() - 1));
+		LDT_CHECK(!View.Initialize(nullptr, 0));
+
+		std::vector<uint8_t> BadMagic = Bytes;
+		BadMagic[0] ^= 0xFF;
+		LDT_CHECK(!View.Initialize(BadMagic.data(), BadMagic.size()));
+
+		// Point the first branch back at the root: traversal must stop instead of looping
+		std::vector<uint8_t> Cycle = Bytes;
+		FFlatHeader Header;
+		std::memcpy(&Header, Cycle.data(), sizeof(Header));
+		const size_t FirstBranch = sizeof(FFlatHeader) + Header.NumNodes * sizeof(FFlatNode);
+		FFlatBranch Branch;
+		std::memcpy(&Branch, Cycle.data() + FirstBranch, sizeof(Branch));
+		Branch.Child = 0;
+		std::memcpy(Cycle.data() + FirstBranch, &Branch, sizeof(Branch));
+		LDT_CHECK(View.Initialize(Cycle.data(), Cycle.size()));
+		const int32_t Sunny[4] = { 0, 0, 0, 0 };
+		LDT_CHECK(View.FindLeaf(Sunny, 4) == -1);
+	}
+
+	void TestCrc32()
+	{
+		LDT_CHECK(MemCrc32("123456789", 9) == 0xCBF43926u);
+		LDT_CHECK(MemCrc32("56789", 5, MemCrc32("1234", 4)) == 0xCBF43926u);
+	}
+
+	/** Pins the table file layout byte for byte, so engine and core files stay interchangeable. */
+	void TestTableFileLayout()
+	{
+		FTable Table;
+		Table.AddColumn("A");
+		Table.AddColumn("Action");
+		Table.AddRow({ 1, 0 }, 2);
+		Table.AddRow({ 2, 1 });
+
+		std::vector<uint8_t> Bytes;
+		uint32_t Checksum = 0;
+		LDT_CHECK(WriteTable(Table, Bytes, ECompression::None, &Checksum));
+
+		const std::vector<uint8_t> Expected = {
+			0x4C, 0x44, 0x54, 0x42, 0x01, 0x00, 0x00, 0x00,
+			// Schema: TotalRows 3, 2 rows, 2 columns, "A", "Action"
+			0x00, 0x1D, 0x00, 0x00, 0x00, 0x1D, 0x00, 0x00, 0x00,
+			0x03, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+			0x02, 0x00, 0x00, 0x00, 'A', 0x00,
+			0x07, 0x00, 0x00, 0x00, 'A', 'c', 't', 'i', 'o', 'n', 0x00,
+			// DuplicateCounts
+			0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x01,
+			// A: dictionary {1, 2}, 1 bit per row, codes 0 1
+			0x00, 0x05, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x02, 0x02, 0x01, 0x01, 0x02,
+			// Action: dictionary {0, 1}, 1 bit per row, codes 0 1
+			0x00, 0x05, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x01, 0x02,
+		};
+		LDT_CHECK(Bytes.size() == Expected.size() + sizeof(uint32_t));
+		LDT_CHECK(Bytes.size() >= Expected.size() && std::memcmp(Bytes.data(), Expected.data(), Expected.size()) == 0);
+
+		uint32_t StoredChecksum = 0;
+		std::memcpy(&StoredChecksum, Bytes.data() + Bytes.size() - sizeof(uint32_t), sizeof(uint32_t));
+		LDT_CHECK(StoredChecksum == Checksum);
+	}
+
+	void TestTableFileRoundTrip(ECompression Compression)
+	{
+		FTable Table;
+		Table.AddColumn("Health");
+		Table.AddColumn(u8"Distânce");
+		Table.AddColumn("");
+		Table.AddColumn("Action");
+		for (int32_t i = 0; i < 500; i++)
+		{
+			Table.AddRow({ i % 7 - 3, 0, i % 3 == 0 ? -100000 : 250000, i % 4 });
+		}
+
+		std::vector<uint8_t> Bytes;
+		uint32_t WrittenChecksum = 0;
+		LDT_CHECK(WriteTable(Table, Bytes, Compression, &WrittenChecksum));
+
+		FTable Loaded;
+		uint32_t ReadChecksum = 0;
+		LDT_CHECK(ReadTable(Bytes.data(), Bytes.size(), Loaded, &ReadChecksum));
+		LDT_CHECK(ReadChecksum == WrittenChecksum);
+		LDT_CHECK(Loaded.ColumnNames == Table.ColumnNames);
+		LDT_CHECK(Loaded.Columns == Table.Columns);
+		LDT_CHECK(Loaded.DuplicateCounts == Table.DuplicateCounts);
+		LDT_CHECK(Loaded.TotalRows == Table.TotalRows);
+
+		// Rows added after loading still merge with the loaded ones
+		LDT_CHECK(Loaded.AddRow({ -3, 0, -100000, 0 }) && Loaded.GetNumRows() == Table.GetNumRows());
+
+		// A damaged byte either fails the read, leaving the table untouched, or does not change what is read
+		for (size_t i = 8; i + sizeof(uint32_t) < Bytes.size(); i += 7)
+		{
+			std::vector<uint8_t> Damaged = Bytes;
+			Damaged[i] ^= 0x5A;
+			FTable Read;
+			if (ReadTable(Damaged.data(), Damaged.size(), Read))
+			{
+				LDT_CHECK(Read.Columns == Table.Columns && Read.DuplicateCounts == Table.DuplicateCounts);
+			}
+			else
+			{
+				LDT_CHECK(Read.GetNumColumns() == 0);
+			}
+		}
+		LDT_CHECK(!ReadTable(Bytes.data(), Bytes.size() - 1, Loaded));
+	}
+
+	/** Run-length codec standing in for one the library does not have, like the engine's Oodle. */
+	class FRunLengthCodec final : public ICompressionCodec
+	{
+	public:
+		bool Compress(ECompression Compression, const uint8_t* In, size_t InSize, std::vector<uint8_t>& Out) const override
+		{
+			Out.clear();
+			for (size_t i = 0; Compression == ECompression::Oodle && i < InSize;)
+			{
+				size_t Run = 1;
+				while (i + Run < InSize && Run < 255 && In[i + Run] == In[i])
+				{
+					Run++;
+				}
+				Out.push_back((uint8_t)Run);
+				Out.push_back(In[i]);
+				i += Run;
+			}
+			return Compression == ECompression::Oodle;
+		}
+
+		bool Uncompress(ECompression Compression, const uint8_t* In, size_t InSize, uint8_t* Out, size_t OutSize) const override
+		{
+			size_t Written = 0;
+			for (size_t i = 0; Compression == ECompression::Oodle && i + 1 < InSize; i += 2)
+			{
+				if (OutSize - Written < In[i])
+				{
+					return false;
+				}
+				std::memset(Out + Written, In[i + 1], In[i]);
+				Written += In[i];
+			}
+			return Compression == ECompression::Oodle && Written == OutSize;
+		}
+	};
+
+	void TestTableFileCodec()
+	{
+		FTable Table;
+		Table.AddColumn("Feature");
+		Table.AddColumn("Action");
+		for (int32_t i = 0; i < 2000; i++)
+		{
+			Table.AddRow({ i, i < 1000 ? 0 : 1 });
+		}
+
+		const FRunLengthCodec Codec;
+		std::vector<uint8_t> Raw;
+		std::vector<uint8_t> Compressed;
+		uint32_t RawChecksum = 0;
+		uint32_t CompressedChecksum = 0;
+		LDT_CHECK(WriteTable(Table, Raw, ECompression::None, &RawChecksum, &Codec));
+		LDT_CHECK(WriteTable(Table, Compressed, ECompression::Oodle, &CompressedChecksum, &Codec));
+		LDT_CHECK(Compressed.size() < Raw.size());
+
+		// The checksum covers the uncompressed payloads, so it names the same snapshot either way
+		LDT_CHECK(CompressedChecksum == RawChecksum);
+
+		FTable Loaded;
+		LDT_CHECK(!ReadTable(Compressed.data(), Compressed.size(), Loaded));
+		LDT_CHECK(ReadTable(Compressed.data(), Compressed.size(), Loaded, nullptr, &Codec));
+		LDT_CHECK(Loaded.Columns == Table.Columns && Loaded.DuplicateCounts == Table.DuplicateCounts);
+	}
+
+	void TestReadsLegacyTable()
+	{
+		// TotalRows, column names, columns keyed by name (any order), DuplicateCounts
+		const std::vector<uint8_t> Legacy = {
+			0x03, 0x00, 0x00, 0x00,
+			0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 'A', 0x00, 0x02, 0x00, 0x00, 0x00, 'B', 0x00,
+			0x02, 0x00, 0x00, 0x00,
+			0x02, 0x00, 0x00, 0x00, 'B', 0x00, 0x02, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+			0x02, 0x00, 0x00, 0x00, 'A', 0x00, 0x02, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x05, 0x00, 0x00, 0x00,
+			0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+		};
+
+		FTable Table;
+		uint32_t Checksum = 1;
+		LDT_CHECK(ReadTable(Legacy.data(), Legacy.size(), Table, &Checksum));
+		LDT_CHECK(Checksum == 0);
+		LDT_CHECK(Table.TotalRows == 3);
+		LDT_CHECK(Table.ColumnNames == std::vector<std::string>({ "A", "B" }));
+		LDT_CHECK(Table.Columns[0] == std::vector<int32_t>({ -1, 5 }));
+		LDT_CHECK(Table.Columns[1] == std::vector<int32_t>({ 7, 8 }));
+		LDT_CHECK(Table.DuplicateCounts == std::vector<int32_t>({ 2, 1 }));
+	}
+
+	void TestFlatFileRoundTrip()
+	{
+		std::vector<uint8_t> Bytes;
+		LDT_CHECK(BuildFlatTree(MakeTennisTable(), Bytes));
+
+		FFlatModel Model;
+		LDT_CHECK(Model.SetBytes(std::vector<uint8_t>(Bytes)));
+		const std::string Path = "LearningDecisionTreeCoreTests.ftree";
+		LDT_CHECK(Model.SaveFile(Path));
+
+		FFlatModel Loaded;
+		LDT_CHECK(Loaded.LoadFile(Path));
+		LDT_CHECK(Loaded.GetBytes() == Bytes);
+		std::remove(Path.c_str());
+
+		FFlatModel Moved(std::move(Loaded));
+		LDT_CHECK(Moved.GetView().IsValid() && !Loaded.GetView().IsValid());
+		LDT_CHECK(!Loaded.LoadFile(Path));
+	}
+}
+
+int main()
+{
+	TestTableMergesDuplicates();
+	TestLearnsTennis();
+	TestTieGoesToLaterColumn();
+	TestLevelWiseMatchesDepthFirst();
+	TestEmptyTable();
+	TestSampleAction();
+	TestFindLeafReportsDecisions();
+	TestRejectsCorruptBlobs();
+	TestCrc32();
+	TestTableFileLayout();
+	TestTableFileRoundTrip(ECompression::None);
+	TestTableFileRoundTrip(ECompression::Zlib);
+	TestTableFileCodec();
+	TestReadsLegacyTable();
+	TestFlatFileRoundTrip();
+
+	if (GNumFailures > 0)
+	{
+		std::fprintf(stderr, "%d check(s) failed\n", GNumFailures);
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,58 @@
+#include "LearningDecisionTreeCore/Builder.h"
+#include "LearningDecisionTreeCore/Flat.h"
+#include "LearningDecisionTreeCore/TableFile.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace LearningDecisionTreeCore;
+
+/**
+ * Trains a model outside the engine: reads a table file (.dat, as saved by ULearningDecisionTree::SaveTable)
+ * and writes the flat tree (.ftree) that ULearningDecisionTree::LoadFlatDecisionTree opens.
+ * --level-wise builds with EBuildMode::LevelWise, which writes the same tree.
+ */
+int main(int Argc, char** Argv)
+{
+	EBuildMode Mode = EBuildMode::DepthFirst;
+	if (Argc == 4 && std::strcmp(Argv[1], "--level-wise") == 0)
+	{
+		Mode = EBuildMode::LevelWise;
+		Argv++;
+		Argc--;
+	}
+	if (Argc != 3)
+	{
+		std::fprintf(stderr, "Usage: %s [--level-wise] <Table.dat> <Model.ftree>\n", Argv[0]);
+		return 2;
+	}
+
+	FTable Table;
+	if (!LoadTableFile(Argv[1], Table))
+	{
+		std::fprintf(stderr, "Cannot read table %s\n", Argv[1]);
+		return 1;
+	}
+
+	const auto Start = std::chrono::steady_clock::now();
+	std::vector<uint8_t> Bytes;
+	FBuildStats Stats;
+	FFlatModel Model;
+	if (!BuildFlatTree(Table, Bytes, &Stats, Mode) || !Model.SetBytes(std::move(Bytes)))
+	{
+		std::fprintf(stderr, "Cannot train on %s: the table has no columns or is inconsistent\n", Argv[1]);
+		return 1;
+	}
+	const double BuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+	if (!Model.SaveFile(Argv[2]))
+	{
+		std::fprintf(stderr, "Cannot write %s\n", Argv[2]);
+		return 1;
+	}
+
+	std::printf("%s: %d rows (%d unique), %d columns -> %s: %d nodes, %d leaves, depth %d, %zu bytes in %.1f ms\n",
+		Argv[1], Table.TotalRows, Table.GetNumRows(), Table.GetNumColumns(), Argv[2],
+		Stats.NumNodes, Stats.NumLeaves, Stats.MaxDepth, Model.GetBytes().size(), BuildMs);
+	return 0;
+}